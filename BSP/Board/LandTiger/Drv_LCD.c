@@ -0,0 +1,689 @@
+/*******************************************************************************
+ *
+ * @file Drv_LCD.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief LCD Implementation for Actual Board (LandTiger, ILI9325 compatible
+ *		  240x320 LCD)
+ *
+ *		  Sending a whole frame costs ~77K bus words so drawing functions
+ *		  do not access LCD. Screen is split into 16x16 tiles and each tile
+ *		  is kept as one of :
+ *
+ *			Solid    : All pixels have same colour (only colour is kept)
+ *			Cached   : Pixels are in a Tile Cache slot in RAM
+ *			On Glass : Pixels are only in LCD GRAM (evicted from cache)
+ *
+ *		  Each tile tracks its dirty rectangle. Board_LcdFlush() sets a LCD
+ *		  window for each dirty region and streams its pixels in a single
+ *		  bulk transfer. Horizontally neighbour fully dirty tiles are sent
+ *		  in one window and solid regions are filled without any RAM copy.
+ *
+ *		  Full framebuffer (150 KB) does not fit into RAM so a cache miss on
+ *		  an On Glass tile reads tile back from GRAM.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+#include "BSPConfig.h"
+
+#if BOARD_ENABLE_LCD_INTERFACE
+
+/********************************* INCLUDES ***********************************/
+#include "Board.h"
+
+#include "Drv_LCDBus.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Number of Tile Cache slots.
+ *  Each slot is 512 bytes. Partially drawn tiles need a slot until they are
+ *  flushed, so cache should cover changed (non solid) tiles of a frame.
+ */
+#ifndef BOARD_LCD_TILE_CACHE_SIZE
+#define BOARD_LCD_TILE_CACHE_SIZE	(16)
+#endif /* BOARD_LCD_TILE_CACHE_SIZE */
+
+#if (BOARD_LCD_TILE_CACHE_SIZE < 1) || (BOARD_LCD_TILE_CACHE_SIZE > 250)
+#error "BOARD_LCD_TILE_CACHE_SIZE must be between 1 and 250"
+#endif
+
+/* Tile dimension (width and height) in pixels */
+#define LCD_TILE_SIZE				(16)
+
+#define LCD_TILE_COLUMNS			(BOARD_LCD_WIDTH / LCD_TILE_SIZE)
+#define LCD_TILE_ROWS				(BOARD_LCD_HEIGHT / LCD_TILE_SIZE)
+#define LCD_NUM_OF_TILES			(LCD_TILE_COLUMNS * LCD_TILE_ROWS)
+
+/* Tile states which are not a cache slot */
+#define LCD_TILE_SOLID				(0xFF)
+#define LCD_TILE_ON_GLASS			(0xFE)
+
+/* Owner tile of a free cache slot */
+#define LCD_SLOT_FREE				(LCD_NUM_OF_TILES)
+
+/* ILI9325 Registers */
+#define LCD_REG_START_OSCILLATION	(0x00)
+#define LCD_REG_DRIVER_OUTPUT		(0x01)
+#define LCD_REG_DRIVING_WAVE		(0x02)
+#define LCD_REG_ENTRY_MODE			(0x03)
+#define LCD_REG_RESIZE				(0x04)
+#define LCD_REG_DISPLAY_CONTROL_1	(0x07)
+#define LCD_REG_DISPLAY_CONTROL_2	(0x08)
+#define LCD_REG_DISPLAY_CONTROL_3	(0x09)
+#define LCD_REG_DISPLAY_CONTROL_4	(0x0A)
+#define LCD_REG_RGB_INTERFACE_1		(0x0C)
+#define LCD_REG_FRAME_MARKER		(0x0D)
+#define LCD_REG_RGB_INTERFACE_2		(0x0F)
+#define LCD_REG_POWER_CONTROL_1		(0x10)
+#define LCD_REG_POWER_CONTROL_2		(0x11)
+#define LCD_REG_POWER_CONTROL_3		(0x12)
+#define LCD_REG_POWER_CONTROL_4		(0x13)
+#define LCD_REG_GRAM_X				(0x20)
+#define LCD_REG_GRAM_Y				(0x21)
+#define LCD_REG_GRAM				(0x22)
+#define LCD_REG_POWER_CONTROL_7		(0x29)
+#define LCD_REG_FRAME_RATE			(0x2B)
+#define LCD_REG_WINDOW_X_START		(0x50)
+#define LCD_REG_WINDOW_X_END		(0x51)
+#define LCD_REG_WINDOW_Y_START		(0x52)
+#define LCD_REG_WINDOW_Y_END		(0x53)
+#define LCD_REG_GATE_SCAN_1			(0x60)
+#define LCD_REG_GATE_SCAN_2			(0x61)
+#define LCD_REG_GATE_SCAN_3			(0x6A)
+#define LCD_REG_PANEL_INTERFACE_1	(0x90)
+#define LCD_REG_PANEL_INTERFACE_2	(0x92)
+
+/* Pseudo register for delays in initialization sequence */
+#define LCD_INIT_DELAY_MS			(0xFFFF)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Register Setting of Initialization Sequence
+ */
+typedef struct
+{
+	uint16_t reg;
+	uint16_t value;
+} LcdRegisterSetting;
+
+/*
+ * LCD Window (inclusive screen coordinates)
+ */
+typedef struct
+{
+	uint16_t x0;
+	uint16_t y0;
+	uint16_t x1;
+	uint16_t y1;
+} LcdWindow;
+
+/*
+ * Screen Tile
+ */
+typedef struct
+{
+	/* Colour of tile if tile is solid */
+	Board_LcdColor color;
+	/* Cache slot of tile, LCD_TILE_SOLID or LCD_TILE_ON_GLASS */
+	uint8_t slot;
+	/* Tile has changes which are not sent to LCD */
+	uint8_t dirty;
+	/* Dirty Rectangle (inclusive tile coordinates) */
+	uint8_t dirtyX0;
+	uint8_t dirtyY0;
+	uint8_t dirtyX1;
+	uint8_t dirtyY1;
+} LcdTile;
+
+/*
+ * Tile Cache Slot
+ */
+typedef struct
+{
+	/* Pixels of tile in row major order */
+	Board_LcdColor pixels[LCD_TILE_SIZE * LCD_TILE_SIZE];
+	/* Cached tile or LCD_SLOT_FREE */
+	uint32_t tileNo;
+	/* Last use time for LRU replacement */
+	uint32_t lastUse;
+} LcdTileSlot;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+PRIVATE void FlushRun(uint32_t tileRow, uint32_t firstColumn, uint32_t numOfTiles);
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Initialization Sequence of LCD Controller
+ *  16 bit bus, BGR, GRAM address increments horizontally then vertically.
+ */
+PRIVATE const LcdRegisterSetting lcdInitSequence[] =
+{
+	{ LCD_REG_START_OSCILLATION,	0x0001 },
+	{ LCD_INIT_DELAY_MS,			50 },
+	{ LCD_REG_DRIVER_OUTPUT,		0x0100 },
+	{ LCD_REG_DRIVING_WAVE,			0x0700 },
+	{ LCD_REG_ENTRY_MODE,			0x1030 },
+	{ LCD_REG_RESIZE,				0x0000 },
+	{ LCD_REG_DISPLAY_CONTROL_2,	0x0207 },
+	{ LCD_REG_DISPLAY_CONTROL_3,	0x0000 },
+	{ LCD_REG_DISPLAY_CONTROL_4,	0x0000 },
+	{ LCD_REG_RGB_INTERFACE_1,		0x0000 },
+	{ LCD_REG_FRAME_MARKER,			0x0000 },
+	{ LCD_REG_RGB_INTERFACE_2,		0x0000 },
+	/* Power On Sequence */
+	{ LCD_REG_POWER_CONTROL_1,		0x0000 },
+	{ LCD_REG_POWER_CONTROL_2,		0x0007 },
+	{ LCD_REG_POWER_CONTROL_3,		0x0000 },
+	{ LCD_REG_POWER_CONTROL_4,		0x0000 },
+	{ LCD_INIT_DELAY_MS,			200 },
+	{ LCD_REG_POWER_CONTROL_1,		0x1690 },
+	{ LCD_REG_POWER_CONTROL_2,		0x0227 },
+	{ LCD_INIT_DELAY_MS,			50 },
+	{ LCD_REG_POWER_CONTROL_3,		0x009D },
+	{ LCD_INIT_DELAY_MS,			50 },
+	{ LCD_REG_POWER_CONTROL_4,		0x1900 },
+	{ LCD_REG_POWER_CONTROL_7,		0x0025 },
+	{ LCD_REG_FRAME_RATE,			0x000D },
+	{ LCD_INIT_DELAY_MS,			50 },
+	/* Full Screen Window */
+	{ LCD_REG_GRAM_X,				0x0000 },
+	{ LCD_REG_GRAM_Y,				0x0000 },
+	{ LCD_REG_WINDOW_X_START,		0x0000 },
+	{ LCD_REG_WINDOW_X_END,			BOARD_LCD_WIDTH - 1 },
+	{ LCD_REG_WINDOW_Y_START,		0x0000 },
+	{ LCD_REG_WINDOW_Y_END,			BOARD_LCD_HEIGHT - 1 },
+	/* 320 Gate Lines */
+	{ LCD_REG_GATE_SCAN_1,			0xA700 },
+	{ LCD_REG_GATE_SCAN_2,			0x0001 },
+	{ LCD_REG_GATE_SCAN_3,			0x0000 },
+	{ LCD_REG_PANEL_INTERFACE_1,	0x0010 },
+	{ LCD_REG_PANEL_INTERFACE_2,	0x0600 },
+	/* Display On */
+	{ LCD_REG_DISPLAY_CONTROL_1,	0x0133 },
+};
+
+/* Screen Tiles */
+PRIVATE LcdTile tiles[LCD_NUM_OF_TILES];
+
+/* Tile Cache */
+PRIVATE LcdTileSlot tileCache[BOARD_LCD_TILE_CACHE_SIZE];
+
+/* Use counter for LRU replacement */
+PRIVATE uint32_t tileUseCounter;
+
+/* Window which is currently set on LCD Controller */
+PRIVATE LcdWindow lcdWindow;
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+PRIVATE void WriteRegister(uint16_t reg, uint16_t value)
+{
+	LCDBus_WriteIndex(reg);
+	LCDBus_WriteData(&value, 1);
+}
+
+/*
+ * Sets LCD window and selects GRAM to transfer pixels of window.
+ *  Only changed window registers are written.
+ */
+PRIVATE void SetWindow(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+	if (lcdWindow.x0 != x0)
+	{
+		WriteRegister(LCD_REG_WINDOW_X_START, (uint16_t)x0);
+		lcdWindow.x0 = (uint16_t)x0;
+	}
+
+	if (lcdWindow.x1 != x1)
+	{
+		WriteRegister(LCD_REG_WINDOW_X_END, (uint16_t)x1);
+		lcdWindow.x1 = (uint16_t)x1;
+	}
+
+	if (lcdWindow.y0 != y0)
+	{
+		WriteRegister(LCD_REG_WINDOW_Y_START, (uint16_t)y0);
+		lcdWindow.y0 = (uint16_t)y0;
+	}
+
+	if (lcdWindow.y1 != y1)
+	{
+		WriteRegister(LCD_REG_WINDOW_Y_END, (uint16_t)y1);
+		lcdWindow.y1 = (uint16_t)y1;
+	}
+
+	/* GRAM address is moved by previous transfer so always set it */
+	WriteRegister(LCD_REG_GRAM_X, (uint16_t)x0);
+	WriteRegister(LCD_REG_GRAM_Y, (uint16_t)y0);
+
+	LCDBus_WriteIndex(LCD_REG_GRAM);
+}
+
+/*
+ * Marks a region of a tile as dirty.
+ */
+PRIVATE void MarkDirty(LcdTile* tile, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+	if (tile->dirty)
+	{
+		tile->dirtyX0 = (uint8_t)MATH_MIN(tile->dirtyX0, x0);
+		tile->dirtyY0 = (uint8_t)MATH_MIN(tile->dirtyY0, y0);
+		tile->dirtyX1 = (uint8_t)MATH_MAX(tile->dirtyX1, x1);
+		tile->dirtyY1 = (uint8_t)MATH_MAX(tile->dirtyY1, y1);
+	}
+	else
+	{
+		tile->dirtyX0 = (uint8_t)x0;
+		tile->dirtyY0 = (uint8_t)y0;
+		tile->dirtyX1 = (uint8_t)x1;
+		tile->dirtyY1 = (uint8_t)y1;
+		tile->dirty = true;
+	}
+}
+
+PRIVATE bool IsFullyDirty(LcdTile* tile)
+{
+	return (tile->dirty &&
+			(tile->dirtyX0 == 0) && (tile->dirtyX1 == LCD_TILE_SIZE - 1) &&
+			(tile->dirtyY0 == 0) && (tile->dirtyY1 == LCD_TILE_SIZE - 1));
+}
+
+PRIVATE bool IsCached(LcdTile* tile)
+{
+	return (tile->slot < BOARD_LCD_TILE_CACHE_SIZE);
+}
+
+/*
+ * Releases cache slot of a tile (if tile is cached).
+ */
+PRIVATE void ReleaseSlot(LcdTile* tile)
+{
+	if (IsCached(tile))
+	{
+		tileCache[tile->slot].tileNo = LCD_SLOT_FREE;
+	}
+}
+
+/*
+ * Reads pixels of a tile from GRAM.
+ */
+PRIVATE void ReadTile(uint32_t tileNo, Board_LcdColor* pixels)
+{
+	uint32_t x0 = (tileNo % LCD_TILE_COLUMNS) * LCD_TILE_SIZE;
+	uint32_t y0 = (tileNo / LCD_TILE_COLUMNS) * LCD_TILE_SIZE;
+	uint16_t dummy;
+
+	SetWindow(x0, y0, x0 + LCD_TILE_SIZE - 1, y0 + LCD_TILE_SIZE - 1);
+
+	/* First read after GRAM address set is a dummy read */
+	LCDBus_ReadData(&dummy, 1);
+	LCDBus_ReadData(pixels, LCD_TILE_SIZE * LCD_TILE_SIZE);
+}
+
+/*
+ * Finds a slot for a tile.
+ *  A free slot is used if there is, otherwise Least Recently Used tile is
+ *  evicted (flushed first if it is dirty).
+ */
+PRIVATE uint32_t AllocateSlot(void)
+{
+	uint32_t slotNo;
+	uint32_t lruSlotNo = 0;
+	uint32_t victimTileNo;
+	LcdTile* victim;
+
+	for (slotNo = 0; slotNo < BOARD_LCD_TILE_CACHE_SIZE; slotNo++)
+	{
+		if (tileCache[slotNo].tileNo == LCD_SLOT_FREE)
+		{
+			return slotNo;
+		}
+
+		if ((tileUseCounter - tileCache[slotNo].lastUse) >
+			(tileUseCounter - tileCache[lruSlotNo].lastUse))
+		{
+			lruSlotNo = slotNo;
+		}
+	}
+
+	victimTileNo = tileCache[lruSlotNo].tileNo;
+	victim = &tiles[victimTileNo];
+
+	if (victim->dirty)
+	{
+		FlushRun(victimTileNo / LCD_TILE_COLUMNS, victimTileNo % LCD_TILE_COLUMNS, 1);
+	}
+
+	victim->slot = LCD_TILE_ON_GLASS;
+	tileCache[lruSlotNo].tileNo = LCD_SLOT_FREE;
+
+	return lruSlotNo;
+}
+
+/*
+ * Gets cached pixels of a tile to draw.
+ *
+ * @param tileNo Tile to draw
+ * @param load   true if current pixels of tile are needed (partial drawing)
+ *
+ * @return Pixels of tile
+ */
+PRIVATE Board_LcdColor* AcquireTile(uint32_t tileNo, bool load)
+{
+	LcdTile* tile = &tiles[tileNo];
+	LcdTileSlot* slot;
+	uint32_t i;
+
+	if (!IsCached(tile))
+	{
+		slot = &tileCache[AllocateSlot()];
+
+		if (load)
+		{
+			if (tile->slot == LCD_TILE_SOLID)
+			{
+				for (i = 0; i < LCD_TILE_SIZE * LCD_TILE_SIZE; i++)
+				{
+					slot->pixels[i] = tile->color;
+				}
+			}
+			else
+			{
+				ReadTile(tileNo, slot->pixels);
+			}
+		}
+
+		slot->tileNo = tileNo;
+		tile->slot = (uint8_t)(slot - tileCache);
+	}
+
+	slot = &tileCache[tile->slot];
+	slot->lastUse = ++tileUseCounter;
+
+	return slot->pixels;
+}
+
+/*
+ * Sends dirty region of a run of tiles in a tile row to LCD.
+ *  A run is a single tile or neighbour fully dirty tiles.
+ */
+PRIVATE void FlushRun(uint32_t tileRow, uint32_t firstColumn, uint32_t numOfTiles)
+{
+	LcdTile* run = &tiles[tileRow * LCD_TILE_COLUMNS + firstColumn];
+	uint32_t tileX0 = run->dirtyX0;
+	uint32_t tileX1 = run->dirtyX1;
+	uint32_t tileWidth = tileX1 - tileX0 + 1;
+	uint32_t y;
+	uint32_t i;
+	bool isSolid = true;
+
+	for (i = 0; i < numOfTiles; i++)
+	{
+		if ((run[i].slot != LCD_TILE_SOLID) || (run[i].color != run->color))
+		{
+			isSolid = false;
+		}
+	}
+
+	SetWindow(firstColumn * LCD_TILE_SIZE + tileX0,
+			  tileRow * LCD_TILE_SIZE + run->dirtyY0,
+			  (firstColumn + numOfTiles - 1) * LCD_TILE_SIZE + tileX1,
+			  tileRow * LCD_TILE_SIZE + run->dirtyY1);
+
+	if (isSolid)
+	{
+		LCDBus_FillData(run->color,
+						tileWidth * numOfTiles * (uint32_t)(run->dirtyY1 - run->dirtyY0 + 1));
+	}
+	else
+	{
+		/* GRAM address wraps to next line at end of window */
+		for (y = run->dirtyY0; y <= run->dirtyY1; y++)
+		{
+			for (i = 0; i < numOfTiles; i++)
+			{
+				if (run[i].slot == LCD_TILE_SOLID)
+				{
+					LCDBus_FillData(run[i].color, tileWidth);
+				}
+				else
+				{
+					LCDBus_WriteData(&tileCache[run[i].slot].pixels[y * LCD_TILE_SIZE + tileX0],
+									 tileWidth);
+				}
+			}
+		}
+	}
+
+	for (i = 0; i < numOfTiles; i++)
+	{
+		run[i].dirty = false;
+	}
+}
+
+/*
+ * Clips a rectangle to screen.
+ *
+ * @return false if rectangle is out of screen
+ */
+PRIVATE bool ClipRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+					  uint32_t* x1, uint32_t* y1)
+{
+	if ((width == 0) || (height == 0) ||
+		(x >= BOARD_LCD_WIDTH) || (y >= BOARD_LCD_HEIGHT))
+	{
+		return false;
+	}
+
+	*x1 = MATH_MIN(x + width, BOARD_LCD_WIDTH) - 1;
+	*y1 = MATH_MIN(y + height, BOARD_LCD_HEIGHT) - 1;
+
+	return true;
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+
+void Board_LcdInit(void)
+{
+	uint32_t i;
+
+	LCDBus_Init();
+
+	for (i = 0; i < sizeof(lcdInitSequence) / sizeof(lcdInitSequence[0]); i++)
+	{
+		if (lcdInitSequence[i].reg == LCD_INIT_DELAY_MS)
+		{
+			LCDBus_DelayMs(lcdInitSequence[i].value);
+		}
+		else
+		{
+			WriteRegister(lcdInitSequence[i].reg, lcdInitSequence[i].value);
+		}
+	}
+
+	lcdWindow.x0 = 0;
+	lcdWindow.y0 = 0;
+	lcdWindow.x1 = BOARD_LCD_WIDTH - 1;
+	lcdWindow.y1 = BOARD_LCD_HEIGHT - 1;
+
+	for (i = 0; i < BOARD_LCD_TILE_CACHE_SIZE; i++)
+	{
+		tileCache[i].tileNo = LCD_SLOT_FREE;
+	}
+
+	/* GRAM content is unknown after reset so clear all tiles */
+	for (i = 0; i < LCD_NUM_OF_TILES; i++)
+	{
+		tiles[i].slot = LCD_TILE_SOLID;
+		tiles[i].color = BOARD_LCD_COLOR_BLACK;
+		tiles[i].dirty = false;
+		MarkDirty(&tiles[i], 0, 0, LCD_TILE_SIZE - 1, LCD_TILE_SIZE - 1);
+	}
+
+	Board_LcdFlush();
+}
+
+void Board_LcdSetPixel(uint32_t x, uint32_t y, Board_LcdColor color)
+{
+	Board_LcdFillRect(x, y, 1, 1, color);
+}
+
+void Board_LcdFillRect(uint32_t x, uint32_t y,
+					   uint32_t width, uint32_t height,
+					   Board_LcdColor color)
+{
+	uint32_t x1;
+	uint32_t y1;
+	uint32_t row;
+	uint32_t column;
+
+	if (!ClipRect(x, y, width, height, &x1, &y1))
+	{
+		return;
+	}
+
+	for (row = y / LCD_TILE_SIZE; row <= y1 / LCD_TILE_SIZE; row++)
+	{
+		for (column = x / LCD_TILE_SIZE; column <= x1 / LCD_TILE_SIZE; column++)
+		{
+			uint32_t tileNo = row * LCD_TILE_COLUMNS + column;
+			LcdTile* tile = &tiles[tileNo];
+			uint32_t tx0 = MATH_MAX(x, column * LCD_TILE_SIZE) - column * LCD_TILE_SIZE;
+			uint32_t ty0 = MATH_MAX(y, row * LCD_TILE_SIZE) - row * LCD_TILE_SIZE;
+			uint32_t tx1 = MATH_MIN(x1, column * LCD_TILE_SIZE + LCD_TILE_SIZE - 1) - column * LCD_TILE_SIZE;
+			uint32_t ty1 = MATH_MIN(y1, row * LCD_TILE_SIZE + LCD_TILE_SIZE - 1) - row * LCD_TILE_SIZE;
+			Board_LcdColor* pixels;
+			uint32_t px;
+			uint32_t py;
+
+			if ((tile->slot == LCD_TILE_SOLID) && (tile->color == color))
+			{
+				/* Nothing changes */
+				continue;
+			}
+
+			if ((tx0 == 0) && (ty0 == 0) &&
+				(tx1 == LCD_TILE_SIZE - 1) && (ty1 == LCD_TILE_SIZE - 1))
+			{
+				/* Whole tile has a single colour now, it does not need a slot */
+				ReleaseSlot(tile);
+				tile->slot = LCD_TILE_SOLID;
+				tile->color = color;
+			}
+			else
+			{
+				pixels = AcquireTile(tileNo, true);
+
+				for (py = ty0; py <= ty1; py++)
+				{
+					for (px = tx0; px <= tx1; px++)
+					{
+						pixels[py * LCD_TILE_SIZE + px] = color;
+					}
+				}
+			}
+
+			MarkDirty(tile, tx0, ty0, tx1, ty1);
+		}
+	}
+}
+
+void Board_LcdDrawBitmap(uint32_t x, uint32_t y,
+						 uint32_t width, uint32_t height,
+						 const Board_LcdColor* pixels)
+{
+	uint32_t x1;
+	uint32_t y1;
+	uint32_t row;
+	uint32_t column;
+
+	if ((pixels == NULL) || !ClipRect(x, y, width, height, &x1, &y1))
+	{
+		return;
+	}
+
+	for (row = y / LCD_TILE_SIZE; row <= y1 / LCD_TILE_SIZE; row++)
+	{
+		for (column = x / LCD_TILE_SIZE; column <= x1 / LCD_TILE_SIZE; column++)
+		{
+			uint32_t tileNo = row * LCD_TILE_COLUMNS + column;
+			uint32_t tx0 = MATH_MAX(x, column * LCD_TILE_SIZE) - column * LCD_TILE_SIZE;
+			uint32_t ty0 = MATH_MAX(y, row * LCD_TILE_SIZE) - row * LCD_TILE_SIZE;
+			uint32_t tx1 = MATH_MIN(x1, column * LCD_TILE_SIZE + LCD_TILE_SIZE - 1) - column * LCD_TILE_SIZE;
+			uint32_t ty1 = MATH_MIN(y1, row * LCD_TILE_SIZE + LCD_TILE_SIZE - 1) - row * LCD_TILE_SIZE;
+			bool isFullTile = (tx0 == 0) && (ty0 == 0) &&
+							  (tx1 == LCD_TILE_SIZE - 1) && (ty1 == LCD_TILE_SIZE - 1);
+			Board_LcdColor* tilePixels = AcquireTile(tileNo, !isFullTile);
+			uint32_t px;
+			uint32_t py;
+
+			for (py = ty0; py <= ty1; py++)
+			{
+				/* Bitmap coordinates of first pixel in tile row */
+				const Board_LcdColor* source =
+						&pixels[(row * LCD_TILE_SIZE + py - y) * width +
+								(column * LCD_TILE_SIZE + tx0 - x)];
+
+				for (px = tx0; px <= tx1; px++)
+				{
+					tilePixels[py * LCD_TILE_SIZE + px] = *source++;
+				}
+			}
+
+			MarkDirty(&tiles[tileNo], tx0, ty0, tx1, ty1);
+		}
+	}
+}
+
+void Board_LcdFlush(void)
+{
+	uint32_t row;
+	uint32_t column;
+	uint32_t numOfTiles;
+	LcdTile* rowTiles;
+
+	for (row = 0; row < LCD_TILE_ROWS; row++)
+	{
+		rowTiles = &tiles[row * LCD_TILE_COLUMNS];
+
+		for (column = 0; column < LCD_TILE_COLUMNS; column += numOfTiles)
+		{
+			numOfTiles = 1;
+
+			if (!rowTiles[column].dirty)
+			{
+				continue;
+			}
+
+			if (IsFullyDirty(&rowTiles[column]))
+			{
+				/* Neighbour fully dirty tiles share one window */
+				while ((column + numOfTiles < LCD_TILE_COLUMNS) &&
+					   IsFullyDirty(&rowTiles[column + numOfTiles]))
+				{
+					numOfTiles++;
+				}
+			}
+
+			FlushRun(row, column, numOfTiles);
+		}
+	}
+}
+
+#endif /* BOARD_ENABLE_LCD_INTERFACE */
@@ -0,0 +1,234 @@
+/*******************************************************************************
+ *
+ * @file Drv_LCDBus.cpp
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief LCD Bus Implementation for Actual Board (LandTiger)
+ *
+ *		  LCD Controller has a 16 bit bus but only P2.0 ... P2.7 are wired.
+ *		  Low byte is latched (74HC573) and high byte passes through a buffer
+ *		  (74HC245) so a word is sent in two byte writes:
+ *
+ *			P0.19 : EN  (Buffer Enable, Active Low)
+ *			P0.20 : LE  (Latch Enable for D0 ... D7)
+ *			P0.21 : DIR (Buffer Direction, 1 : MCU -> LCD)
+ *			P0.22 : CS  (Chip Select, Active Low)
+ *			P0.23 : RS  (0 : Index, 1 : Data)
+ *			P0.24 : WR  (Write Strobe, Active Low)
+ *			P0.25 : RD  (Read Strobe, Active Low)
+ *
+ *		  Pins are bound at compile time using C++ GPIO layer so each pin
+ *		  access in word loops is a single store to a constant address.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+#include "BSPConfig.h"
+
+#if BOARD_ENABLE_LCD_INTERFACE
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_LCDBus.h"
+
+#include "Drv_GPIO.hpp"
+
+#include "LPC17xx.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Data Bus is on P2.0 ... P2.7 */
+#define LCD_DATA_PORT				2
+#define LCD_DATA_PIN_MASK			(0xFFu)
+
+/* Control pins are on P0.19 ... P0.25 */
+#define LCD_CTRL_PORT				0
+#define LCD_CTRL_PIN_MASK			(0x7Fu << 19)
+
+/* Approximate CPU cycles of one busy wait loop iteration */
+#define LCD_DELAY_CYCLES_PER_LOOP	(4)
+
+/* Data access time of LCD Controller for reads */
+#define LCD_READ_SETTLE()			do { __NOP(); __NOP(); __NOP(); __NOP(); } while (0)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+typedef Drv::GPIOPort<LCD_DATA_PORT> LcdDataPort;
+typedef Drv::GPIOPins<LCD_DATA_PORT, LCD_DATA_PIN_MASK> LcdData;
+typedef Drv::GPIOPins<LCD_CTRL_PORT, LCD_CTRL_PIN_MASK> LcdControl;
+
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 19> LcdEN;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 20> LcdLE;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 21> LcdDIR;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 22> LcdCS;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 23> LcdRS;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 24> LcdWR;
+typedef Drv::GPIOPin<LCD_CTRL_PORT, 25> LcdRD;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Starts a write transfer.
+ *  Data pins are unmasked for whole transfer so each byte is a single store
+ *  to FIOPIN and other pins of port are not affected.
+ */
+PRIVATE ALWAYS_INLINE void BeginWrite(bool isIndex)
+{
+	LcdData::SetOutput();
+	LcdDIR::High();
+	LcdEN::Low();
+
+	if (isIndex)
+	{
+		LcdRS::Low();
+	}
+	else
+	{
+		LcdRS::High();
+	}
+
+	LcdCS::Low();
+
+	LcdDataPort::Registers()->FIOMASK = ~LCD_DATA_PIN_MASK;
+}
+
+/*
+ * Ends a write or read transfer.
+ */
+PRIVATE ALWAYS_INLINE void EndTransfer(void)
+{
+	LcdDataPort::Registers()->FIOMASK = 0;
+
+	LcdCS::High();
+}
+
+/*
+ * Sends a word in a started write transfer.
+ */
+PRIVATE ALWAYS_INLINE void SendWord(uint16_t word)
+{
+	/* Latch D0 ... D7 */
+	LcdDataPort::Registers()->FIOPIN = word;
+	LcdLE::High();
+	LcdLE::Low();
+
+	/* D8 ... D15 are passed by buffer */
+	LcdDataPort::Registers()->FIOPIN = (uint32_t)word >> 8;
+
+	LcdWR::Low();
+	LcdWR::High();
+}
+
+/*
+ * Receives a word in a started read transfer.
+ */
+PRIVATE ALWAYS_INLINE uint16_t ReceiveWord(void)
+{
+	uint16_t word;
+
+	LcdRD::Low();
+
+	/* D8 ... D15 */
+	LcdEN::Low();
+	LCD_READ_SETTLE();
+	word = (uint16_t)(LcdData::Read() << 8);
+
+	/* D0 ... D7 */
+	LcdEN::High();
+	LCD_READ_SETTLE();
+	word |= (uint16_t)LcdData::Read();
+
+	LcdRD::High();
+
+	return word;
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+
+void LCDBus_Init(void)
+{
+	LcdControl::Configure(0, 0);
+	LcdData::Configure(0, 0);
+
+	/* Bus is idle : buffer disabled, chip not selected, no strobe */
+	LcdControl::Set();
+	LcdLE::Low();
+	LcdControl::SetOutput();
+
+	LcdData::SetOutput();
+}
+
+void LCDBus_WriteIndex(uint16_t index)
+{
+	BeginWrite(true);
+	SendWord(index);
+	EndTransfer();
+}
+
+void LCDBus_WriteData(const uint16_t* data, uint32_t count)
+{
+	BeginWrite(false);
+
+	while (count--)
+	{
+		SendWord(*data++);
+	}
+
+	EndTransfer();
+}
+
+void LCDBus_FillData(uint16_t data, uint32_t count)
+{
+	BeginWrite(false);
+
+	while (count--)
+	{
+		SendWord(data);
+	}
+
+	EndTransfer();
+}
+
+void LCDBus_ReadData(uint16_t* data, uint32_t count)
+{
+	LcdData::SetInput();
+	LcdDIR::Low();
+	LcdRS::High();
+	LcdCS::Low();
+
+	while (count--)
+	{
+		*data++ = ReceiveWord();
+	}
+
+	EndTransfer();
+
+	/* Bus direction is MCU -> LCD while idle */
+	LcdEN::High();
+	LcdDIR::High();
+	LcdData::SetOutput();
+}
+
+void LCDBus_DelayMs(uint32_t delayInMs)
+{
+	volatile uint32_t loops = (SystemCoreClock / 1000 / LCD_DELAY_CYCLES_PER_LOOP) * delayInMs;
+
+	while (loops--);
+}
+
+#endif /* BOARD_ENABLE_LCD_INTERFACE */
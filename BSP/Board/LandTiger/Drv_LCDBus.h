@@ -0,0 +1,75 @@
+/*******************************************************************************
+ *
+ * @file Drv_LCDBus.h
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief LCD Bus Interface for LandTiger LCD (ILI9325 compatible, 16 bit
+ *		  8080 bus over P2.0 ... P2.7 and a latch)
+ *
+ *		  Bus transfers are bulk: After an index (register) write, a data
+ *		  call transfers all words while control lines (CS, RS) are kept
+ *		  asserted so each word costs only data and strobe pin accesses.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __DRV_LCD_BUS_H
+#define __DRV_LCD_BUS_H
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Initializes LCD Bus pins.
+ */
+void LCDBus_Init(void);
+
+/*
+ * Writes Index Register of LCD Controller (selects register to access).
+ */
+void LCDBus_WriteIndex(uint16_t index);
+
+/*
+ * Writes words to selected register.
+ *  GRAM address is incremented by LCD Controller after each word.
+ */
+void LCDBus_WriteData(const uint16_t* data, uint32_t count);
+
+/*
+ * Writes same word count times to selected register.
+ */
+void LCDBus_FillData(uint16_t data, uint32_t count);
+
+/*
+ * Reads words from selected register.
+ */
+void LCDBus_ReadData(uint16_t* data, uint32_t count);
+
+/*
+ * Busy waits for LCD Controller power sequences.
+ */
+void LCDBus_DelayMs(uint32_t delayInMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* __DRV_LCD_BUS_H */
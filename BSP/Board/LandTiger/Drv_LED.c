@@ -30,6 +30,14 @@
 /***************************** MACRO DEFINITIONS ******************************/
 #define BOARD_LED_COUNT			8
 
+/* LEDs are on P2.0 ... P2.7 */
+#define BOARD_LED_PORT			2
+#define BOARD_LED_PIN_MASK		(0xFFu)
+
+/* LCD Control pins are on P0.19 ... P0.25 */
+#define BOARD_LCD_CTRL_PORT		0
+#define BOARD_LCD_CTRL_PIN_MASK	(0x7Fu << 19)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /**************************** FUNCTION PROTOTYPES *****************************/
@@ -41,38 +49,33 @@
 /***************************** PUBLIC FUNCTIONS *******************************/
 void Board_LedInit(void)
 {
-	int pin;
     /*
-     * Configure LCD Pins
+     * Configure LED Pins
      * P2.0 ... P2.7
-     * 
-     */    
-	for (pin = 0; pin < BOARD_LED_COUNT; pin++)
-	{
-		Drv_GPIO_ConfigurePin(2, pin, 0, 0);
-	}
-
-	/* LCD cannot be work with LCD at same time.So disable LCD Control pins */   
+     *
+     */
+	Drv_GPIO_ConfigurePort(BOARD_LED_PORT, BOARD_LED_PIN_MASK, 0, 0);
+	Drv_GPIO_SetPortDirection(BOARD_LED_PORT, BOARD_LED_PIN_MASK, DRV_GPIO_DIRECTION_OUTPUT);
+
+	/* LCD cannot be work with LCD at same time.So disable LCD Control pins */
     /* P0.19 ... P0.25 */
-    for (pin = 19; pin <= 25; pin++)
-    {
-        Drv_GPIO_ConfigurePin(0, pin, 0, 0);
-        Drv_GPIO_WritePin(0, pin, DRV_GPIO_PINSTATE_HIGH);
-    }
+	Drv_GPIO_ConfigurePort(BOARD_LCD_CTRL_PORT, BOARD_LCD_CTRL_PIN_MASK, 0, 0);
+	Drv_GPIO_SetPort(BOARD_LCD_CTRL_PORT, BOARD_LCD_CTRL_PIN_MASK);
+	Drv_GPIO_SetPortDirection(BOARD_LCD_CTRL_PORT, BOARD_LCD_CTRL_PIN_MASK, DRV_GPIO_DIRECTION_OUTPUT);
 }
 
 void Board_LedOn(uint32_t ledNo)
 {
     if (ledNo >= BOARD_LED_COUNT) return;
     
-    Drv_GPIO_WritePin(2, ledNo, DRV_GPIO_PINSTATE_HIGH);
+    Drv_GPIO_SetPort(BOARD_LED_PORT, ((uint32_t)1) << ledNo);
 }
 
 void Board_LedOff(uint32_t ledNo)
 {
     if (ledNo >= BOARD_LED_COUNT) return;
     
-    Drv_GPIO_WritePin(2, ledNo, DRV_GPIO_PINSTATE_LOW);
+    Drv_GPIO_ClearPort(BOARD_LED_PORT, ((uint32_t)1) << ledNo);
 }
 
 #endif /* BOARD_ENABLE_LED_INTERFACE */
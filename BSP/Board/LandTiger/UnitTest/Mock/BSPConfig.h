@@ -0,0 +1,44 @@
+/*******************************************************************************
+ *
+ * @file BSPConfig.h
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief Mock BSP Definitions
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __BSP_CONFIG_H
+#define __BSP_CONFIG_H
+
+/********************************* INCLUDES ***********************************/
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#define BOARD_ENABLE_LED_INTERFACE 0
+
+#define BOARD_ENABLE_LCD_INTERFACE 1
+
+/* Small cache to test evictions */
+#define BOARD_LCD_TILE_CACHE_SIZE 4
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+
+#endif /* __BSP_CONFIG_H */
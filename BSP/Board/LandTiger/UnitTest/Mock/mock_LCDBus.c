@@ -0,0 +1,224 @@
+/*******************************************************************************
+ *
+ * @file mock_LCDBus.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief Mock Implementation for LCD Bus
+ *
+ *		  Simulates GRAM, window and GRAM address counter of LCD Controller
+ *		  (ILI9325) and counts bus operations so tests can check both screen
+ *		  content and bus cost of a frame.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_LCDBus.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#define MOCK_LCD_WIDTH				(240)
+#define MOCK_LCD_HEIGHT				(320)
+
+#define MOCK_LCD_REG_GRAM_X			(0x20)
+#define MOCK_LCD_REG_GRAM_Y			(0x21)
+#define MOCK_LCD_REG_GRAM			(0x22)
+#define MOCK_LCD_REG_WINDOW_X_START	(0x50)
+#define MOCK_LCD_REG_WINDOW_X_END	(0x51)
+#define MOCK_LCD_REG_WINDOW_Y_START	(0x52)
+#define MOCK_LCD_REG_WINDOW_Y_END	(0x53)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Bus operations (each one is a WR or RD strobe on real bus)
+ */
+typedef struct
+{
+	/* Index (register select) writes */
+	uint32_t indexWrites;
+	/* Data writes (register values and pixels) */
+	uint32_t dataWrites;
+	/* Data reads (including dummy reads) */
+	uint32_t dataReads;
+	/* Pixel writes to GRAM */
+	uint32_t pixelWrites;
+} MockLCDBusStats;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Bus operations since last reset */
+PRIVATE MockLCDBusStats lcdBusStats;
+
+/* Simulated GRAM */
+PRIVATE uint16_t lcdGRAM[MOCK_LCD_HEIGHT][MOCK_LCD_WIDTH];
+
+/* Simulated Registers */
+PRIVATE uint16_t lcdRegisters[0x100];
+
+/* Selected register */
+PRIVATE uint16_t lcdIndex;
+
+/* GRAM Address Counter */
+PRIVATE uint32_t lcdAddressX;
+PRIVATE uint32_t lcdAddressY;
+
+/* First GRAM read after selecting GRAM is a dummy read */
+PRIVATE bool lcdDummyReadPending;
+
+/********************************** FUNCTIONS *********************************/
+
+PRIVATE void MockLCD_ResetBusStats(void)
+{
+	lcdBusStats.indexWrites = 0;
+	lcdBusStats.dataWrites = 0;
+	lcdBusStats.dataReads = 0;
+	lcdBusStats.pixelWrites = 0;
+}
+
+/*
+ * Resets simulated LCD Controller and fills GRAM with a colour.
+ */
+PRIVATE void MockLCD_Reset(uint16_t color)
+{
+	uint32_t x;
+	uint32_t y;
+
+	for (y = 0; y < MOCK_LCD_HEIGHT; y++)
+	{
+		for (x = 0; x < MOCK_LCD_WIDTH; x++)
+		{
+			lcdGRAM[y][x] = color;
+		}
+	}
+
+	for (x = 0; x < 0x100; x++)
+	{
+		lcdRegisters[x] = 0;
+	}
+
+	lcdRegisters[MOCK_LCD_REG_WINDOW_X_END] = MOCK_LCD_WIDTH - 1;
+	lcdRegisters[MOCK_LCD_REG_WINDOW_Y_END] = MOCK_LCD_HEIGHT - 1;
+
+	lcdIndex = 0;
+	lcdAddressX = 0;
+	lcdAddressY = 0;
+	lcdDummyReadPending = false;
+
+	MockLCD_ResetBusStats();
+}
+
+/*
+ * Moves GRAM Address Counter in window (horizontal first, Entry Mode 0x1030)
+ */
+PRIVATE void MockLCD_NextAddress(void)
+{
+	lcdAddressX++;
+
+	if (lcdAddressX > lcdRegisters[MOCK_LCD_REG_WINDOW_X_END])
+	{
+		lcdAddressX = lcdRegisters[MOCK_LCD_REG_WINDOW_X_START];
+		lcdAddressY++;
+
+		if (lcdAddressY > lcdRegisters[MOCK_LCD_REG_WINDOW_Y_END])
+		{
+			lcdAddressY = lcdRegisters[MOCK_LCD_REG_WINDOW_Y_START];
+		}
+	}
+}
+
+PRIVATE void MockLCD_Write(uint16_t data)
+{
+	lcdBusStats.dataWrites++;
+
+	if (lcdIndex == MOCK_LCD_REG_GRAM)
+	{
+		lcdGRAM[lcdAddressY % MOCK_LCD_HEIGHT][lcdAddressX % MOCK_LCD_WIDTH] = data;
+		lcdBusStats.pixelWrites++;
+		MockLCD_NextAddress();
+	}
+	else
+	{
+		lcdRegisters[lcdIndex & 0xFF] = data;
+
+		if (lcdIndex == MOCK_LCD_REG_GRAM_X)
+		{
+			lcdAddressX = data;
+		}
+		else if (lcdIndex == MOCK_LCD_REG_GRAM_Y)
+		{
+			lcdAddressY = data;
+		}
+	}
+}
+
+void LCDBus_Init(void)
+{
+
+}
+
+void LCDBus_WriteIndex(uint16_t index)
+{
+	lcdBusStats.indexWrites++;
+
+	lcdIndex = index;
+	lcdDummyReadPending = (index == MOCK_LCD_REG_GRAM);
+}
+
+void LCDBus_WriteData(const uint16_t* data, uint32_t count)
+{
+	while (count--)
+	{
+		MockLCD_Write(*data++);
+	}
+}
+
+void LCDBus_FillData(uint16_t data, uint32_t count)
+{
+	while (count--)
+	{
+		MockLCD_Write(data);
+	}
+}
+
+void LCDBus_ReadData(uint16_t* data, uint32_t count)
+{
+	while (count--)
+	{
+		lcdBusStats.dataReads++;
+
+		if (lcdIndex != MOCK_LCD_REG_GRAM)
+		{
+			*data++ = lcdRegisters[lcdIndex & 0xFF];
+		}
+		else if (lcdDummyReadPending)
+		{
+			lcdDummyReadPending = false;
+			*data++ = 0xDEAD;
+		}
+		else
+		{
+			*data++ = lcdGRAM[lcdAddressY % MOCK_LCD_HEIGHT][lcdAddressX % MOCK_LCD_WIDTH];
+			MockLCD_NextAddress();
+		}
+	}
+}
+
+void LCDBus_DelayMs(uint32_t delayInMs __attribute__((__unused__)))
+{
+
+}
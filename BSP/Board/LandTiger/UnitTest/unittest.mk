@@ -0,0 +1,21 @@
+################################################################################
+#
+# @file unittest.mk
+#
+# @author Murat Cakmak (MC)
+#
+# @brief Unit test make file
+#
+# @see https://github.com/ZA-YA/ZAYA-OS/wiki
+#
+#*****************************************************************************
+#
+# GNU GPLv2
+#
+# Copyright (c) 2016 ZAYA
+#
+#  See GNU GPLv2 License Details in the Root Directory.
+#
+#*****************************************************************************/
+
+TEST_TARGET_NAME=LCD
@@ -0,0 +1,417 @@
+/*******************************************************************************
+ *
+ * @file unittest_LCD.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief Unit test file for LandTiger LCD
+ *
+ *		  LCD Bus is mocked by a simulated LCD Controller so tests check
+ *		  screen content against a reference screen and bus operations of
+ *		  each frame.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+
+/*
+ * [IMP] Our code base has some endless while loops which can not give back
+ * its execution to Unit Test framework. To avoid this, we used macros for
+ * endless while loops and we are overriding this macro for unit tests.
+ */
+#define ENDLESS_WHILE_LOOP
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "Mock/mock_LCDBus.c"
+
+/* Include LCD source file for WHITE-BOX unit testing */
+#include "../Drv_LCD.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#define TEST_LCD_NUM_OF_PIXELS		(BOARD_LCD_WIDTH * BOARD_LCD_HEIGHT)
+
+/* Index writes to set a window (4 window + 2 address + GRAM registers) */
+#define TEST_LCD_MAX_WINDOW_INDEX_WRITES	(7)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Expected screen content */
+PRIVATE Board_LcdColor referenceScreen[BOARD_LCD_HEIGHT][BOARD_LCD_WIDTH];
+
+/* Seed of pseudo random generator */
+PRIVATE uint32_t randomSeed;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	uint32_t x;
+	uint32_t y;
+
+	/* GRAM has garbage after reset */
+	MockLCD_Reset(0x1234);
+
+	for (y = 0; y < BOARD_LCD_HEIGHT; y++)
+	{
+		for (x = 0; x < BOARD_LCD_WIDTH; x++)
+		{
+			referenceScreen[y][x] = BOARD_LCD_COLOR_BLACK;
+		}
+	}
+
+	randomSeed = 12345;
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+PRIVATE uint32_t Random(uint32_t limit)
+{
+	randomSeed = randomSeed * 1103515245 + 12345;
+
+	return (randomSeed >> 8) % limit;
+}
+
+/*
+ * Fills a rectangle of reference screen and LCD
+ */
+PRIVATE void FillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, Board_LcdColor color)
+{
+	uint32_t px;
+	uint32_t py;
+
+	for (py = y; (py < y + height) && (py < BOARD_LCD_HEIGHT); py++)
+	{
+		for (px = x; (px < x + width) && (px < BOARD_LCD_WIDTH); px++)
+		{
+			referenceScreen[py][px] = color;
+		}
+	}
+
+	Board_LcdFillRect(x, y, width, height, color);
+}
+
+/*
+ * Draws a bitmap to reference screen and LCD
+ */
+PRIVATE void DrawBitmap(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const Board_LcdColor* pixels)
+{
+	uint32_t px;
+	uint32_t py;
+
+	for (py = y; (py < y + height) && (py < BOARD_LCD_HEIGHT); py++)
+	{
+		for (px = x; (px < x + width) && (px < BOARD_LCD_WIDTH); px++)
+		{
+			referenceScreen[py][px] = pixels[(py - y) * width + (px - x)];
+		}
+	}
+
+	Board_LcdDrawBitmap(x, y, width, height, pixels);
+}
+
+/*
+ * Checks whether simulated GRAM is same with reference screen
+ */
+PRIVATE bool IsScreenExpected(void)
+{
+	uint32_t x;
+	uint32_t y;
+
+	for (y = 0; y < BOARD_LCD_HEIGHT; y++)
+	{
+		for (x = 0; x < BOARD_LCD_WIDTH; x++)
+		{
+			if (lcdGRAM[y][x] != referenceScreen[y][x])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests LCD initialization.
+ *  Whole screen is cleared in one window per tile row.
+ */
+void test_LCD_Init(void)
+{
+	Board_LcdInit();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == TEST_LCD_NUM_OF_PIXELS));
+	TEST_ASSERT((lcdBusStats.dataReads == 0));
+	TEST_ASSERT((lcdRegisters[LCD_REG_ENTRY_MODE] == 0x1030));
+	TEST_ASSERT((lcdRegisters[LCD_REG_DISPLAY_CONTROL_1] == 0x0133));
+}
+
+/*
+ * Tests that redrawing same content does not use bus.
+ */
+void test_LCD_FlushWithoutChanges(void)
+{
+	Board_LcdInit();
+	MockLCD_ResetBusStats();
+
+	Board_LcdFlush();
+
+	/* Same frame again */
+	FillRect(0, 0, BOARD_LCD_WIDTH, BOARD_LCD_HEIGHT, BOARD_LCD_COLOR_BLACK);
+	FillRect(10, 10, 3, 3, BOARD_LCD_COLOR_BLACK);
+	Board_LcdSetPixel(100, 100, BOARD_LCD_COLOR_BLACK);
+	Board_LcdFlush();
+
+	TEST_ASSERT((lcdBusStats.indexWrites == 0));
+	TEST_ASSERT((lcdBusStats.dataWrites == 0));
+	TEST_ASSERT((lcdBusStats.dataReads == 0));
+}
+
+/*
+ * Tests that a pixel change sends only one pixel and changed window registers.
+ */
+void test_LCD_SetPixel(void)
+{
+	Board_LcdInit();
+	MockLCD_ResetBusStats();
+
+	referenceScreen[200][100] = BOARD_LCD_COLOR_WHITE;
+	Board_LcdSetPixel(100, 200, BOARD_LCD_COLOR_WHITE);
+
+	/* Nothing is sent before flush */
+	TEST_ASSERT((lcdBusStats.indexWrites == 0));
+
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == 1));
+	TEST_ASSERT((lcdBusStats.indexWrites == TEST_LCD_MAX_WINDOW_INDEX_WRITES));
+
+	/* Only horizontal window registers change for a pixel in same line */
+	MockLCD_ResetBusStats();
+	referenceScreen[200][101] = BOARD_LCD_COLOR_WHITE;
+	Board_LcdSetPixel(101, 200, BOARD_LCD_COLOR_WHITE);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == 1));
+	TEST_ASSERT((lcdBusStats.indexWrites == TEST_LCD_MAX_WINDOW_INDEX_WRITES - 2));
+	TEST_ASSERT((lcdBusStats.dataReads == 0));
+}
+
+/*
+ * Tests full screen fill.
+ *  Solid tiles need no cache slot and a tile row is sent in one window.
+ */
+void test_LCD_FillScreen(void)
+{
+	Board_LcdInit();
+	MockLCD_ResetBusStats();
+
+	FillRect(0, 0, BOARD_LCD_WIDTH, BOARD_LCD_HEIGHT, BOARD_LCD_COLOR_WHITE);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == TEST_LCD_NUM_OF_PIXELS));
+	TEST_ASSERT((lcdBusStats.indexWrites <= LCD_TILE_ROWS * TEST_LCD_MAX_WINDOW_INDEX_WRITES));
+	TEST_ASSERT((tileCache[0].tileNo == LCD_SLOT_FREE));
+}
+
+/*
+ * Tests a bitmap over tile borders.
+ */
+void test_LCD_DrawBitmap(void)
+{
+	Board_LcdColor bitmap[20 * 20];
+	uint32_t i;
+
+	for (i = 0; i < 20 * 20; i++)
+	{
+		bitmap[i] = (Board_LcdColor)(i * 7 + 1);
+	}
+
+	Board_LcdInit();
+	MockLCD_ResetBusStats();
+
+	DrawBitmap(10, 10, 20, 20, bitmap);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == 20 * 20));
+	TEST_ASSERT((lcdBusStats.dataReads == 0));
+
+	/* Clipped bitmap */
+	MockLCD_ResetBusStats();
+	DrawBitmap(BOARD_LCD_WIDTH - 5, BOARD_LCD_HEIGHT - 5, 20, 20, bitmap);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == 5 * 5));
+}
+
+/*
+ * Tests clipping of rectangles.
+ */
+void test_LCD_Clipping(void)
+{
+	Board_LcdInit();
+	MockLCD_ResetBusStats();
+
+	FillRect(BOARD_LCD_WIDTH - 10, BOARD_LCD_HEIGHT - 10, 50, 50, BOARD_LCD_COLOR_WHITE);
+	Board_LcdFillRect(BOARD_LCD_WIDTH, 0, 10, 10, BOARD_LCD_COLOR_WHITE);
+	Board_LcdFillRect(0, BOARD_LCD_HEIGHT, 10, 10, BOARD_LCD_COLOR_WHITE);
+	Board_LcdFillRect(0, 0, 0, 10, BOARD_LCD_COLOR_WHITE);
+	Board_LcdDrawBitmap(0, 0, 10, 10, NULL);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	TEST_ASSERT((lcdBusStats.pixelWrites == 10 * 10));
+}
+
+/*
+ * Tests bus cost of an animation frame.
+ *  Moving a sprite sends only tiles under old and new sprite positions.
+ */
+void test_LCD_FrameCost(void)
+{
+	Board_LcdColor sprite[8 * 8];
+	uint32_t i;
+
+	for (i = 0; i < 8 * 8; i++)
+	{
+		sprite[i] = BOARD_LCD_RGB(0xFF, i * 4, 0);
+	}
+
+	Board_LcdInit();
+
+	FillRect(0, 0, BOARD_LCD_WIDTH, BOARD_LCD_HEIGHT, BOARD_LCD_COLOR_WHITE);
+	DrawBitmap(50, 50, 8, 8, sprite);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+
+	/* Next frame : sprite moves 3 pixels */
+	MockLCD_ResetBusStats();
+	FillRect(50, 50, 8, 8, BOARD_LCD_COLOR_WHITE);
+	DrawBitmap(53, 50, 8, 8, sprite);
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+	/* Union of old and new sprite in tile (50 ... 60, 50 ... 57) */
+	TEST_ASSERT((lcdBusStats.pixelWrites == 11 * 8));
+	TEST_ASSERT((lcdBusStats.indexWrites <= TEST_LCD_MAX_WINDOW_INDEX_WRITES));
+	TEST_ASSERT((lcdBusStats.dataReads == 0));
+}
+
+/*
+ * Tests Tile Cache eviction.
+ *  Evicted tile is flushed and it is read back from GRAM when it is drawn
+ *  again.
+ */
+void test_LCD_TileCacheEviction(void)
+{
+	uint32_t i;
+
+	Board_LcdInit();
+
+	/* Partially draw more tiles than cache size */
+	for (i = 0; i < BOARD_LCD_TILE_CACHE_SIZE + 1; i++)
+	{
+		FillRect(i * LCD_TILE_SIZE + 1, 1, 2, 2, BOARD_LCD_COLOR_WHITE);
+	}
+
+	/* First tile is evicted and it is sent to LCD before flush */
+	TEST_ASSERT((tiles[0].slot == LCD_TILE_ON_GLASS));
+	TEST_ASSERT((!tiles[0].dirty));
+	TEST_ASSERT((lcdGRAM[1][1] == BOARD_LCD_COLOR_WHITE));
+
+	/* Draw again into evicted tile */
+	MockLCD_ResetBusStats();
+	FillRect(5, 5, 1, 1, BOARD_LCD_COLOR_WHITE);
+
+	TEST_ASSERT((lcdBusStats.dataReads == 1 + LCD_TILE_SIZE * LCD_TILE_SIZE));
+	TEST_ASSERT(IsCached(&tiles[0]));
+	TEST_ASSERT((tileCache[tiles[0].slot].pixels[1 * LCD_TILE_SIZE + 1] == BOARD_LCD_COLOR_WHITE));
+	TEST_ASSERT((tileCache[tiles[0].slot].pixels[0] == BOARD_LCD_COLOR_BLACK));
+
+	Board_LcdFlush();
+
+	TEST_ASSERT(IsScreenExpected());
+}
+
+/*
+ * Tests random drawing against reference screen.
+ */
+void test_LCD_RandomDrawing(void)
+{
+	Board_LcdColor bitmap[24 * 24];
+	uint32_t i;
+	uint32_t op;
+
+	for (i = 0; i < 24 * 24; i++)
+	{
+		bitmap[i] = (Board_LcdColor)(i * 13);
+	}
+
+	Board_LcdInit();
+
+	for (op = 0; op < 300; op++)
+	{
+		uint32_t x = Random(BOARD_LCD_WIDTH + 8);
+		uint32_t y = Random(BOARD_LCD_HEIGHT + 8);
+		uint32_t width = Random(24) + 1;
+		uint32_t height = Random(24) + 1;
+		Board_LcdColor color = (Board_LcdColor)Random(4);
+
+		switch (Random(3))
+		{
+			case 0:
+				FillRect(x, y, width * 3, height * 3, color);
+				break;
+			case 1:
+				DrawBitmap(x, y, width, height, bitmap);
+				break;
+			default:
+				FillRect(x, y, 1, 1, color);
+				break;
+		}
+
+		if ((op % 10) == 9)
+		{
+			Board_LcdFlush();
+
+			TEST_ASSERT(IsScreenExpected());
+		}
+	}
+}
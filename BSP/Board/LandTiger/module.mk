@@ -19,6 +19,6 @@
 #*****************************************************************************/
 
 #
-# Get all source files (.c files) using 'find' command except UnitTest folder
+# Get all source files (.c and .cpp files) using 'find' command except UnitTest folder
 #
-BOARD_SRC_FILES := $(shell /usr/bin/find $(BOARD_PATH) -mindepth 0 -maxdepth 6 -name "*.c" ! -path "*UnitTest*")
+BOARD_SRC_FILES := $(shell /usr/bin/find $(BOARD_PATH) -mindepth 0 -maxdepth 6 \( -name "*.c" -o -name "*.cpp" \) ! -path "*UnitTest*")
@@ -28,8 +28,14 @@
 
 /***************************** MACRO DEFINITIONS ******************************/
 
-/* Index of PENDSV Interrupt in System Handlers Priority (SCB->SHP) Register */
-#define SCB_SHP_PENDSV_INDEX			(10)
+/* Index of a System Exception in System Handlers Priority (SCB->SHP) Register */
+#define SCB_SHP_INDEX(irqNo)			(((uint32_t)(irqNo) & 0xF) - 4)
+
+/*
+ * Priority Grouping (AIRCR.PRIGROUP) value.
+ *  Preempt priority is bits [7:PRIGROUP+1] of 8 bit priority field.
+ */
+#define IRQ_PRIORITY_GROUPING			(7 - DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS)
 
 /* Initial Stack Value for Program Status Register (PSR) . */
 #define TASK_INITIAL_PSR				(0x01000000)
@@ -52,11 +58,78 @@
 #define VECTOR_TABLE_SET_MASK           (0x1FFFFF80)
 
 /* 
- * Priority of Kernel Interrupts. 
- *  Lowest priority!
+ * Priority of Kernel Interrupts. (8 bit priority value)
+ *  Lowest priority in any priority grouping!
  */
 #define KERNEL_INTERRUPT_PRIORITY       (255)
 
+/* Pattern to paint unused stack area */
+#define STACK_PAINT_PATTERN				(0xA5A5A5A5UL)
+
+/*
+ * Number of bytes which are not painted below actual Main Stack Pointer.
+ *  Protects frame of painting function itself.
+ */
+#define MAIN_STACK_PAINT_MARGIN			(32)
+
+/* Initial (Top) Address of Main Stack is first entry of vector table */
+#define MAIN_STACK_TOP					(((reg32_t*)SCB->VTOR)[0])
+
+/* Number of System Exception vectors (including initial stack pointer) */
+#define NUM_OF_SYSTEM_VECTORS			(16)
+
+/* Number of all vectors. CAN Activity is last interrupt of LPC17xx */
+#define NUM_OF_VECTORS					(NUM_OF_SYSTEM_VECTORS + CANActivity_IRQn + 1)
+
+/* Vector Table index of an IRQ (CMSIS IRQn numbering) */
+#define IRQ_VECTOR_INDEX(irqNo)			((irqNo) + NUM_OF_SYSTEM_VECTORS)
+
+/*
+ * Alignment of RAM Vector Table.
+ *  VTOR requires table to be aligned to its size rounded up to a power of
+ *  two. (51 vectors * 4 bytes -> 256 bytes)
+ */
+#define VECTOR_TABLE_ALIGNMENT			(256)
+
+/*
+ * Mask to set Vector Table offset address for RAM.
+ *  Bit29 (TBLBASE) selects SRAM region so it is kept.
+ */
+#define VECTOR_TABLE_RAM_SET_MASK		(0x3FFFFF80)
+
+/* Interrupt has not recorded any latency yet so it has no source */
+#define IRQ_LATENCY_NO_SOURCE			(0)
+
+#if DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES > 0
+
+#if !DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+#error "Interrupts can stay alive during flash programming only with RAM Vector Table!"
+#endif
+
+#if !DRV_IRQ_IS_ZERO_LATENCY(DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES - 1)
+#error "Interrupts which stay alive during flash programming must be in Zero Latency Tier!"
+#endif
+
+/* 
+ * BASEPRI value which masks all priorities except alive ones during flash
+ * programming.
+ */
+#define IAP_ALIVE_BASEPRI \
+			(DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES << (8 - DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS))
+
+/* End of on-chip flash (512K). Code and vectors above it are not in flash */
+#define FLASH_END_ADDRESS				(0x80000)
+
+#endif /* DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES */
+
+/* 
+ * State of flash programming when all interrupts are disabled. BASEPRI 
+ * values never have this bit. PRIMASK of caller is kept in bit 0 so 
+ * interrupts which were already disabled are not enabled on exit.
+ */
+#define IAP_STATE_INTERRUPTS_DISABLED	(0x80000000UL)
+#define IAP_STATE_PRIMASK				(0x00000001UL)
+
 /***************************** TYPE DEFINITIONS *******************************/
 /*
  * Map for Stack Initialization of a Task Stack
@@ -104,6 +177,46 @@ INTERNAL TCB* currentTCB;
  */
 INTERNAL Drv_CPUCore_CSGetNextTCBCallback GetNextTCBCallBack;
 
+/*
+ * System Call Handler of Upper Layer (e.g. Kernel)
+ */
+INTERNAL SystemCallHandler SystemCallHandlerCallBack;
+
+/*
+ * Critical Section Nesting Count of running task.
+ */
+INTERNAL uint32_t criticalNesting;
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Raise time (Cycle Counter) of pending PendSV.
+ */
+INTERNAL volatile uint32_t pendSVRaiseCycle;
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+/*
+ * RAM copy of Vector Table.
+ */
+PRIVATE IRQHandler ramVectorTable[NUM_OF_VECTORS] ALIGNED(VECTOR_TABLE_ALIGNMENT);
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Latency Statistics of interrupt sources.
+ */
+PRIVATE IRQLatencyStats irqLatencyStats[DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES];
+
+/*
+ * Source (index + 1) of each interrupt in irqLatencyStats or 
+ * IRQ_LATENCY_NO_SOURCE. 
+ */
+PRIVATE uint8_t irqLatencySources[NUM_OF_VECTORS];
+
+/* Number of used sources */
+PRIVATE uint32_t numOfIRQLatencySources;
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 /**************************** PRIVATE FUNCTIONS ******************************/
 
 /*
@@ -114,6 +227,244 @@ PRIVATE void ErrorOnTaskExit(void)
 	Drv_CPUCore_Halt();
 }
 
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+/*
+ * Copies active (Flash) Vector Table into RAM and activates RAM copy.
+ *  Active table is used as source because bootloader may already relocate
+ *  it to start of image (see Drv_CPUCore_JumpToImage).
+ */
+PRIVATE void InitializeRAMVectorTable(void)
+{
+	const IRQHandler* flashVectorTable = (const IRQHandler*)SCB->VTOR;
+	uint32_t i;
+
+	for (i = 0; i < NUM_OF_VECTORS; i++)
+	{
+		ramVectorTable[i] = flashVectorTable[i];
+	}
+
+	/* Table must be written before it is activated */
+	__DSB();
+
+	SCB->VTOR = (reg32_t)ramVectorTable & VECTOR_TABLE_RAM_SET_MASK;
+
+	__DSB();
+	__ISB();
+}
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+#if DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES > 0
+/*
+ * Checks whether a System Handler with configurable priority can be raised.
+ *  NMI and HardFault cannot be masked at all and SVCall is only raised by
+ *  SVC instruction which is not used in Zero Latency Tier so they are not
+ *  reported. Reserved vectors are never raised.
+ */
+PRIVATE bool IsSystemHandlerEnabled(int32_t irqNo)
+{
+	switch (irqNo)
+	{
+		case MemoryManagement_IRQn:
+			return (SCB->SHCSR & SCB_SHCSR_MEMFAULTENA_Msk) != 0;
+		case BusFault_IRQn:
+			return (SCB->SHCSR & SCB_SHCSR_BUSFAULTENA_Msk) != 0;
+		case UsageFault_IRQn:
+			return (SCB->SHCSR & SCB_SHCSR_USGFAULTENA_Msk) != 0;
+		case DebugMonitor_IRQn:
+			return (CoreDebug->DEMCR & CoreDebug_DEMCR_MON_EN_Msk) != 0;
+		case PendSV_IRQn:
+			return true;
+		case SysTick_IRQn:
+			return (SysTick->CTRL & (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk)) ==
+				   (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk);
+		default:
+			return false;
+	}
+}
+
+/*
+ * Checks whether all interrupts which are kept alive during flash 
+ * programming can run without flash. Priorities and handlers can be changed
+ * at any time so interrupts are checked on each flash programming. 
+ */
+PRIVATE bool AreIAPAliveIRQsInRAM(void)
+{
+	int32_t irqNo;
+
+	/* Vector is fetched by CPU on exception entry */
+	if (SCB->VTOR != ((reg32_t)ramVectorTable & VECTOR_TABLE_RAM_SET_MASK))
+	{
+		return false;
+	}
+
+	/* System Handlers (e.g. SysTick) are not masked if their priority is high */
+	for (irqNo = MemoryManagement_IRQn; irqNo <= SysTick_IRQn; irqNo++)
+	{
+		/* Disabled or masked handlers do not run */
+		if (!IsSystemHandlerEnabled(irqNo) ||
+			(SCB->SHP[SCB_SHP_INDEX(irqNo)] >= IAP_ALIVE_BASEPRI))
+		{
+			continue;
+		}
+
+		if ((uint32_t)ramVectorTable[IRQ_VECTOR_INDEX(irqNo)] < FLASH_END_ADDRESS)
+		{
+			return false;
+		}
+	}
+
+	for (irqNo = 0; irqNo <= CANActivity_IRQn; irqNo++)
+	{
+		/* Disabled or masked interrupts do not run */
+		if (((NVIC->ISER[irqNo >> 5] & (1UL << (irqNo & 0x1F))) == 0) ||
+			(NVIC->IP[irqNo] >= IAP_ALIVE_BASEPRI))
+		{
+			continue;
+		}
+
+		if ((uint32_t)ramVectorTable[IRQ_VECTOR_INDEX(irqNo)] < FLASH_END_ADDRESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif /* DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES */
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Starts DWT Cycle Counter which is used as time stamp of interrupts.
+ */
+PRIVATE void InitializeCycleCounter(void)
+{
+	/* DWT is powered by trace enable bit of Debug Monitor */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*
+ * Returns Latency Statistics of an interrupt. A new source is assigned on 
+ * first call for an interrupt.
+ *
+ * @return Statistics of interrupt or NULL if all sources are in use.
+ */
+PRIVATE IRQLatencyStats* GetIRQLatencySource(int32_t irqNo)
+{
+	uint32_t source = irqLatencySources[IRQ_VECTOR_INDEX(irqNo)];
+	uint32_t primask;
+
+	if (source == IRQ_LATENCY_NO_SOURCE)
+	{
+		/* 
+		 * Interrupts of any priority can record latency so sources are 
+		 * assigned with all interrupts disabled. It is just once per 
+		 * interrupt.
+		 */
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		source = irqLatencySources[IRQ_VECTOR_INDEX(irqNo)];
+
+		if ((source == IRQ_LATENCY_NO_SOURCE) &&
+			(numOfIRQLatencySources < DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES))
+		{
+			irqLatencyStats[numOfIRQLatencySources].irqNo = irqNo;
+			source = ++numOfIRQLatencySources;
+			irqLatencySources[IRQ_VECTOR_INDEX(irqNo)] = (uint8_t)source;
+		}
+
+		__set_PRIMASK(primask);
+
+		if (source == IRQ_LATENCY_NO_SOURCE)
+		{
+			return NULL;
+		}
+	}
+
+	return &irqLatencyStats[source - 1];
+}
+
+/*
+ * Returns histogram bucket of a latency. Bucket is floor(log2(latency)).
+ */
+PRIVATE ALWAYS_INLINE uint32_t GetIRQLatencyBucket(uint32_t latency)
+{
+	/* Zero latency is counted in first bucket (CLZ of zero is 32) */
+	uint32_t bucket = 31 - __CLZ(latency | 1);
+
+	return (bucket < DRV_IRQ_LATENCY_NUM_OF_BUCKETS) ? 
+			bucket : (DRV_IRQ_LATENCY_NUM_OF_BUCKETS - 1);
+}
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
+/*
+ * Sets 8 bit priority value of an interrupt or a system exception.
+ *  Unimplemented (low) bits are ignored by HW.
+ */
+PRIVATE void SetIRQPriorityValue(int32_t irqNo, uint32_t value)
+{
+	if (irqNo < 0)
+	{
+		/* System Exceptions. SHP registers are byte accessible */
+		SCB->SHP[SCB_SHP_INDEX(irqNo)] = (uint8_t)value;
+	}
+	else
+	{
+		NVIC_SetPriority((IRQn_Type)irqNo, value >> (8 - DRV_IRQ_PRIORITY_BITS));
+	}
+}
+
+/*
+ * Returns lowest word of a stack area which can be painted and measured.
+ *  Stack guard is excluded because even privileged code cannot access it.
+ */
+PRIVATE reg32_t* getStackPaintStart(reg32_t stackStart, uint32_t stackSize)
+{
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	reg32_t guardEnd = MPU_STACK_GUARD_ADDR(stackStart) + MPU_STACK_GUARD_SIZE;
+
+	if (guardEnd <= stackStart + stackSize)
+	{
+		return (reg32_t*)guardEnd;
+	}
+#else
+	(void)stackSize;
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+	/* Word aligned start address */
+	return (reg32_t*)((stackStart + sizeof(reg32_t) - 1) & ~(sizeof(reg32_t) - 1));
+}
+
+/*
+ * Paints a stack area with stack pattern
+ */
+PRIVATE void paintStack(reg32_t* start, reg32_t* end)
+{
+	while (start < end)
+	{
+		*start++ = STACK_PAINT_PATTERN;
+	}
+}
+
+/*
+ * Measures a painted stack area.
+ *  Stack grows in descending order so first overwritten word from the bottom
+ *  is the deepest point of stack.
+ */
+PRIVATE void getStackUsage(reg32_t* start, reg32_t stackTop, uint32_t stackSize, StackUsage* usage)
+{
+	while ((start < (reg32_t*)stackTop) && (*start == STACK_PAINT_PATTERN))
+	{
+		start++;
+	}
+
+	usage->size = stackSize;
+	usage->maxUsage = stackTop - (reg32_t)start;
+}
+
 /***************************** PUBLIC FUNCTIONS *******************************/
 /*
  * Initializes actual CPU and its components/peripherals.
@@ -125,6 +476,18 @@ void Drv_CPUCore_Init(void)
 {
 	/* Initialize System (Clocks, peripherals etc.) first */
 	SystemInit();
+
+	/* Split priority bits before any interrupt priority is set */
+	NVIC_SetPriorityGrouping(IRQ_PRIORITY_GROUPING);
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+	/* Interrupts are not enabled yet so table can be switched safely */
+	InitializeRAMVectorTable();
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	InitializeCycleCounter();
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
 }
 
 /*
@@ -171,6 +534,203 @@ void Drv_CPUCore_DisableInterrupts(void)
 	__disable_irq();
 }
 
+/*
+ * Masks interrupts which cannot run while flash is programmed
+ */
+uint32_t Drv_CPUCore_EnterFlashProgramming(void)
+{
+	uint32_t primask = __get_PRIMASK();
+#if DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES > 0
+	uint32_t basePri;
+
+	/* A handler cannot be changed from flash during check, keep it short */
+	__disable_irq();
+
+	if (AreIAPAliveIRQsInRAM())
+	{
+		basePri = __get_BASEPRI();
+
+		/* Caller may already mask more (e.g. a critical section) */
+		if ((basePri == 0) || (basePri > IAP_ALIVE_BASEPRI))
+		{
+			__set_BASEPRI(IAP_ALIVE_BASEPRI);
+		}
+
+		if (primask == 0)
+		{
+			__enable_irq();
+		}
+
+		return basePri;
+	}
+#else
+	/* Vectors and handlers are in flash, no interrupt can run */
+	__disable_irq();
+#endif /* DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES */
+
+	return IAP_STATE_INTERRUPTS_DISABLED | (primask & IAP_STATE_PRIMASK);
+}
+
+/*
+ * Restores interrupt masking after flash programming
+ */
+void Drv_CPUCore_ExitFlashProgramming(uint32_t state)
+{
+	if (state & IAP_STATE_INTERRUPTS_DISABLED)
+	{
+		/* Caller may have disabled interrupts before */
+		if ((state & IAP_STATE_PRIMASK) == 0)
+		{
+			__enable_irq();
+		}
+	}
+	else
+	{
+		__set_BASEPRI(state);
+	}
+}
+
+/*
+ * Sets priority of an interrupt
+ */
+void Drv_CPUCore_SetIRQPriority(int32_t irqNo, uint32_t preemptPriority, uint32_t subPriority)
+{
+	uint32_t priority;
+
+	/* Encode priority like NVIC_EncodePriority() for configured grouping */
+	priority = ((preemptPriority & DRV_IRQ_LOWEST_PREEMPT_PRIORITY) << DRV_IRQ_SUB_PRIORITY_BITS) |
+			   (subPriority & DRV_IRQ_LOWEST_SUB_PRIORITY);
+
+	SetIRQPriorityValue(irqNo, priority << (8 - DRV_IRQ_PRIORITY_BITS));
+}
+
+/*
+ * Installs an interrupt handler into RAM Vector Table
+ */
+int32_t Drv_CPUCore_SetIRQHandler(int32_t irqNo, IRQHandler handler)
+{
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+	/* First entry is initial stack pointer, not a handler */
+	if ((IRQ_VECTOR_INDEX(irqNo) < 1) || (IRQ_VECTOR_INDEX(irqNo) >= NUM_OF_VECTORS) ||
+		(handler == NULL))
+	{
+		return RESULT_FAIL;
+	}
+
+	/* A single word write so vector is never seen half updated */
+	ramVectorTable[IRQ_VECTOR_INDEX(irqNo)] = handler;
+
+	/* New vector must be visible before next exception entry */
+	__DSB();
+
+	return RESULT_SUCCESS;
+#else
+	(void)irqNo;
+	(void)handler;
+
+	/* Vector Table is in Flash */
+	return RESULT_FAIL;
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+}
+
+/*
+ * Initializes Software Interrupt
+ */
+int32_t Drv_CPUCore_InitializeSoftIRQ(IRQHandler handler, uint32_t priority)
+{
+	if (Drv_CPUCore_SetIRQHandler(DRV_CONFIG_SOFT_IRQ_NO, handler) != RESULT_SUCCESS)
+	{
+		return RESULT_FAIL;
+	}
+
+	Drv_CPUCore_SetIRQPriority(DRV_CONFIG_SOFT_IRQ_NO, priority, 0);
+	NVIC_ClearPendingIRQ((IRQn_Type)DRV_CONFIG_SOFT_IRQ_NO);
+	NVIC_EnableIRQ((IRQn_Type)DRV_CONFIG_SOFT_IRQ_NO);
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Sleeps CPU until an interrupt is pending
+ */
+void Drv_CPUCore_WaitForInterrupt(void)
+{
+	/* Complete outstanding memory accesses before sleeping */
+	__DSB();
+	__WFI();
+}
+
+/*
+ * Registers System Call Handler
+ */
+void Drv_CPUCore_InitializeSystemCalls(SystemCallHandler handler)
+{
+	SystemCallHandlerCallBack = handler;
+}
+
+/*
+ * Triggers Software Interrupt
+ */
+void Drv_CPUCore_TriggerSoftIRQ(void)
+{
+	NVIC_SetPendingIRQ((IRQn_Type)DRV_CONFIG_SOFT_IRQ_NO);
+}
+
+/*
+ * Enters a critical section
+ */
+void Drv_CPUCore_EnterCritical(void)
+{
+	__set_BASEPRI(MAX_SYSCALL_INTERRUPT_PRIORITY);
+
+	/* Ensure that new mask level is active before the critical code */
+	__DSB();
+	__ISB();
+
+	criticalNesting++;
+}
+
+/*
+ * Exits from a critical section
+ */
+void Drv_CPUCore_ExitCritical(void)
+{
+	if (criticalNesting == 0)
+	{
+		/* Unbalanced call, nothing to exit */
+		return;
+	}
+
+	criticalNesting--;
+
+	if (criticalNesting == 0)
+	{
+		/* Outermost critical section. Unmask all interrupts */
+		__set_BASEPRI(0);
+	}
+}
+
+/*
+ * Atomically replaces a word if it still has expected value
+ */
+bool Drv_CPUCore_AtomicCompareAndSwap(volatile uint32_t* address, uint32_t expected, uint32_t value)
+{
+	do
+	{
+		if (__LDREXW(address) != expected)
+		{
+			/* Release exclusive monitor, we will not store */
+			__CLREX();
+
+			return false;
+		}
+
+	/* Store fails if an interrupt (or another access) broke exclusivity */
+	} while (__STREXW(value, address) != 0);
+
+	return true;
+}
+
 /*
  * Starts Context Switching
  *  Configures HW for CS and starts first task
@@ -188,12 +748,10 @@ void Drv_CPUCore_CSStart(Drv_CPUCore_CSGetNextTCBCallback getNextTCB)
 	__disable_irq();
     
     /*
-     * Set priorities for Kernel Interrupts using System Handlers Priority (SHP)
-     *  SHB Registers are byte accessible. 
-     *  - PENDSV    : SHB[10]
+     * Set priorities for Kernel Interrupts.
+     *  - PENDSV    : Lowest, context is switched after all ISRs return
      */
-    /* TODO should we move to more common area than this function */
-	SCB->SHP[SCB_SHP_PENDSV_INDEX] = KERNEL_INTERRUPT_PRIORITY;
+	SetIRQPriorityValue(PendSV_IRQn, KERNEL_INTERRUPT_PRIORITY);
     
     /* 
 	 * Everything for CS is ready now let's trigger Context Switching
@@ -279,3 +837,146 @@ uint32_t Drv_CPUCore_GetCPUFrequency(void)
 {
 	return SystemCoreClock;
 }
+
+/*
+ * Paints a task stack
+ */
+void Drv_CPUCore_PaintStack(reg32_t stackStart, uint32_t stackSize)
+{
+	paintStack(getStackPaintStart(stackStart, stackSize),
+			   (reg32_t*)(stackStart + stackSize));
+}
+
+/*
+ * Measures usage of a task stack
+ */
+void Drv_CPUCore_GetStackUsage(reg32_t stackStart, uint32_t stackSize, StackUsage* usage)
+{
+	getStackUsage(getStackPaintStart(stackStart, stackSize),
+				  stackStart + stackSize, stackSize, usage);
+}
+
+/*
+ * Paints unused part of Main Stack
+ */
+void Drv_CPUCore_PaintMainStack(void)
+{
+	reg32_t mainStackTop = MAIN_STACK_TOP;
+	
+	paintStack(getStackPaintStart(mainStackTop - DRV_CONFIG_MAIN_STACK_SIZE, DRV_CONFIG_MAIN_STACK_SIZE),
+			   (reg32_t*)(__get_MSP() - MAIN_STACK_PAINT_MARGIN));
+}
+
+/*
+ * Measures usage of Main Stack
+ */
+void Drv_CPUCore_GetMainStackUsage(StackUsage* usage)
+{
+	reg32_t mainStackTop = MAIN_STACK_TOP;
+
+	getStackUsage(getStackPaintStart(mainStackTop - DRV_CONFIG_MAIN_STACK_SIZE, DRV_CONFIG_MAIN_STACK_SIZE),
+				  mainStackTop, DRV_CONFIG_MAIN_STACK_SIZE, usage);
+}
+
+/*
+ * Provides latency statistics of an interrupt source
+ */
+int32_t Drv_CPUCore_GetIRQLatencyStats(uint32_t source, IRQLatencyStats* stats)
+{
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	uint32_t primask;
+
+	if ((source >= numOfIRQLatencySources) || (stats == NULL))
+	{
+		return RESULT_FAIL;
+	}
+
+	/* Take a consistent copy, handler may update statistics at any time */
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	*stats = irqLatencyStats[source];
+
+	__set_PRIMASK(primask);
+
+	return RESULT_SUCCESS;
+#else
+	(void)source;
+	(void)stats;
+
+	return RESULT_FAIL;
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+}
+
+/*
+ * Clears latency statistics of all sources
+ */
+void Drv_CPUCore_ResetIRQLatencyStats(void)
+{
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	IRQLatencyStats* stats;
+	uint32_t primask;
+	uint32_t source;
+	uint32_t bucket;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	for (source = 0; source < numOfIRQLatencySources; source++)
+	{
+		stats = &irqLatencyStats[source];
+
+		stats->count = 0;
+		stats->minLatency = 0;
+		stats->maxLatency = 0;
+
+		for (bucket = 0; bucket < DRV_IRQ_LATENCY_NUM_OF_BUCKETS; bucket++)
+		{
+			stats->histogram[bucket] = 0;
+		}
+	}
+
+	__set_PRIMASK(primask);
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+}
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Records latency of an interrupt
+ */
+void Drv_CPUCore_RecordIRQLatency(int32_t irqNo, uint32_t latency)
+{
+	IRQLatencyStats* stats = GetIRQLatencySource(irqNo);
+
+	if (stats == NULL)
+	{
+		/* All sources are in use */
+		return;
+	}
+
+	/* 
+	 * An interrupt does not preempt itself so statistics of an interrupt are
+	 * updated by only one handler at a time.
+	 */
+	if ((stats->count == 0) || (latency < stats->minLatency))
+	{
+		stats->minLatency = latency;
+	}
+
+	if (latency > stats->maxLatency)
+	{
+		stats->maxLatency = latency;
+	}
+
+	stats->histogram[GetIRQLatencyBucket(latency)]++;
+	stats->count++;
+}
+
+/*
+ * Reads DWT Cycle Counter
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void)
+{
+	return DWT->CYCCNT;
+}
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
@@ -38,14 +38,6 @@
 /* Vector Table Offset Register */
 #define REG_SCB_VTOR_ADDR					(0xE000ED08)
 
-/*
- * (Comment from FreeRTOS)
- * !!!! configMAX_SYSCALL_INTERRUPT_PRIORITY must not be set to zero !!!!
- *
- *  See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html.
- */
-#define MAX_SYSCALL_INTERRUPT_PRIORITY 		(191) /* equivalent to 0xb0, or priority 11. */
-
 /*  */
 #define LOAD_EXEC_RETURN_CODE 				(0xfffffffd)
 
@@ -58,6 +50,8 @@
 #define CPUCORE_SVCALL_YIELD				(1)
 /* Raise Privilege Mode */
 #define CPUCORE_SVCALL_RAISE_PRIVILEGE		(2)
+/* System Call to Upper Layer (e.g. Kernel) */
+#define CPUCORE_SVCALL_SYSTEM_CALL			(3)
 
 /***************************** TYPE DEFINITIONS *******************************/
 
@@ -113,9 +107,15 @@ void POS_PendSV_Handler(void)
 	/* First, We need to store register to current process stack (PSP) */
 	StoreRegisterToPSP();
 
+	/* Registers of preempted task are safe now, it is earliest point to record */
+	PENDSV_RECORD_LATENCY();
+
 	/* Get Stack address of current process */
 	currentTCB->topOfStack = (reg32_t*)GetPSP();
 
+	/* Critical Section Nesting belongs to preempted task */
+	currentTCB->criticalNesting = criticalNesting;
+
 	/* Get next TCB from Upper Layer (e.g. Kernel) */
 	currentTCB = GetNextTCBCallBack();
 	
@@ -130,6 +130,23 @@ void POS_PendSV_Handler(void)
 	 */
 	MPUSetUserCodeSection(currentTCB->codeStartAddress, currentTCB->codeSize);
 	MPUSetUserRAMSection(currentTCB->dataStartAddress, currentTCB->dataSize);
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	/* Protect bottom of new application stack against overflow */
+	MPUSetUserStackGuard(currentTCB->stackStartAddress, currentTCB->stackSize);
+#endif
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	/* Loaded regions belong to previous application */
+	MPUFlushDynamicRegions();
+#endif
+
+	/* 
+	 * Restore Critical Section of new application. BASEPRI is not stacked
+	 * by exception entry so new value is active after exception return.
+	 */
+	criticalNesting = currentTCB->criticalNesting;
+	__set_BASEPRI(CRITICAL_SECTION_BASEPRI(criticalNesting));
 	
 	/* 
 	 * Set control register. 
@@ -190,6 +207,7 @@ void SVCHandler(uint32_t * svc_args)
 			break;
 		case CPUCORE_SVCALL_YIELD:
 			/* Set a PendSV to request a context switch. */
+			PENDSV_RECORD_RAISE();
 			SCB->ICSR = (reg32_t)SCB_ICSR_PENDSVSET_Msk;
 
 			/*
@@ -201,6 +219,21 @@ void SVCHandler(uint32_t * svc_args)
 		case CPUCORE_SVCALL_RAISE_PRIVILEGE:
 			/* Not defined yet */
 			break;
+		case CPUCORE_SVCALL_SYSTEM_CALL:
+			/* 
+			 * Arguments are in stacked r0-r3 of caller. Result is written into
+			 * stacked r0 so caller gets it as return value.
+			 */
+			if (SystemCallHandlerCallBack != NULL)
+			{
+				svc_args[0] = SystemCallHandlerCallBack(svc_args[0], svc_args[1],
+														svc_args[2], svc_args[3]);
+			}
+			else
+			{
+				svc_args[0] = (uint32_t)RESULT_FAIL;
+			}
+			break;
 		default:
 			break;
 	}
@@ -277,6 +310,17 @@ PRIVATE ALWAYS_INLINE void SwitchToFirstTask(void)
 	
 	MPUSetUserCodeSection(currentTCB->codeStartAddress, currentTCB->codeSize);
 	MPUSetUserRAMSection(currentTCB->dataStartAddress, currentTCB->dataSize);
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	MPUSetUserStackGuard(currentTCB->stackStartAddress, currentTCB->stackSize);
+#endif
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	MPUFlushDynamicRegions();
+#endif
+
+	/* First task starts out of critical section, BASEPRI is cleared below */
+	criticalNesting = currentTCB->criticalNesting;
 	
 	__set_CONTROL((currentTCB->flags.privileged == 0));
 	
@@ -356,7 +400,15 @@ void Drv_CPUCore_CSYield(bool privileged)
 		 * user app) should be aware of its mode (Priv or unpriv)
 		 * 
 		 */
+		PENDSV_RECORD_RAISE();
 		SCB->ICSR = (reg32_t)SCB_ICSR_PENDSVSET_Msk;
+
+		/* 
+		 * Kernel forces a switch (e.g. to terminate a faulty app) so PendSV 
+		 * must not be blocked by critical section of running task. Nesting
+		 * count is kept and restored if task is scheduled again.
+		 */
+		__set_BASEPRI(0);
 	}
 	else
 	{
@@ -377,6 +429,22 @@ void Drv_CPUCore_CSYield(bool privileged)
 	}
 }
 
+/*
+ * SVC Call for System Calls. ARMCC passes arguments in r0-r3 and returns r0 of
+ * caller frame.
+ */
+uint32_t __svc(CPUCORE_SVCALL_SYSTEM_CALL) SVCSystemCall(uint32_t callNo, uint32_t arg0,
+														  uint32_t arg1, uint32_t arg2);
+
+/*
+ * Makes a System Call.
+ */
+LOCATE_AT(uint32_t Drv_CPUCore_SystemCall(uint32_t callNo, uint32_t arg0, uint32_t arg1, uint32_t arg2), "0xF200");
+uint32_t Drv_CPUCore_SystemCall(uint32_t callNo, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+	return SVCSystemCall(callNo, arg0, arg1, arg2);
+}
+
 #else /* GNU C - GCC Assembly Area */
 /*
  * TODO : [IMP] Until we use assembly code, we will not test Assembly modules.
@@ -418,8 +486,7 @@ ASSEMBLY_FUNCTION void POS_PendSV_Handler(void)
 		"	stmdb sp!, {r3, r14}				\n"
 		"	mov r0, %0							\n"
 		"	msr basepri, r0						\n"
-		"	bl SwitchContext					\n"
-		"	mov r0, #0							\n"
+		"	bl SwitchContext					\n" /* Returns BASEPRI of next task. */
 		"	msr basepri, r0						\n"
 		"	ldmia sp!, {r3, r14}				\n"
 		"										\n"	/* Restore the context, including the critical nesting count. */
@@ -436,6 +503,43 @@ ASSEMBLY_FUNCTION void POS_PendSV_Handler(void)
 	);
 }
 
+/*
+ * Switches current TCB to next TCB. Called by PendSV ISR after registers of
+ * preempted task are saved.
+ *
+ * @param none
+ *
+ * @return BASEPRI value (critical section state) of next task
+ */
+INTERNAL reg32_t SwitchContext(void)
+{
+	/* Earliest point in C after registers of preempted task are saved */
+	PENDSV_RECORD_LATENCY();
+
+	/* Critical Section Nesting belongs to preempted task */
+	currentTCB->criticalNesting = criticalNesting;
+
+	/* Get next TCB from Upper Layer (e.g. Kernel) */
+	currentTCB = GetNextTCBCallBack();
+
+	MPUSetUserCodeSection(currentTCB->codeStartAddress, currentTCB->codeSize);
+	MPUSetUserRAMSection(currentTCB->dataStartAddress, currentTCB->dataSize);
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	MPUSetUserStackGuard(currentTCB->stackStartAddress, currentTCB->stackSize);
+#endif
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	MPUFlushDynamicRegions();
+#endif
+
+	__set_CONTROL((currentTCB->flags.privileged == 0));
+
+	criticalNesting = currentTCB->criticalNesting;
+
+	return CRITICAL_SECTION_BASEPRI(criticalNesting);
+}
+
 /*
  * ISR for SVC Exception
  *
@@ -37,6 +37,7 @@
 /********************************* INCLUDES ***********************************/
 
 #include "Drv_CPUCore.h"
+#include "Drv_CPUCore_Internal.h"
 
 #include "DrvConfig.h"
 
@@ -158,7 +159,7 @@ PRIVATE ALWAYS_INLINE void processBusFault(Exception* exc, reg32_t* val)
 /*
  *  Processes Memory Management Faults
  */
-PRIVATE ALWAYS_INLINE void processMemFault(Exception* exc, reg32_t* val)
+PRIVATE ALWAYS_INLINE void processMemFault(Exception* exc, reg32_t* val, uint32_t stack[])
 {
 	/* 
 	 * Check whether Memory Management Fault Adddress Register is valid. 
@@ -189,6 +190,44 @@ PRIVATE ALWAYS_INLINE void processMemFault(Exception* exc, reg32_t* val)
 		*exc = Exception_AccessViolation;
 		*val = ((SCB->CFSR & SCB_CFSR_MEMFAULTSR_Msk) >> SCB_CFSR_MEMFAULTSR_Pos);
 	}
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	if ((SCB->CFSR & REG_SCB_CFSR_USGFAULT_MMARVALID_Msk) &&
+		MPUIsStackGuardAddress(SCB->MMFAR))
+	{
+		/* Stack grew into its guard region */
+		*exc = Exception_StackOverflow;
+	}
+	else if (SCB->CFSR & REG_SCB_CFSR_USGFAULT_MSTKERR_Msk)
+	{
+		/* 
+		 * Exception entry could not push registers to stack. 
+		 * MMFAR is not valid for stacking errors but only reason to get a MPU
+		 * fault on stacking is a stack pointer in guard region. 
+		 */
+		*exc = Exception_StackOverflow;
+		*val = 0;
+	}
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	if (*exc == Exception_CodeAccessViolation)
+	{
+		/* MMFAR is not valid for instruction fetches, faulty address is PC */
+		if (MPULoadMemoryRegion(stack[pc], true))
+		{
+			*exc = Exception_NoException;
+		}
+	}
+	else if ((*exc == Exception_DataAccessViolation) &&
+			 (SCB->CFSR & REG_SCB_CFSR_USGFAULT_MMARVALID_Msk))
+	{
+		if (MPULoadMemoryRegion(*val, false))
+		{
+			*exc = Exception_NoException;
+		}
+	}
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
 }
 
 /*
@@ -196,7 +235,7 @@ PRIVATE ALWAYS_INLINE void processMemFault(Exception* exc, reg32_t* val)
  * 
  * NOTE it assumes just one exception (Usage, Mem or Bus) at a time. 
  */
-PRIVATE ALWAYS_INLINE void processForcedException(Exception* exc, reg32_t* val)
+PRIVATE ALWAYS_INLINE void processForcedException(Exception* exc, reg32_t* val, uint32_t stack[])
 {
 	/* Let's clear forced fault flags first */
 	SCB->HFSR |= SCB_HFSR_FORCED_Msk;
@@ -214,7 +253,7 @@ PRIVATE ALWAYS_INLINE void processForcedException(Exception* exc, reg32_t* val)
 	else if ((SCB->CFSR & SCB_CFSR_MEMFAULTSR_Msk) != 0)
 	{
 		/* Memory Management Fault */
-		processMemFault(exc, val);
+		processMemFault(exc, val, stack);
 	}
 	
 	/* 
@@ -243,7 +282,7 @@ INTERNAL void HardFault_Handler(uint32_t stack[])
 		 * Forced exception (not handled by Usage, Bus or MemManagement
 		 * Exceptions)
 		 */
-		processForcedException(&exc, &val);
+		processForcedException(&exc, &val, stack);
 	}
 	else 
 	{
@@ -254,6 +293,15 @@ INTERNAL void HardFault_Handler(uint32_t stack[])
 		exc = Exception_HardFault;
 		val = SCB->HFSR;
 	}
+
+	if (exc == Exception_NoException)
+	{
+		/* 
+		 * Fault is resolved (e.g. missing MPU region is loaded). Returning
+		 * from exception retries faulty instruction. 
+		 */
+		return;
+	}
 	
 	if (userExcCallback != NULL)
 	{
@@ -22,10 +22,94 @@
 #define __DRV_CPUCORE_INTERNAL_H
 
 /********************************* INCLUDES ***********************************/
+#include "Drv_CPUCore.h"
+
+#include "DRVConfig.h"
+
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Enables MPU Stack Guard Regions.
+ *  When enabled, a small no-access MPU region is placed at the bottom of
+ *  active user app stack and at the bottom of Kernel (Main) stack. A stack
+ *  overflow hits the guard and it is reported as Exception_StackOverflow
+ *  instead of silently corrupting adjacent RAM.
+ */
+#ifndef DRV_CONFIG_ENABLE_STACK_GUARD
+#define DRV_CONFIG_ENABLE_STACK_GUARD					(0)
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+/*
+ * Enables MPU Region Virtualization.
+ *  When enabled, additional memory regions of tasks (TCB memoryRegions) and 
+ *  GPIO/Peripheral windows are loaded into free MPU regions on demand (when 
+ *  an access faults) like a software managed TLB. 
+ */
+#ifndef DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+#define DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION		(0)
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
+/*
+ * Interrupt which is used as Software Interrupt (see Drv_CPUCore_TriggerSoftIRQ).
+ *  An interrupt of an unused peripheral is selected. Quadrature Encoder 
+ *  Interface is powered off by default so it never raises its interrupt.
+ */
+#ifndef DRV_CONFIG_SOFT_IRQ_NO
+#define DRV_CONFIG_SOFT_IRQ_NO							(QEI_IRQn)
+#endif /* DRV_CONFIG_SOFT_IRQ_NO */
+
+/*
+ * Size of Main Stack (MSP) which is used by Kernel and ISRs.
+ *  [IMP] Must be same with Stack_Size in startup file of project.
+ */
+#ifndef DRV_CONFIG_MAIN_STACK_SIZE
+#define DRV_CONFIG_MAIN_STACK_SIZE						(0x1000)
+#endif /* DRV_CONFIG_MAIN_STACK_SIZE */
+
+/* Returns BASEPRI value of a task using its critical section nesting count */
+#define CRITICAL_SECTION_BASEPRI(nesting) \
+			(((nesting) > 0) ? MAX_SYSCALL_INTERRUPT_PRIORITY : 0)
+
+/*
+ * Stack Guard Size.
+ *  Smallest MPU region (32 bytes) is used as guard. It is enough to catch 
+ *  overflows because stack grows word by word (or frame by frame for 
+ *  exception stacking which is also smaller than 32 bytes).
+ */
+#define MPU_STACK_GUARD_SIZE							(32)
+
+/*
+ * Returns guard address for a stack area.
+ *  Guard must be aligned with its size so it is carved from the lowest
+ *  aligned bytes of stack area and never covers data below stack.
+ */
+#define MPU_STACK_GUARD_ADDR(stackStart) \
+			(((stackStart) + (MPU_STACK_GUARD_SIZE - 1)) & ~(MPU_STACK_GUARD_SIZE - 1))
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Keeps raise time of PendSV. If PendSV is already pending, first raise is 
+ * kept because latency starts from there.
+ */
+#define PENDSV_RECORD_RAISE() \
+			{ \
+				if ((SCB->ICSR & SCB_ICSR_PENDSVSET_Msk) == 0) \
+				{ \
+					pendSVRaiseCycle = DWT->CYCCNT; \
+				} \
+			}
+
+/* Records latency of PendSV handler */
+#define PENDSV_RECORD_LATENCY() \
+			Drv_CPUCore_RecordIRQLatency(PendSV_IRQn, DWT->CYCCNT - pendSVRaiseCycle)
+#else
+/* Empty definitions if IRQ Latency Statistics is disabled */
+#define PENDSV_RECORD_RAISE()
+#define PENDSV_RECORD_LATENCY()
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /**************************** FUNCTION PROTOTYPES *****************************/
@@ -35,6 +119,25 @@
  */
 extern Drv_CPUCore_CSGetNextTCBCallback GetNextTCBCallBack;
 
+/*
+ * System Call Handler of Upper Layer (e.g. Kernel)
+ */
+extern SystemCallHandler SystemCallHandlerCallBack;
+
+/*
+ * Critical Section Nesting Count of running task.
+ *  Context switcher saves it into TCB of preempted task and restores it from
+ *  TCB of next task.
+ */
+extern uint32_t criticalNesting;
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Raise time (Cycle Counter) of pending PendSV.
+ */
+extern volatile uint32_t pendSVRaiseCycle;
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 /*
  * Generic Hard Fault Handler while HW Hard Fault handler is compiler 
  * (armcc, gcc) dependent. HW handler calls this handler to process hard
@@ -86,4 +189,48 @@ void MPUSetUserCodeSection(reg32_t codeStart, uint32_t codeSize);
  */
 void MPUSetUserRAMSection(reg32_t ramStart, uint32_t ramSize);
 
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+/*
+ * Sets Stack Guard Region of User Application.
+ *  Guard is placed into lowest (aligned) bytes of provided stack area.
+ *
+ * @param stackStart User App Stack Start (Lowest) Address
+ * @param stackSize User App Stack Size
+ *
+ * @return none
+ */
+void MPUSetUserStackGuard(reg32_t stackStart, uint32_t stackSize);
+
+/*
+ * Checks whether an address is in an active stack guard region.
+ *
+ * @param address Address to check (e.g. Faulty address from MMFAR)
+ *
+ * @return true if address belongs to a stack guard, otherwise false.
+ */
+bool MPUIsStackGuardAddress(reg32_t address);
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+/*
+ * Loads region of running task which covers a faulty address.
+ *
+ * @param address Faulty address
+ * @param codeAccess true if fault is caused by an instruction fetch
+ *
+ * @return true if a region is loaded and faulty access can be retried, 
+ *         false if address is not granted to running task.
+ */
+bool MPULoadMemoryRegion(reg32_t address, bool codeAccess);
+
+/*
+ * Unloads all dynamic regions. Called on context switch.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void MPUFlushDynamicRegions(void);
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
 #endif /* __DRV_CPUCORE_INTERNAL_H */
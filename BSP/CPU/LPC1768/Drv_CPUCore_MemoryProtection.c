@@ -52,9 +52,70 @@
 #define MPU_REGION_NOTVALID								(0)
 #define MPU_REGION_VALID								(1)
 
+/*
+ * Privileged Code and RAM regions are not programmed when Stack Guards or 
+ * Region Virtualization are enabled because both features need more MPU 
+ * regions than Cortex-M3 provides (8). Background region (PRIVDEFENA) already
+ * provides same access to privileged code and denies unprivileged access to
+ * any address which is not covered by a region.
+ */
+#define MPU_PRIVILEGED_REGIONS_IN_BACKGROUND \
+			(DRV_CONFIG_ENABLE_STACK_GUARD || DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION)
+
 /*
  * MPU Region Types
+ *
+ *  Higher region number has priority on overlapping areas so guards are 
+ *  located at the top to override User RAM region. Dynamic (virtualized) 
+ *  regions are located at the bottom, they never override fixed regions.
  */
+#if MPU_PRIVILEGED_REGIONS_IN_BACKGROUND
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+/* User Regions */
+#define MPU_REGION_UNPRIVILEGED_USER_CODE				(4)
+#define MPU_REGION_UNPRIVILEGED_USER_RAM				(5)
+
+/* Stack Guard Regions */
+#define MPU_REGION_KERNEL_STACK_GUARD					(6)
+#define MPU_REGION_USER_STACK_GUARD						(7)
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+/* 
+ * Dynamic Regions. Shared RAM is loaded on demand as a common virtual region
+ * to leave enough dynamic slots.
+ */
+#define MPU_REGION_DYNAMIC_FIRST						(0)
+#define MPU_NUM_OF_DYNAMIC_REGIONS						(3)
+#define MPU_SHARED_RAM_IS_VIRTUAL						(1)
+
+/* Shared Regions */
+#define MPU_REGION_SHARED_CODE							(3)
+#else
+ /* Privileged Regions*/
+#define MPU_REGION_PRIVILEGED_GPIO						(0)
+#define MPU_REGION_PRIVILEGED_PERIPHERALS				(1)
+
+/* Shared Regions */
+#define MPU_REGION_SHARED_CODE							(2)
+#define MPU_REGION_SHARED_RAM							(3)
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
+#else /* Only Region Virtualization */
+/* Dynamic Regions */
+#define MPU_REGION_DYNAMIC_FIRST						(0)
+#define MPU_NUM_OF_DYNAMIC_REGIONS						(4)
+
+/* Shared Regions */
+#define MPU_REGION_SHARED_CODE							(4)
+#define MPU_REGION_SHARED_RAM							(5)
+
+/* User Regions */
+#define MPU_REGION_UNPRIVILEGED_USER_CODE				(6)
+#define MPU_REGION_UNPRIVILEGED_USER_RAM				(7)
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#else
  /* Privileged Regions*/
 #define MPU_REGION_PRIVILEGED_CODE						(0)
 #define MPU_REGION_PRIVILEGED_RAM						(1)
@@ -68,6 +129,24 @@
 /* User Regions */
 #define MPU_REGION_UNPRIVILEGED_USER_CODE				(6)
 #define MPU_REGION_UNPRIVILEGED_USER_RAM				(7)
+#endif /* MPU_PRIVILEGED_REGIONS_IN_BACKGROUND */
+
+#ifndef MPU_SHARED_RAM_IS_VIRTUAL
+#define MPU_SHARED_RAM_IS_VIRTUAL						(0)
+#endif /* MPU_SHARED_RAM_IS_VIRTUAL */
+
+/*
+ * Minimum number of dynamic slots. An instruction may need an executable
+ * region and two data regions (e.g. a copy between two granted blocks) at 
+ * the same time. With fewer slots, loading one evicts another one which
+ * faults again and application never progresses.
+ */
+#define MPU_MIN_NUM_OF_DYNAMIC_REGIONS					(3)
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION && \
+	(MPU_NUM_OF_DYNAMIC_REGIONS < MPU_MIN_NUM_OF_DYNAMIC_REGIONS)
+#error "MPU Region Virtualization needs at least 3 dynamic regions!"
+#endif
 
 /*
  * Details of MPU Regions
@@ -84,9 +163,22 @@
 
 /* GPIO */
 #define MPU_REGION_GPIO_START 							(LPC_GPIO_BASE)
-#define MPU_REGION_GPIO_SIZE 							(0x3FFF)
+#define MPU_REGION_GPIO_SIZE 							(0x4000)
 #define MPU_REGION_GPIO_SIZE_VALUE						(13)
 
+/* 
+ * Bit-Band Alias of GPIO (see Drv_GPIO_GetPinAlias). Each bit of GPIO 
+ * registers is a word in alias window.
+ */
+#define MPU_REGION_GPIO_ALIAS_START						(0x22000000UL + ((LPC_GPIO_BASE - 0x20000000UL) * 32))
+#define MPU_REGION_GPIO_ALIAS_SIZE						(MPU_REGION_GPIO_SIZE * 32)
+
+/* 
+ * Size of a Peripheral Register Block
+ *  Each APB peripheral has a 16KB slot which is aligned with its size.
+ */
+#define MPU_PERIPHERAL_BLOCK_SIZE						(0x4000)
+
 /* Peripherals */
 #define MPU_REGION_PERIPHERALS_START					(0x40000000UL)
 #define MPU_REGION_PERIPHERALS_END						(0x5FFFFFFFUL)
@@ -96,6 +188,8 @@
  * AP Encoding Types
  *  Specifies Read/Write Writes
  */
+/* No Access */
+#define MPU_AP_ENCODING_NO_ACCESS						(0)
 /* Read/Write  */
 #define MPU_AP_ENCODING_RW								(3)
 /* Read Only */
@@ -123,10 +217,20 @@
 
 #define MPU_SMALLEST_PERMITTED_REGION_SIZE				(32)
 
+/* 
+ * RASR Size Value of Stack Guard (MPU_STACK_GUARD_SIZE).
+ *  See Drv_CPUCore_Internal.h for guard size and address.
+ */
+#define MPU_STACK_GUARD_SIZE_VALUE						(4)
+
+/* Invalid Guard Address to mark unused guards */
+#define MPU_STACK_GUARD_NONE							(0xFFFFFFFFUL)
+
 /*
  * Default Region Specific MPU Register Settings
  *
  */
+#if !MPU_PRIVILEGED_REGIONS_IN_BACKGROUND
 /*
  * Privileged FLASH
  */
@@ -158,7 +262,9 @@
 			(MPU_ACCESS_CACHEABLE_BUFFERABLE << MPU_RASR_B_Pos) | \
 			(MPU_REGION_SRAM_SIZE_VALUE << MPU_RASR_SIZE_Pos) | \
 			(MPU_RASR_ENABLE_Msk)
+#endif /* !MPU_PRIVILEGED_REGIONS_IN_BACKGROUND */
 
+#if !DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
 /*
  * Privileged GPIO
  */
@@ -190,6 +296,7 @@
 			(MPU_RASR_XN_Msk) | \
 			(MPU_REGION_PERIPHERALS_SIZE_VALUE << MPU_RASR_SIZE_Pos) | \
 			(MPU_RASR_ENABLE_Msk)
+#endif /* !DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
 
 /*
  * UnPrivileged Shared Flash
@@ -256,11 +363,121 @@
 			(getRegionSizeValue(size) << MPU_RASR_SIZE_Pos) | \
 			(MPU_RASR_ENABLE_Msk)
 
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+/*
+ * Stack Guards
+ */
+/* RBAR Settings for Stack Guard Regions */
+#define MPU_STACK_GUARD_RBAR_VAL(region, guardStart) \
+			(region) | \
+			(MPU_RBAR_VALID_Msk) | \
+			(MPU_ALIGN_REGION_ADDR(guardStart) << MPU_RBAR_ADDR_Pos)
+
+/* RASR Settings for Stack Guard Regions */
+#define MPU_STACK_GUARD_RASR_VAL \
+			(MPU_AP_ENCODING_NO_ACCESS << MPU_RASR_AP_Pos) | \
+			(MPU_RASR_XN_Msk) | \
+			(MPU_ACCESS_CACHEABLE_BUFFERABLE << MPU_RASR_B_Pos) | \
+			(MPU_STACK_GUARD_SIZE_VALUE << MPU_RASR_SIZE_Pos) | \
+			(MPU_RASR_ENABLE_Msk)
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+/*
+ * Dynamic (Virtualized) Regions
+ */
+/* RBAR Settings for Dynamic Regions */
+#define MPU_DYNAMIC_RBAR_VAL(slot, start) \
+			(MPU_REGION_DYNAMIC_FIRST + (slot)) | \
+			(MPU_RBAR_VALID_Msk) | \
+			(MPU_ALIGN_REGION_ADDR(start) << MPU_RBAR_ADDR_Pos)
+
+/* RASR Settings for Dynamic Regions */
+#define MPU_DYNAMIC_RASR_VAL(region) \
+			(((region)->flags.writable ? MPU_AP_ENCODING_RW : MPU_AP_ENCODING_RO) << MPU_RASR_AP_Pos) | \
+			((region)->flags.executable ? 0 : MPU_RASR_XN_Msk) | \
+			(getRegionSizeValue((region)->size) << MPU_RASR_SIZE_Pos) | \
+			(MPU_RASR_ENABLE_Msk)
+
+/* Number of regions which are common for all applications */
+#define MPU_NUM_OF_COMMON_REGIONS \
+			(sizeof(commonRegions) / sizeof(MemoryRegion))
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /**************************** FUNCTION PROTOTYPES *****************************/
 
 /******************************** VARIABLES ***********************************/
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+/* Active Kernel (Main) Stack Guard Address */
+PRIVATE reg32_t kernelStackGuard = MPU_STACK_GUARD_NONE;
+
+/* Active User Application Stack Guard Address */
+PRIVATE reg32_t userStackGuard = MPU_STACK_GUARD_NONE;
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+/*
+ * Reference of Current (Running) Task TCB.
+ *  Dynamic regions are looked up from memory region table of running task.
+ */
+extern TCB* currentTCB;
+
+/*
+ * Virtual regions which are common for all user applications. 
+ *  They are loaded on demand like application specific regions.
+ *
+ *  Other peripherals are not accessible by applications unless Kernel grants
+ *  a peripheral to an application (See Drv_CPUCore_GetPeripheralRegion()).
+ *  Pin Configuration block is not mapped since a pin of Kernel or another
+ *  application could be changed. Kernel configures pins for applications.
+ */
+PRIVATE MemoryRegion commonRegions[] =
+{
+	/* GPIO */
+	{ MPU_REGION_GPIO_START, MPU_REGION_GPIO_SIZE, { true, false } },
+	/* Bit-Band Alias of GPIO (Pin Aliases) */
+	{ MPU_REGION_GPIO_ALIAS_START, MPU_REGION_GPIO_ALIAS_SIZE, { true, false } },
+#if MPU_SHARED_RAM_IS_VIRTUAL
+	/* Shared RAM. Set on MPU initialization, empty until then */
+	{ 0, 0, { true, true } }
+#endif /* MPU_SHARED_RAM_IS_VIRTUAL */
+};
+
+/*
+ * Register Block Addresses of Peripherals.
+ *  Order must be same with Peripheral enumeration.
+ */
+PRIVATE const reg32_t peripheralBlocks[Peripheral_NumOfPeripherals] =
+{
+	LPC_TIM0_BASE,
+	LPC_TIM1_BASE,
+	LPC_TIM2_BASE,
+	LPC_TIM3_BASE,
+	LPC_UART0_BASE,
+	LPC_UART1_BASE,
+	LPC_UART2_BASE,
+	LPC_UART3_BASE,
+	LPC_I2C0_BASE,
+	LPC_I2C1_BASE,
+	LPC_I2C2_BASE,
+	LPC_SPI_BASE,
+	LPC_SSP0_BASE,
+	LPC_SSP1_BASE,
+	LPC_PWM1_BASE,
+	LPC_ADC_BASE,
+	LPC_DAC_BASE,
+	LPC_RTC_BASE,
+	LPC_QEI_BASE
+};
+
+/* Loaded regions into dynamic MPU slots */
+PRIVATE const MemoryRegion* dynamicRegions[MPU_NUM_OF_DYNAMIC_REGIONS];
+
+/* Next slot to be replaced */
+PRIVATE uint32_t nextDynamicSlot = 0;
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
 
 /***************************** PRIVATE FUNCTIONS ******************************/
 
@@ -315,8 +532,224 @@ INTERNAL void MPUSetUserRAMSection(reg32_t sectionStart, uint32_t size)
 	MPU->RASR = MPU_URAM_RASR_VAL(size);
 }
 
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+/*
+ * Sets a stack guard region into the lowest aligned bytes of a stack area.
+ *
+ * @return Guard Address or MPU_STACK_GUARD_NONE if stack is too small to 
+ *         keep a guard.
+ */
+PRIVATE reg32_t setStackGuard(uint32_t region, reg32_t stackStart, uint32_t stackSize)
+{
+	reg32_t guardStart = MPU_STACK_GUARD_ADDR(stackStart);
+
+	if ((stackSize == 0) ||
+		(guardStart + MPU_STACK_GUARD_SIZE > stackStart + stackSize))
+	{
+		/* No room for a guard, just disable region */
+		MPU->RNR = region;
+		MPU->RASR = 0;
+
+		return MPU_STACK_GUARD_NONE;
+	}
+
+	MPU->RBAR = MPU_STACK_GUARD_RBAR_VAL(region, guardStart);
+	MPU->RASR = MPU_STACK_GUARD_RASR_VAL;
+
+	return guardStart;
+}
+
+/*
+ * Sets (Protects) bottom of user app stack
+ */
+INTERNAL void MPUSetUserStackGuard(reg32_t stackStart, uint32_t stackSize)
+{
+	userStackGuard = setStackGuard(MPU_REGION_USER_STACK_GUARD, stackStart, stackSize);
+}
+
+/*
+ * Checks whether an address hits a stack guard
+ */
+INTERNAL bool MPUIsStackGuardAddress(reg32_t address)
+{
+	if ((kernelStackGuard != MPU_STACK_GUARD_NONE) &&
+		(address - kernelStackGuard < MPU_STACK_GUARD_SIZE))
+	{
+		return true;
+	}
+
+	if ((userStackGuard != MPU_STACK_GUARD_NONE) &&
+		(address - userStackGuard < MPU_STACK_GUARD_SIZE))
+	{
+		return true;
+	}
+
+	return false;
+}
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
+
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+/*
+ * Searches a region which covers provided address in a region table.
+ */
+PRIVATE const MemoryRegion* findRegion(const MemoryRegion* regions, uint32_t numOfRegions,
+									   reg32_t address, bool codeAccess)
+{
+	uint32_t index;
+
+	for (index = 0; index < numOfRegions; index++, regions++)
+	{
+		if ((address - regions->startAddress < regions->size) &&
+			(!codeAccess || regions->flags.executable))
+		{
+			return regions;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Loads a region into a free or replaced dynamic MPU slot. 
+ *
+ *  MPU does not report hits so actual usage of loaded regions is not known. 
+ *  Replacement uses load order (least recently loaded region is evicted). 
+ *  A region which is evicted but still in use is loaded again by next fault. 
+ */
+PRIVATE void loadDynamicRegion(const MemoryRegion* region)
+{
+	uint32_t slot = nextDynamicSlot;
+
+	dynamicRegions[slot] = region;
+
+	MPU->RBAR = MPU_DYNAMIC_RBAR_VAL(slot, region->startAddress);
+	MPU->RASR = MPU_DYNAMIC_RASR_VAL(region);
+
+	nextDynamicSlot = (slot + 1) % MPU_NUM_OF_DYNAMIC_REGIONS;
+}
+
+/*
+ * Loads missing region of running application which covers faulty address. 
+ */
+INTERNAL bool MPULoadMemoryRegion(reg32_t address, bool codeAccess)
+{
+	const MemoryRegion* region = NULL;
+	uint32_t slot;
+
+	/* Kernel (Privileged) tasks use background region, nothing to load */
+	if ((currentTCB == NULL) || currentTCB->flags.privileged)
+	{
+		return false;
+	}
+
+	if (currentTCB->memoryRegions != NULL)
+	{
+		region = findRegion(currentTCB->memoryRegions, 
+							currentTCB->numOfMemoryRegions, 
+							address, 
+							codeAccess);
+	}
+
+	if (region == NULL)
+	{
+		region = findRegion(commonRegions, MPU_NUM_OF_COMMON_REGIONS, address, codeAccess);
+	}
+
+	if (region == NULL)
+	{
+		/* Address is not granted to application. Real violation. */
+		return false;
+	}
+
+	for (slot = 0; slot < MPU_NUM_OF_DYNAMIC_REGIONS; slot++)
+	{
+		if (dynamicRegions[slot] == region)
+		{
+			/* 
+			 * Region is already loaded so fault is caused by access rights 
+			 * (e.g. write to a read only region). Loading it again would 
+			 * cause an endless fault loop.
+			 */
+			return false;
+		}
+	}
+
+	loadDynamicRegion(region);
+
+	return true;
+}
+
+/*
+ * Unloads all dynamic regions.
+ */
+INTERNAL void MPUFlushDynamicRegions(void)
+{
+	uint32_t slot;
+
+	for (slot = 0; slot < MPU_NUM_OF_DYNAMIC_REGIONS; slot++)
+	{
+		MPU->RNR = MPU_REGION_DYNAMIC_FIRST + slot;
+		MPU->RASR = 0;
+
+		dynamicRegions[slot] = NULL;
+	}
+
+	nextDynamicSlot = 0;
+}
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
 /***************************** PUBLIC FUNCTIONS *******************************/
 
+/*
+ * Checks whether a memory region can be mapped to a MPU region
+ */
+PUBLIC bool Drv_CPUCore_MPUIsValidRegion(const MemoryRegion* region)
+{
+	/* Size must be a power of two and at least smallest region size */
+	if ((region->size < MPU_SMALLEST_PERMITTED_REGION_SIZE) ||
+		((region->size & (region->size - 1)) != 0))
+	{
+		return false;
+	}
+
+	/* Start address must be aligned with region size */
+	if ((region->startAddress & (region->size - 1)) != 0)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Provides register block of a peripheral as a memory region
+ */
+PUBLIC int32_t Drv_CPUCore_GetPeripheralRegion(Peripheral peripheral, MemoryRegion* region)
+{
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	if ((uint32_t)peripheral >= Peripheral_NumOfPeripherals)
+	{
+		return RESULT_FAIL;
+	}
+
+	region->startAddress = peripheralBlocks[peripheral];
+	region->size = MPU_PERIPHERAL_BLOCK_SIZE;
+	region->flags.writable = true;
+	region->flags.executable = false;
+
+	return RESULT_SUCCESS;
+#else
+	/* 
+	 * There is no free MPU region to map a peripheral without virtualization 
+	 * so a peripheral cannot be granted. 
+	 */
+	(void)peripheral;
+	(void)region;
+
+	return RESULT_FAIL;
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+}
+
 /*
  * Initializes MPU
  *
@@ -329,8 +762,9 @@ PUBLIC void Drv_CPUCore_InitializeMPU(reg32_t sharedCodeStart, uint32_t sharedCo
 							   reg32_t sharedRAMStart,  uint32_t sharedRAMSize)
 {
 	/* Enter Critical Section to ensure about integrity of MPU initialization */
-	__disable_irq();
+	Drv_CPUCore_EnterCritical();
 
+#if !MPU_PRIVILEGED_REGIONS_IN_BACKGROUND
 	/* FLASH (Code) */
 	MPU->RBAR = MPU_FLASH_RBAR_VAL;
 	MPU->RASR = MPU_FLASH_RASR_VAL;
@@ -338,7 +772,12 @@ PUBLIC void Drv_CPUCore_InitializeMPU(reg32_t sharedCodeStart, uint32_t sharedCo
 	/* RAM */
 	MPU->RBAR = MPU_RAM_RBAR_VAL;
 	MPU->RASR = MPU_RAM_RASR_VAL;
+#endif /* !MPU_PRIVILEGED_REGIONS_IN_BACKGROUND */
 
+#if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	/* GPIO and Peripherals are loaded on demand as common virtual regions */
+	MPUFlushDynamicRegions();
+#else
 	/* GPIO */
 	MPU->RBAR = MPU_GPIO_RBAR_VAL;
 	MPU->RASR = MPU_GPIO_RASR_VAL;
@@ -346,6 +785,7 @@ PUBLIC void Drv_CPUCore_InitializeMPU(reg32_t sharedCodeStart, uint32_t sharedCo
 	/* PERIPHERALS */
 	MPU->RBAR = MPU_PERIPHERALS_RBAR_VAL;
 	MPU->RASR = MPU_PERIPHERALS_RASR_VAL;
+#endif /* DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
 	
 	if (sharedCodeSize >= MPU_SMALLEST_PERMITTED_REGION_SIZE)
 	{
@@ -356,14 +796,35 @@ PUBLIC void Drv_CPUCore_InitializeMPU(reg32_t sharedCodeStart, uint32_t sharedCo
 	
 	if (sharedRAMSize >= MPU_SMALLEST_PERMITTED_REGION_SIZE)
 	{
+#if MPU_SHARED_RAM_IS_VIRTUAL
+		/* Shared (UnPrivileged) RAM Section is loaded on demand */
+		commonRegions[MPU_NUM_OF_COMMON_REGIONS - 1].startAddress = sharedRAMStart;
+		commonRegions[MPU_NUM_OF_COMMON_REGIONS - 1].size = sharedRAMSize;
+#else
 		/* Shared (UnPrivileged) RAM Section */
 		MPU->RBAR = MPU_SHARED_RAM_RBAR_VAL(sharedRAMStart);
 		MPU->RASR = MPU_SHARED_RAM_RASR_VAL(sharedRAMSize);
+#endif /* MPU_SHARED_RAM_IS_VIRTUAL */
+	}
+
+#if DRV_CONFIG_ENABLE_STACK_GUARD
+	{
+		/* 
+		 * Kernel (Main) Stack Guard. 
+		 *  First entry of active vector table keeps initial (top) address 
+		 *  of Main Stack. 
+		 */
+		reg32_t mainStackTop = ((reg32_t*)SCB->VTOR)[0];
+
+		kernelStackGuard = setStackGuard(MPU_REGION_KERNEL_STACK_GUARD,
+										 mainStackTop - DRV_CONFIG_MAIN_STACK_SIZE,
+										 DRV_CONFIG_MAIN_STACK_SIZE);
 	}
+#endif /* DRV_CONFIG_ENABLE_STACK_GUARD */
 
 	/* Enable the MPU with the background region configured. */
 	MPU->CTRL |= ( MPU_CTRL_ENABLE_Msk | MPU_CTRL_PRIVDEFENA_Msk );
 
 	/* Exit from critical section */
-	__enable_irq();
+	Drv_CPUCore_ExitCritical();
 }
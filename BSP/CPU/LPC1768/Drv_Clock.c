@@ -0,0 +1,350 @@
+/*******************************************************************************
+ *
+ * @file Drv_Clock.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief CPU Clock Level Implementation for LPC17xx.
+ *
+ *			PLL0 is configured once at startup (SystemInit) and it is not
+ *			touched at runtime. Levels are created by changing only CPU Clock
+ *			Divider (CCLKCFG) which divides PLL0 output (FCCO) glitch free so
+ *			PLL does not need to be disconnected and relocked. USB Clock is
+ *			also derived from FCCO so it is not affected.
+ *
+ *			Peripheral Clock Selections (PCLKSEL) must not be changed while
+ *			PLL0 is connected (LPC17xx Errata) so peripherals keep their
+ *			dividers and their clocks follow CPU Clock. Timer prescalers and
+ *			UART baud divisors are recalculated instead.
+ *
+ *			Sequence of a level change (with interrupts disabled) :
+ *			  - Flash wait states are increased before speeding up
+ *			  - CPU Clock Divider is changed and SystemCoreClock is updated
+ *			  - Flash wait states are decreased after slowing down
+ *			  - Timer prescalers and UART baud divisors are updated
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_Clock.h"
+#include "Drv_CPUCore.h"
+#include "Drv_Timer.h"
+#include "Drv_UART.h"
+
+#include "LPC17xx.h"
+#include "lpc17xx_clkpwr.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* PLL0 Status Register (PLL0STAT) bits */
+#define CLOCK_PLL0STAT_ENABLED				(1UL << 24)
+#define CLOCK_PLL0STAT_CONNECTED			(1UL << 25)
+
+/* Flash Access Time field (FLASHTIM) of Flash Configuration Register */
+#define CLOCK_FLASHTIM_POS					(12)
+#define CLOCK_FLASHTIM_MASK					(0xFUL << CLOCK_FLASHTIM_POS)
+
+/*
+ * Max CPU Clock for each flash access clock. Flash access takes
+ * FLASHTIM + 1 CPU Clocks and one more clock is needed for each 20 MHz.
+ */
+#define CLOCK_FLASH_FREQUENCY_PER_CLOCK		(20000000)
+
+/* Max FLASHTIM value (6 CPU Clocks, safe for all CPU Clocks) */
+#define CLOCK_FLASHTIM_MAX					(5)
+
+/*
+ * Candidate CPU Clock Dividers (CCLKCFG + 1) for lower levels, slowest first.
+ *  PLL0 output (FCCO) is 400 MHz with default startup configuration so
+ *  levels are 20, 40, 80 MHz and startup clock (100 MHz). Timer clocks of
+ *  these levels are multiples of 1 MHz.
+ *  Dividers which are not higher than startup divider are skipped.
+ */
+#define CLOCK_LOWER_LEVEL_DIVIDERS			{ 20, 10, 5 }
+
+/* Peripheral Clock Selection of peripherals which are not clocked by PCLK */
+#define CLOCK_PCLKSEL_NONE					(0xFF)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * CPU Clock Level
+ */
+typedef struct
+{
+	/* CPU Clock Divider (CCLKCFG + 1) */
+	uint32_t divider;
+	/* CPU Clock in Hz */
+	uint32_t frequency;
+} ClockLevelInfo;
+
+/*
+ * Power and Clock Control of a peripheral
+ */
+typedef struct
+{
+	/* Power Control bit (PCONP). DAC does not have one */
+	uint32_t PCONP_Value;
+	/* Peripheral Clock Selection position (PCLKSEL0 : 0~31, PCLKSEL1 : 32~63) */
+	uint8_t pclkSelection;
+	/* Peripheral Clock Divider (CLKPWR_PCLKSEL_CCLK_DIV_X) */
+	uint8_t pclkDivider;
+} PeripheralClockInfo;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Candidate dividers of lower levels */
+PRIVATE const uint8_t lowerLevelDividers[] = CLOCK_LOWER_LEVEL_DIVIDERS;
+
+/* Validated levels, slowest first */
+PRIVATE ClockLevelInfo clockLevels[DRV_CLOCK_MAX_NUM_OF_LEVELS];
+
+/* Number of validated levels */
+PRIVATE uint32_t numOfClockLevels;
+
+/* Active level */
+PRIVATE ClockLevel activeClockLevel;
+
+/* Power and Clock Controls in order of Peripheral */
+PRIVATE const PeripheralClockInfo peripheralClocks[Peripheral_NumOfPeripherals] =
+{
+	{ CLKPWR_PCONP_PCTIM0, CLKPWR_PCLKSEL_TIMER0, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCTIM1, CLKPWR_PCLKSEL_TIMER1, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCTIM2, CLKPWR_PCLKSEL_TIMER2, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCTIM3, CLKPWR_PCLKSEL_TIMER3, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCUART0, CLKPWR_PCLKSEL_UART0, CLKPWR_PCLKSEL_CCLK_DIV_1 },
+	{ CLKPWR_PCONP_PCUART1, CLKPWR_PCLKSEL_UART1, CLKPWR_PCLKSEL_CCLK_DIV_1 },
+	{ CLKPWR_PCONP_PCUART2, CLKPWR_PCLKSEL_UART2, CLKPWR_PCLKSEL_CCLK_DIV_1 },
+	{ CLKPWR_PCONP_PCUART3, CLKPWR_PCLKSEL_UART3, CLKPWR_PCLKSEL_CCLK_DIV_1 },
+	{ CLKPWR_PCONP_PCI2C0, CLKPWR_PCLKSEL_I2C0, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCI2C1, CLKPWR_PCLKSEL_I2C1, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCI2C2, CLKPWR_PCLKSEL_I2C2, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCSPI, CLKPWR_PCLKSEL_SPI, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCSSP0, CLKPWR_PCLKSEL_SSP0, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCSSP1, CLKPWR_PCLKSEL_SSP1, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCPWM1, CLKPWR_PCLKSEL_PWM1, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCAD, CLKPWR_PCLKSEL_ADC, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ 0, CLKPWR_PCLKSEL_DAC, CLKPWR_PCLKSEL_CCLK_DIV_4 },
+	{ CLKPWR_PCONP_PCRTC, CLOCK_PCLKSEL_NONE, 0 },
+	{ CLKPWR_PCONP_PCQEI, CLKPWR_PCLKSEL_QEI, CLKPWR_PCLKSEL_CCLK_DIV_4 }
+};
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Sets flash wait states for a CPU Clock.
+ *  Other fields of FLASHCFG must be kept.
+ *
+ * @param frequency CPU Clock in Hz
+ */
+PRIVATE ALWAYS_INLINE void SetFlashAccessTime(uint32_t frequency)
+{
+	uint32_t flashTim = (frequency - 1) / CLOCK_FLASH_FREQUENCY_PER_CLOCK;
+
+	if (flashTim > CLOCK_FLASHTIM_MAX)
+	{
+		flashTim = CLOCK_FLASHTIM_MAX;
+	}
+
+	LPC_SC->FLASHCFG = (LPC_SC->FLASHCFG & ~CLOCK_FLASHTIM_MASK) |
+					   (flashTim << CLOCK_FLASHTIM_POS);
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes CPU Clock Levels.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Clock_Init(void)
+{
+	uint32_t startupDivider = (LPC_SC->CCLKCFG & 0xFF) + 1;
+	uint32_t pllFrequency = SystemCoreClock * startupDivider;
+	uint32_t pll0Status = LPC_SC->PLL0STAT;
+	uint32_t i;
+
+	numOfClockLevels = 0;
+
+	/* Lower levels are only possible if CPU Clock is divided from PLL0 */
+	if ((pll0Status & (CLOCK_PLL0STAT_ENABLED | CLOCK_PLL0STAT_CONNECTED)) ==
+		(CLOCK_PLL0STAT_ENABLED | CLOCK_PLL0STAT_CONNECTED))
+	{
+		for (i = 0; i < sizeof(lowerLevelDividers); i++)
+		{
+			if (lowerLevelDividers[i] > startupDivider)
+			{
+				clockLevels[numOfClockLevels].divider = lowerLevelDividers[i];
+				clockLevels[numOfClockLevels].frequency = pllFrequency / lowerLevelDividers[i];
+				numOfClockLevels++;
+			}
+		}
+	}
+
+	/* Startup clock is highest level */
+	clockLevels[numOfClockLevels].divider = startupDivider;
+	clockLevels[numOfClockLevels].frequency = SystemCoreClock;
+	activeClockLevel = numOfClockLevels;
+	numOfClockLevels++;
+}
+
+/*
+ * Gets number of CPU Clock Levels.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint32_t Drv_Clock_GetNumOfLevels(void)
+{
+	return numOfClockLevels;
+}
+
+/*
+ * Gets active CPU Clock Level.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC ClockLevel Drv_Clock_GetLevel(void)
+{
+	return activeClockLevel;
+}
+
+/*
+ * Gets CPU Clock Frequency of a level.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint32_t Drv_Clock_GetLevelFrequency(ClockLevel level)
+{
+	if (level >= numOfClockLevels)
+	{
+		return 0;
+	}
+
+	return clockLevels[level].frequency;
+}
+
+/*
+ * Switches CPU Clock to a level.
+ *
+ *  Checks are done with interrupts disabled so a Timer or UART cannot be
+ *  started between checks and switch.
+ */
+PUBLIC int32_t Drv_Clock_SetLevel(ClockLevel level)
+{
+	const ClockLevelInfo* newLevel;
+	bool speedUp;
+
+	if (level >= numOfClockLevels)
+	{
+		return RESULT_FAIL;
+	}
+
+	if (level == activeClockLevel)
+	{
+		return RESULT_SUCCESS;
+	}
+
+	newLevel = &clockLevels[level];
+	speedUp = level > activeClockLevel;
+
+	Drv_CPUCore_DisableInterrupts();
+
+	if (!Drv_Timer_IsCPUFrequencySupported(newLevel->frequency) ||
+		!Drv_UART_IsCPUFrequencySupported(newLevel->frequency))
+	{
+		Drv_CPUCore_EnableInterrupts();
+
+		return RESULT_FAIL;
+	}
+
+	/* Flash must be slowed down before CPU is speeded up */
+	if (speedUp)
+	{
+		SetFlashAccessTime(newLevel->frequency);
+	}
+
+	LPC_SC->CCLKCFG = newLevel->divider - 1;
+	SystemCoreClock = newLevel->frequency;
+
+	/* Flash can be speeded up after CPU is slowed down */
+	if (!speedUp)
+	{
+		SetFlashAccessTime(newLevel->frequency);
+	}
+
+	/* Peripheral Clocks follow CPU Clock, keep their tick and baud rates */
+	Drv_Timer_UpdateCPUFrequency();
+	Drv_UART_UpdateCPUFrequency();
+
+	activeClockLevel = level;
+
+	Drv_CPUCore_EnableInterrupts();
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Powers on a peripheral and selects its Peripheral Clock.
+ *
+ *  Clock is selected before peripheral is powered on.
+ */
+PUBLIC void Drv_Clock_EnablePeripheral(Peripheral peripheral)
+{
+	const PeripheralClockInfo* clockInfo;
+	reg32_t* pclkSel;
+	uint32_t pclkPos;
+
+	if ((uint32_t)peripheral >= Peripheral_NumOfPeripherals)
+	{
+		return;
+	}
+
+	clockInfo = &peripheralClocks[peripheral];
+
+	/* PCLKSEL must not be written while PLL0 is connected (LPC17xx Errata) */
+	if ((clockInfo->pclkSelection != CLOCK_PCLKSEL_NONE) &&
+		((LPC_SC->PLL0STAT & CLOCK_PLL0STAT_CONNECTED) == 0))
+	{
+		/* PCLKSEL0 and PCLKSEL1 are consecutive registers */
+		pclkSel = &(&LPC_SC->PCLKSEL0)[clockInfo->pclkSelection / 32];
+		pclkPos = clockInfo->pclkSelection % 32;
+
+		*pclkSel = (*pclkSel & ~CLKPWR_PCLKSEL_BITMASK(pclkPos)) |
+				   CLKPWR_PCLKSEL_SET(pclkPos, clockInfo->pclkDivider);
+	}
+
+	LPC_SC->PCONP |= clockInfo->PCONP_Value & CLKPWR_PCONP_BITMASK;
+}
+
+/*
+ * Powers off a peripheral.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Clock_DisablePeripheral(Peripheral peripheral)
+{
+	if ((uint32_t)peripheral >= Peripheral_NumOfPeripherals)
+	{
+		return;
+	}
+
+	LPC_SC->PCONP &= ~peripheralClocks[peripheral].PCONP_Value;
+}
@@ -134,6 +134,26 @@ typedef struct
 PRIVATE IAPInterface runIAPCommand = (IAPInterface)IAP_INTERFACE_ADDRESS;
 
 /**************************** PRIVATE FUNCTIONS ******************************/
+/**
+ * Runs an IAP command.
+ *
+ * [IMP] Flash is not accessible during IAP erase/write so interrupts which
+ * run from flash (vectors and ISRs) must be masked. BASEPRI based critical
+ * section (Drv_CPUCore_EnterCritical) is not enough here because it does
+ * not mask high priority interrupts. CPU Core masks all interrupts or keeps
+ * only RAM resident ones (see DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES).
+ */
+PRIVATE void ExecuteIAPCommand(unsigned long* params, IAPResult* iapResult)
+{
+    uint32_t state;
+
+    state = Drv_CPUCore_EnterFlashProgramming();
+
+    runIAPCommand(params, (unsigned long *)iapResult);
+
+    Drv_CPUCore_ExitFlashProgramming(state);
+}
+
 /**
  * Returns start address of specified block
  */
@@ -184,17 +204,8 @@ PUBLIC int32_t Drv_Flash_EraseBlockRange(uint32_t startBlockNo, uint32_t endBloc
     eraseParams.endSector = (unsigned long)endBlockNo;
     eraseParams.cpuClockInKHZ = (unsigned long)CPU_CLOCK_IN_KHZ();
 
-    /*
-     * Enter critical section.
-     * Need to disable interupts first
-     */
-    Drv_CPUCore_DisableInterrupts();
-
 	/* Run erase command */
-    runIAPCommand((unsigned long *)&eraseParams, (unsigned long *)&iapResult);
-
-	/* Exit critical section */
-    Drv_CPUCore_EnableInterrupts();
+    ExecuteIAPCommand((unsigned long *)&eraseParams, &iapResult);
 
     if (iapResult.result != IAP_STATUS_SUCCESS)
     {
@@ -233,17 +244,8 @@ int32_t Drv_Flash_Write(uint32_t address, uint8_t* data, uint32_t length)
     writeParams.byteCount = (unsigned long)length;
     writeParams.cpuClockInKHZ = (unsigned long)CPU_CLOCK_IN_KHZ();
 
-    /*
-     * Enter critical section.
-     * Need to disable interupts first
-     */
-    Drv_CPUCore_DisableInterrupts();
-
 	/* Run Flash Write Command */
-    runIAPCommand((unsigned long *)&writeParams, (unsigned long *)&iapResult);
-
-	/* Exit from Critical Section */
-    Drv_CPUCore_EnableInterrupts();
+    ExecuteIAPCommand((unsigned long *)&writeParams, &iapResult);
 
     if (iapResult.result != IAP_STATUS_SUCCESS)
     {
@@ -282,15 +284,7 @@ int32_t Drv_Flash_PrepareBlockRange(uint32_t startBlockNo, uint32_t endBlockNo)
 	statusParams.startSector = (unsigned long)startBlockNo;
     statusParams.endSector = (unsigned long)endBlockNo;
 
-    /*
-     * Enter critical section.
-     * Need to disable interupts first
-     */
-    Drv_CPUCore_DisableInterrupts();
-
-    runIAPCommand((unsigned long *)&statusParams, (unsigned long *)&iapResult);
-
-    Drv_CPUCore_EnableInterrupts();
+    ExecuteIAPCommand((unsigned long *)&statusParams, &iapResult);
 
     if (iapResult.result == IAP_STATUS_SUCCESS)
     {
@@ -333,6 +327,15 @@ int32_t Drv_Flash_GetBlockNoOfAddress(uint32_t address)
     return blockNo;
 }
 
+/**
+ * Returns start address of a block.
+ *  Block number after last block returns end of flash.
+ */
+uint32_t Drv_Flash_GetBlockAddress(uint32_t blockNo)
+{
+    return getBlockAddress(blockNo);
+}
+
 uint32_t Drv_Flash_GetSize(void)
 {
 	return FLASH_LPC17xx_FLASH_SIZE;
@@ -6,6 +6,13 @@
  *
  * @brief General Purpose Input/Output Driver Implementation
  *
+ *        Edge Interrupts
+ *			Port 0 and Port 2 pins detect rising and falling edges through
+ *			GPIO Interrupt registers. All GPIO interrupts share EINT3 vector
+ *			so ISR reads overall status first and then rising and falling
+ *			status of each port. Edges are cleared before callbacks are
+ *			called so edges which occur during callbacks are not lost.
+ *
  * @see https://github.com/ZA-YA/ZAYA-OS/wiki
  *
  ******************************************************************************
@@ -21,18 +28,167 @@
 /********************************* INCLUDES ***********************************/
 #include "Drv_GPIO.h"
 
+#include "Drv_CPUCore.h"
+
 #include "LPC17xx.h"
 
 #include "Debug.h"
 #include "postypes.h"
 
+#include "DRVConfig.h"
+
 /***************************** MACRO DEFINITIONS ******************************/
+/* GPIO Registers are in Bit-Band region of AHB SRAM */
+#define GPIO_BITBAND_REGION_BASE		(0x20000000)
+#define GPIO_BITBAND_ALIAS_BASE			(0x22000000)
+
+/* Each bit of region is mapped to a word in alias region */
+#define GPIO_BITBAND_ALIAS(regAddr, bit) \
+	(GPIO_BITBAND_ALIAS_BASE + (((regAddr) - GPIO_BITBAND_REGION_BASE) * 32) + ((bit) * 4))
+
+/* PINSEL and PINMODE registers have two bits per pin so 16 pins per register */
+#define GPIO_PINS_PER_PINREG			(16)
+
+/*
+ * Preempt Priority of GPIO (EINT3) Interrupt.
+ *  Client callbacks are called from ISR and they may use Kernel services so
+ *  GPIO interrupt must be masked by critical sections.
+ */
+#ifndef DRV_CONFIG_GPIO_PRIORITY
+#define DRV_CONFIG_GPIO_PRIORITY		(27)
+#endif	/* DRV_CONFIG_GPIO_PRIORITY */
+
+#if DRV_CONFIG_GPIO_PRIORITY > DRV_IRQ_LOWEST_PREEMPT_PRIORITY
+#error "GPIO priority is out of range of preempt priority bits!"
+#endif
+
+#if !DRV_IRQ_IS_KERNEL_AWARE(DRV_CONFIG_GPIO_PRIORITY)
+#error "GPIO priority must not be higher than MAX_SYSCALL_INTERRUPT_PRIORITY!"
+#endif
+
+/* Number of pins per port */
+#define GPIO_NUM_OF_PINS_PER_PORT		(32)
+
+/* Number of ports which can generate interrupts (Port 0 and Port 2) */
+#define GPIO_NUM_OF_INT_PORTS			(2)
+
+/* Pins which can generate interrupts (P0.0-11, P0.15-30 and P2.0-13) */
+#define GPIO_INT_PORT0_PIN_MASK			(0x7FFF8FFFu)
+#define GPIO_INT_PORT2_PIN_MASK			(0x00003FFFu)
+
+/* Port Interrupt Pending bits of IntStatus Register */
+#define GPIO_INT_STATUS_PORT0			(1u << 0)
+#define GPIO_INT_STATUS_PORT2			(1u << 2)
+
+/* Interrupt Port Index (0 for Port 0, 1 for Port 2) */
+#define GPIO_INT_PORT_INDEX(port)		((port) / 2)
+
+/*
+ * Interrupt Registers of a port.
+ *  Port 2 registers are located 8 words after Port 0 registers.
+ */
+#define GPIO_INT_PORT_REGS(portIndex) \
+	((GPIOIntPortRegisters*)(&LPC_GPIOINT->IO0IntStatR + ((portIndex) * 8)))
 
 /***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Interrupt Registers of a port (IOxIntStatR ... IOxIntEnF)
+ */
+typedef struct
+{
+	__I  uint32_t IntStatR;
+	__I  uint32_t IntStatF;
+	__O  uint32_t IntClr;
+	__IO uint32_t IntEnR;
+	__IO uint32_t IntEnF;
+} GPIOIntPortRegisters;
+
+/*
+ * Peripheral of an alternate pin function
+ */
+typedef struct
+{
+	uint8_t port;
+	uint8_t pin;
+	uint8_t functionNo;
+	uint8_t peripheral;
+} PinPeripheral;
 
 /**************************** FUNCTION PROTOTYPES *****************************/
 
 /******************************** VARIABLES ***********************************/
+/*
+ * Interrupt Callbacks of pins
+ */
+PRIVATE Drv_GPIO_InterruptCallback pinCallbacks[GPIO_NUM_OF_INT_PORTS][GPIO_NUM_OF_PINS_PER_PORT];
+
+/*
+ * Alternate pin functions of peripherals (LPC176x User Manual, Pin Connect
+ * Block). Functions of peripherals which are not listed in Peripheral
+ * (CAN, USB, Ethernet, I2S and Motor Control PWM) are left out. QEI inputs
+ * share Motor Control inputs (MCI0~2).
+ */
+PRIVATE const PinPeripheral pinPeripherals[] =
+{
+	{ 0, 0, 2, Peripheral_UART3 },	{ 0, 0, 3, Peripheral_I2C1 },
+	{ 0, 1, 2, Peripheral_UART3 },	{ 0, 1, 3, Peripheral_I2C1 },
+	{ 0, 2, 1, Peripheral_UART0 },	{ 0, 2, 2, Peripheral_ADC },
+	{ 0, 3, 1, Peripheral_UART0 },	{ 0, 3, 2, Peripheral_ADC },
+	{ 0, 4, 3, Peripheral_Timer2 },
+	{ 0, 5, 3, Peripheral_Timer2 },
+	{ 0, 6, 2, Peripheral_SSP1 },	{ 0, 6, 3, Peripheral_Timer2 },
+	{ 0, 7, 2, Peripheral_SSP1 },	{ 0, 7, 3, Peripheral_Timer2 },
+	{ 0, 8, 2, Peripheral_SSP1 },	{ 0, 8, 3, Peripheral_Timer2 },
+	{ 0, 9, 2, Peripheral_SSP1 },	{ 0, 9, 3, Peripheral_Timer2 },
+	{ 0, 10, 1, Peripheral_UART2 },	{ 0, 10, 2, Peripheral_I2C2 },	{ 0, 10, 3, Peripheral_Timer3 },
+	{ 0, 11, 1, Peripheral_UART2 },	{ 0, 11, 2, Peripheral_I2C2 },	{ 0, 11, 3, Peripheral_Timer3 },
+	{ 0, 15, 1, Peripheral_UART1 },	{ 0, 15, 2, Peripheral_SSP0 },	{ 0, 15, 3, Peripheral_SPI },
+	{ 0, 16, 1, Peripheral_UART1 },	{ 0, 16, 2, Peripheral_SSP0 },	{ 0, 16, 3, Peripheral_SPI },
+	{ 0, 17, 1, Peripheral_UART1 },	{ 0, 17, 2, Peripheral_SSP0 },	{ 0, 17, 3, Peripheral_SPI },
+	{ 0, 18, 1, Peripheral_UART1 },	{ 0, 18, 2, Peripheral_SSP0 },	{ 0, 18, 3, Peripheral_SPI },
+	{ 0, 19, 1, Peripheral_UART1 },	{ 0, 19, 3, Peripheral_I2C1 },
+	{ 0, 20, 1, Peripheral_UART1 },	{ 0, 20, 3, Peripheral_I2C1 },
+	{ 0, 21, 1, Peripheral_UART1 },
+	{ 0, 22, 1, Peripheral_UART1 },
+	{ 0, 23, 1, Peripheral_ADC },	{ 0, 23, 3, Peripheral_Timer3 },
+	{ 0, 24, 1, Peripheral_ADC },	{ 0, 24, 3, Peripheral_Timer3 },
+	{ 0, 25, 1, Peripheral_ADC },	{ 0, 25, 3, Peripheral_UART3 },
+	{ 0, 26, 1, Peripheral_ADC },	{ 0, 26, 2, Peripheral_DAC },	{ 0, 26, 3, Peripheral_UART3 },
+	{ 0, 27, 1, Peripheral_I2C0 },
+	{ 0, 28, 1, Peripheral_I2C0 },
+
+	{ 1, 18, 2, Peripheral_PWM1 },	{ 1, 18, 3, Peripheral_Timer1 },
+	{ 1, 19, 3, Peripheral_Timer1 },
+	{ 1, 20, 1, Peripheral_QEI },	{ 1, 20, 2, Peripheral_PWM1 },	{ 1, 20, 3, Peripheral_SSP0 },
+	{ 1, 21, 2, Peripheral_PWM1 },	{ 1, 21, 3, Peripheral_SSP0 },
+	{ 1, 22, 3, Peripheral_Timer1 },
+	{ 1, 23, 1, Peripheral_QEI },	{ 1, 23, 2, Peripheral_PWM1 },	{ 1, 23, 3, Peripheral_SSP0 },
+	{ 1, 24, 1, Peripheral_QEI },	{ 1, 24, 2, Peripheral_PWM1 },	{ 1, 24, 3, Peripheral_SSP0 },
+	{ 1, 25, 3, Peripheral_Timer1 },
+	{ 1, 26, 2, Peripheral_PWM1 },	{ 1, 26, 3, Peripheral_Timer0 },
+	{ 1, 27, 3, Peripheral_Timer0 },
+	{ 1, 28, 2, Peripheral_PWM1 },	{ 1, 28, 3, Peripheral_Timer0 },
+	{ 1, 29, 2, Peripheral_PWM1 },	{ 1, 29, 3, Peripheral_Timer0 },
+	{ 1, 30, 3, Peripheral_ADC },
+	{ 1, 31, 2, Peripheral_SSP1 },	{ 1, 31, 3, Peripheral_ADC },
+
+	{ 2, 0, 1, Peripheral_PWM1 },	{ 2, 0, 2, Peripheral_UART1 },
+	{ 2, 1, 1, Peripheral_PWM1 },	{ 2, 1, 2, Peripheral_UART1 },
+	{ 2, 2, 1, Peripheral_PWM1 },	{ 2, 2, 2, Peripheral_UART1 },
+	{ 2, 3, 1, Peripheral_PWM1 },	{ 2, 3, 2, Peripheral_UART1 },
+	{ 2, 4, 1, Peripheral_PWM1 },	{ 2, 4, 2, Peripheral_UART1 },
+	{ 2, 5, 1, Peripheral_PWM1 },	{ 2, 5, 2, Peripheral_UART1 },
+	{ 2, 6, 1, Peripheral_PWM1 },	{ 2, 6, 2, Peripheral_UART1 },
+	{ 2, 7, 2, Peripheral_UART1 },
+	{ 2, 8, 2, Peripheral_UART2 },
+	{ 2, 9, 2, Peripheral_UART2 },
+
+	{ 3, 25, 2, Peripheral_Timer0 },	{ 3, 25, 3, Peripheral_PWM1 },
+	{ 3, 26, 2, Peripheral_Timer0 },	{ 3, 26, 3, Peripheral_PWM1 },
+
+	{ 4, 28, 2, Peripheral_Timer2 },	{ 4, 28, 3, Peripheral_UART3 },
+	{ 4, 29, 2, Peripheral_Timer2 },	{ 4, 29, 3, Peripheral_UART3 }
+};
 
 /**************************** PRIVATE FUNCTIONS *******************************/
 /**
@@ -104,6 +260,185 @@ PRIVATE ALWAYS_INLINE void SetPinMode(uint32_t port, uint32_t pin, uint32_t driv
     SetPinRegister(&LPC_PINCON->PINMODE0, port, pin, driverMode);
 }
 
+/**
+ * Sets pin registers of multiple pins.
+ * Same as SetPinRegister() but all pins in same PINSEL (or PINMODE) register
+ * are updated by single read-modify-write.
+ *
+ * @param regPtr to be set Register
+ * @param port Port Number of IOs
+ * @param pinMask Pins to set
+ * @param value new pin value according to selected Register
+ *
+ * @return none
+ */
+PRIVATE void SetPortRegister(reg32_t* regPtr, uint32_t port, uint32_t pinMask, uint32_t val)
+{
+	uint32_t regNo;
+	uint32_t pin;
+
+	/* Each port is controlled by two registers (lower and upper 16 pins) */
+	for (regNo = 0; regNo < 2; regNo++)
+	{
+		uint32_t pins = pinMask >> (regNo * GPIO_PINS_PER_PINREG);
+		uint32_t clearMask = 0;
+		uint32_t setMask = 0;
+
+		for (pin = 0; pin < GPIO_PINS_PER_PINREG; pin++)
+		{
+			if (pins & (((uint32_t)1) << pin))
+			{
+				clearMask |= 0x3u << (pin * 2);
+				setMask |= (val & 0x3u) << (pin * 2);
+			}
+		}
+
+		if (clearMask != 0)
+		{
+			reg32_t* reg = &regPtr[port * 2 + regNo];
+
+			*reg = (*reg & ~clearMask) | setMask;
+		}
+	}
+}
+
+/**
+ * Checks whether a pin can generate interrupt.
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ *
+ * @return true if pin can generate interrupt
+ */
+PRIVATE bool IsInterruptPin(uint32_t port, uint32_t pin)
+{
+	uint32_t pinMask;
+
+	if (pin >= GPIO_NUM_OF_PINS_PER_PORT)
+	{
+		return false;
+	}
+
+	pinMask = ((uint32_t)1) << pin;
+
+	if (port == 0)
+	{
+		return (GPIO_INT_PORT0_PIN_MASK & pinMask) != 0;
+	}
+	else if (port == 2)
+	{
+		return (GPIO_INT_PORT2_PIN_MASK & pinMask) != 0;
+	}
+
+	return false;
+}
+
+/**
+ * Handles pending edges of a port.
+ *
+ * @param portIndex Interrupt Port Index
+ *
+ * @return none
+ */
+PRIVATE void HandlePortInterrupt(uint32_t portIndex)
+{
+	GPIOIntPortRegisters* regs = GPIO_INT_PORT_REGS(portIndex);
+	uint32_t port = portIndex * 2;
+	uint32_t rising = regs->IntStatR;
+	uint32_t falling = regs->IntStatF;
+	uint32_t pins = rising | falling;
+	uint32_t pin;
+
+	/* Clear before callbacks so new edges are latched again */
+	regs->IntClr = pins;
+
+	for (pin = 0; pins != 0; pin++, pins >>= 1)
+	{
+		Drv_GPIO_InterruptCallback callback = pinCallbacks[portIndex][pin];
+		uint32_t pinMask = ((uint32_t)1) << pin;
+
+		if (((pins & 1) == 0) || (callback == NULL))
+		{
+			continue;
+		}
+
+		if (rising & pinMask)
+		{
+			callback(port, pin, DRV_GPIO_EDGE_RISING);
+		}
+
+		if (falling & pinMask)
+		{
+			callback(port, pin, DRV_GPIO_EDGE_FALLING);
+		}
+	}
+}
+
+/**
+ * ISR Function for GPIO Interrupts (shared EINT3 vector)
+ */
+INTERNAL void POS_GPIO_IRQHandler(void)
+{
+	uint32_t intStatus = LPC_GPIOINT->IntStatus;
+
+	if (intStatus & GPIO_INT_STATUS_PORT0)
+	{
+		HandlePortInterrupt(GPIO_INT_PORT_INDEX(0));
+	}
+
+	if (intStatus & GPIO_INT_STATUS_PORT2)
+	{
+		HandlePortInterrupt(GPIO_INT_PORT_INDEX(2));
+	}
+}
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+/**
+ * ISR Function for GPIO Interrupts when only Port 0 pins are enabled
+ */
+PRIVATE void GPIO_Port0IRQHandler(void)
+{
+	HandlePortInterrupt(GPIO_INT_PORT_INDEX(0));
+}
+
+/**
+ * ISR Function for GPIO Interrupts when only Port 2 pins are enabled
+ */
+PRIVATE void GPIO_Port2IRQHandler(void)
+{
+	HandlePortInterrupt(GPIO_INT_PORT_INDEX(2));
+}
+
+/**
+ * Installs handler of enabled ports into RAM Vector Table so shared status
+ * is not dispatched when a single port uses interrupts.
+ *  Must be called while EINT3 interrupt is disabled.
+ *
+ * @param none
+ *
+ * @return none
+ */
+PRIVATE void InstallIRQHandler(void)
+{
+	GPIOIntPortRegisters* port0 = GPIO_INT_PORT_REGS(GPIO_INT_PORT_INDEX(0));
+	GPIOIntPortRegisters* port2 = GPIO_INT_PORT_REGS(GPIO_INT_PORT_INDEX(2));
+	bool port0Enabled = (port0->IntEnR | port0->IntEnF) != 0;
+	bool port2Enabled = (port2->IntEnR | port2->IntEnF) != 0;
+	IRQHandler handler = POS_GPIO_IRQHandler;
+
+	if (port0Enabled && !port2Enabled)
+	{
+		handler = GPIO_Port0IRQHandler;
+	}
+	else if (port2Enabled && !port0Enabled)
+	{
+		handler = GPIO_Port2IRQHandler;
+	}
+
+	(void)Drv_CPUCore_SetIRQHandler(EINT3_IRQn, handler);
+}
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
 /***************************** PUBLIC FUNCTIONS *******************************/
 /**
  * Initializes GPIO Driver.
@@ -132,6 +467,49 @@ void Drv_GPIO_ConfigurePin(uint32_t port, uint32_t pin, uint32_t functionNo, uin
 	SetPinMode(port, pin, driveMode);
 }
 
+/**
+ * Gets active Function of a pin
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ *
+ * @return Function of pin
+ */
+uint32_t Drv_GPIO_GetPinFunction(uint32_t port, uint32_t pin)
+{
+	/* Same register layout with SetPinRegister() */
+	uint32_t pinOffset = pin * 2;
+	uint32_t pinsel = (&LPC_PINCON->PINSEL0)[port * 2 + (pinOffset / 32)];
+
+	return (pinsel >> (pinOffset % 32)) & 0x3;
+}
+
+/**
+ * Gets peripheral of an alternate pin function
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ * @param functionNo Alternate Function of pin
+ *
+ * @return Peripheral or RESULT_FAIL
+ */
+int32_t Drv_GPIO_GetPinPeripheral(uint32_t port, uint32_t pin, uint32_t functionNo)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(pinPeripherals) / sizeof(pinPeripherals[0]); i++)
+	{
+		if ((pinPeripherals[i].port == port) &&
+			(pinPeripherals[i].pin == pin) &&
+			(pinPeripherals[i].functionNo == functionNo))
+		{
+			return (int32_t)pinPeripherals[i].peripheral;
+		}
+	}
+
+	return RESULT_FAIL;
+}
+
 /**
  * Writes state to Output Pin
  *
@@ -164,14 +542,16 @@ void Drv_GPIO_WritePin(uint32_t port, uint32_t pin, Drv_GPIO_PinState newState)
 }
 
 /**
- * Reads State of Input Pin
+ * Reads State of Pin
+ *  Direction is not changed, pin must be configured as input before (see
+ *  Drv_GPIO_SetPortDirection). State of an output pin is its output value.
  *
  * @param port Port Number of IO
  * @param pin Pin Number of IO
  *
  * @return returns state (High or Low) of Pin
  */
-Drv_GPIO_PinState GPIO_ReadPin(uint32_t port, uint32_t pin)
+Drv_GPIO_PinState Drv_GPIO_ReadPin(uint32_t port, uint32_t pin)
 {
 	/* Get Mask for Pin */
     uint32_t pinMask = ((uint32_t)1)<<pin;
@@ -179,11 +559,232 @@ Drv_GPIO_PinState GPIO_ReadPin(uint32_t port, uint32_t pin)
     LPC_GPIO_TypeDef* regGPIO = &LPC_GPIO0[port];
     uint32_t pinState;
 
-    /* Set Pin as input */
-    regGPIO->FIODIR &= ~pinMask;
-
     /* Get Pin State */
     pinState = (uint32_t)(((regGPIO->FIOPIN & pinMask) == 0) ? 0 : 1);
 
     return (Drv_GPIO_PinState)pinState;
 }
+
+/**
+ * Configures multiple pins for Function and Drive Mode
+ *
+ * @param port Port Number of IOs
+ * @param pinMask Pins to configure
+ * @param functionNo to be set Function
+ * @param driveMode to be set Drive Mode
+ *
+ * @return none
+ */
+void Drv_GPIO_ConfigurePort(uint32_t port, uint32_t pinMask, uint32_t functionNo, uint32_t driveMode)
+{
+	SetPortRegister(&LPC_PINCON->PINSEL0, port, pinMask, functionNo);
+	SetPortRegister(&LPC_PINCON->PINMODE0, port, pinMask, driveMode);
+}
+
+/**
+ * Sets direction of multiple pins
+ *
+ * @param port Port Number of IOs
+ * @param pinMask Pins to set direction
+ * @param direction new direction (Input/Output) of IOs
+ *
+ * @return none
+ */
+void Drv_GPIO_SetPortDirection(uint32_t port, uint32_t pinMask, Drv_GPIO_Direction direction)
+{
+    LPC_GPIO_TypeDef* regGPIO = &LPC_GPIO0[port];
+
+    if (direction == DRV_GPIO_DIRECTION_OUTPUT)
+    {
+    	regGPIO->FIODIR |= pinMask;
+    }
+    else
+    {
+    	regGPIO->FIODIR &= ~pinMask;
+    }
+}
+
+/**
+ * Sets (High) multiple output pins by single store
+ *
+ * @param port Port Number of IOs
+ * @param pinMask Pins to set
+ *
+ * @return none
+ */
+void Drv_GPIO_SetPort(uint32_t port, uint32_t pinMask)
+{
+	/* Only 1 bits take effect so other pins are not touched */
+	LPC_GPIO0[port].FIOSET = pinMask;
+}
+
+/**
+ * Clears (Low) multiple output pins by single store
+ *
+ * @param port Port Number of IOs
+ * @param pinMask Pins to clear
+ *
+ * @return none
+ */
+void Drv_GPIO_ClearPort(uint32_t port, uint32_t pinMask)
+{
+	/* Only 1 bits take effect so other pins are not touched */
+	LPC_GPIO0[port].FIOCLR = pinMask;
+}
+
+/**
+ * Writes value to multiple output pins by single store
+ *
+ * @param port Port Number of IOs
+ * @param pinMask Pins to write
+ * @param value new output values of IOs
+ *
+ * @return none
+ */
+void Drv_GPIO_WritePort(uint32_t port, uint32_t pinMask, uint32_t value)
+{
+    LPC_GPIO_TypeDef* regGPIO = &LPC_GPIO0[port];
+
+    /*
+     * Masked pins (1 in FIOMASK) are not affected by FIOPIN write so
+     * all selected pins change at once.
+     */
+    regGPIO->FIOMASK = ~pinMask;
+    regGPIO->FIOPIN = value;
+    /* Restore mask to enable all pins again */
+    regGPIO->FIOMASK = 0;
+}
+
+/**
+ * Reads states of all pins of a port
+ *
+ * @param port Port Number of IOs
+ *
+ * @return states of pins (bit n for pin n)
+ */
+uint32_t Drv_GPIO_ReadPort(uint32_t port)
+{
+	return LPC_GPIO0[port].FIOPIN;
+}
+
+/**
+ * Gets Bit-Band alias of a pin.
+ *  Cortex-M3 maps each bit of GPIO registers to a word in alias region so a
+ *  pin is written or read by single store or load instruction and without
+ *  read-modify-write on whole port.
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ *
+ * @return Alias of pin in FIOPIN register
+ */
+Drv_GPIO_PinAlias Drv_GPIO_GetPinAlias(uint32_t port, uint32_t pin)
+{
+	uint32_t regAddr = (uint32_t)(uintptr_t)&LPC_GPIO0[port].FIOPIN;
+
+#if !DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+	/* Alias window is not mapped for unprivileged code */
+	DEBUG_ASSERT_MESSAGE((__get_IPSR() != 0) || ((__get_CONTROL() & CONTROL_nPRIV_Msk) == 0),
+						 "Pin Aliases are privileged only!");
+#endif /* !DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION */
+
+	return (Drv_GPIO_PinAlias)(uintptr_t)GPIO_BITBAND_ALIAS(regAddr, pin);
+}
+
+/**
+ * Enables edge interrupt of a pin
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ * @param edges Edges to detect
+ * @param callback Interrupt Callback
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+int32_t Drv_GPIO_EnableInterrupt(uint32_t port, uint32_t pin, Drv_GPIO_Edge edges,
+								 Drv_GPIO_InterruptCallback callback)
+{
+	uint32_t pinMask = ((uint32_t)1) << pin;
+	uint32_t portIndex = GPIO_INT_PORT_INDEX(port);
+	GPIOIntPortRegisters* regs;
+
+	if (!IsInterruptPin(port, pin) || (callback == NULL) ||
+		((edges & DRV_GPIO_EDGE_BOTH) == 0))
+	{
+		return RESULT_FAIL;
+	}
+
+	regs = GPIO_INT_PORT_REGS(portIndex);
+
+	/* ISR must not see a half updated pin */
+	NVIC_DisableIRQ(EINT3_IRQn);
+
+	pinCallbacks[portIndex][pin] = callback;
+
+	if (edges & DRV_GPIO_EDGE_RISING)
+	{
+		regs->IntEnR |= pinMask;
+	}
+	else
+	{
+		regs->IntEnR &= ~pinMask;
+	}
+
+	if (edges & DRV_GPIO_EDGE_FALLING)
+	{
+		regs->IntEnF |= pinMask;
+	}
+	else
+	{
+		regs->IntEnF &= ~pinMask;
+	}
+
+	/* Discard edges which are latched with previous settings */
+	regs->IntClr = pinMask;
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+	InstallIRQHandler();
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+	Drv_CPUCore_SetIRQPriority(EINT3_IRQn, DRV_CONFIG_GPIO_PRIORITY, 0);
+	NVIC_EnableIRQ(EINT3_IRQn);
+
+	return RESULT_SUCCESS;
+}
+
+/**
+ * Disables edge interrupt of a pin
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ *
+ * @return none
+ */
+void Drv_GPIO_DisableInterrupt(uint32_t port, uint32_t pin)
+{
+	uint32_t pinMask = ((uint32_t)1) << pin;
+	uint32_t portIndex = GPIO_INT_PORT_INDEX(port);
+	GPIOIntPortRegisters* regs;
+
+	if (!IsInterruptPin(port, pin))
+	{
+		return;
+	}
+
+	regs = GPIO_INT_PORT_REGS(portIndex);
+
+	NVIC_DisableIRQ(EINT3_IRQn);
+
+	regs->IntEnR &= ~pinMask;
+	regs->IntEnF &= ~pinMask;
+	regs->IntClr = pinMask;
+
+	pinCallbacks[portIndex][pin] = NULL;
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+	InstallIRQHandler();
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+	/* Other pins may still use interrupt */
+	NVIC_EnableIRQ(EINT3_IRQn);
+}
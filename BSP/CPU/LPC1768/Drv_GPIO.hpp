@@ -0,0 +1,322 @@
+/*******************************************************************************
+ *
+ * @file Drv_GPIO.hpp
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief Compile Time GPIO Binding (C++ Layer over GPIO Driver)
+ *
+ *		  Header only C++ (C++98) layer for LPC17xx GPIO. Port and pin numbers
+ *		  are template parameters so register addresses, pin masks and bit-band
+ *		  aliases are compile time constants. Each access compiles to one or
+ *		  two register instructions without any run-time table lookup (e.g.
+ *		  LPC_GPIO0[port] indexing of C API).
+ *
+ *		  Configuration (function, drive mode, interrupts) is still done by C
+ *		  API so C and C++ clients can share same pins. A board file can move
+ *		  to C++ step by step:
+ *
+ *			typedef Drv::GPIOPin<2, 0> Led0;
+ *
+ *			Led0::SetOutput();
+ *			Led0::High();
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __DRV_GPIO_HPP
+#define __DRV_GPIO_HPP
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_GPIO.h"
+
+#include "LPC17xx.h"
+
+#include <stddef.h>
+
+#include "DRVConfig.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Single pin accesses use Bit-Band aliases only if alias window is mapped
+ * for unprivileged applications (a common virtual MPU region). Otherwise
+ * they use port set, clear and pin registers.
+ */
+#ifndef DRV_GPIO_USE_PIN_ALIASES
+#define DRV_GPIO_USE_PIN_ALIASES			DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION
+#endif /* DRV_GPIO_USE_PIN_ALIASES */
+
+/*
+ * Compile Time Check for C++98 (no static_assert).
+ *  Fails with a negative array size if condition is false.
+ */
+#ifndef DRV_STATIC_CHECK
+#define DRV_STATIC_CHECK(condition, name)	typedef char name[(condition) ? 1 : -1] __attribute__((unused))
+#endif /* DRV_STATIC_CHECK */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+namespace Drv
+{
+
+/* Number of GPIO ports of LPC17xx */
+const uint32_t GPIO_NUM_OF_PORTS = 5;
+
+/* Number of pins of a GPIO port */
+const uint32_t GPIO_NUM_OF_PINS = 32;
+
+/* Address distance between register blocks of two ports */
+const uint32_t GPIO_PORT_REGS_SIZE = (LPC_GPIO1_BASE - LPC_GPIO0_BASE);
+
+/* GPIO registers are in Bit-Band region of AHB SRAM */
+const uint32_t GPIO_BITBAND_REGION_BASE = 0x20000000;
+const uint32_t GPIO_BITBAND_ALIAS_BASE = 0x22000000;
+
+/*
+ * GPIO Port
+ *  Pins of port are selected by a mask (bit n is pin n) and each operation is
+ *  a single register store (see port-wide operations in Drv_GPIO.h).
+ */
+template <uint32_t PortNo>
+class GPIOPort
+{
+	DRV_STATIC_CHECK(PortNo < GPIO_NUM_OF_PORTS, GPIO_Port_Number_Is_Out_Of_Range);
+
+public:
+	/* Register Block Address of port */
+	static const uint32_t BaseAddress = LPC_GPIO0_BASE + (PortNo * GPIO_PORT_REGS_SIZE);
+
+	/* Register Block of port */
+	static LPC_GPIO_TypeDef* Registers(void)
+	{
+		return (LPC_GPIO_TypeDef*)BaseAddress;
+	}
+
+	/* Sets direction of pins in mask */
+	static void SetDirection(uint32_t pinMask, Drv_GPIO_Direction direction)
+	{
+		if (direction == DRV_GPIO_DIRECTION_OUTPUT)
+		{
+			Registers()->FIODIR |= pinMask;
+		}
+		else
+		{
+			Registers()->FIODIR &= ~pinMask;
+		}
+	}
+
+	/* Sets (High) output pins in mask */
+	static void Set(uint32_t pinMask)
+	{
+		Registers()->FIOSET = pinMask;
+	}
+
+	/* Clears (Low) output pins in mask */
+	static void Clear(uint32_t pinMask)
+	{
+		Registers()->FIOCLR = pinMask;
+	}
+
+	/*
+	 * Writes value to output pins in mask at once.
+	 *  Uses port mask register so port must not be accessed from an interrupt
+	 *  at the same time.
+	 */
+	static void Write(uint32_t pinMask, uint32_t value)
+	{
+		Registers()->FIOMASK = ~pinMask;
+		Registers()->FIOPIN = value;
+		Registers()->FIOMASK = 0;
+	}
+
+	/* Reads all pins of port */
+	static uint32_t Read(void)
+	{
+		return Registers()->FIOPIN;
+	}
+};
+
+/*
+ * Group of pins in same port.
+ *  Pin Mask is also a template parameter so even masks are not loaded at
+ *  run-time (e.g. LED banks or parallel buses).
+ */
+template <uint32_t PortNo, uint32_t PinMask>
+class GPIOPins
+{
+	typedef GPIOPort<PortNo> Port;
+
+public:
+	/* Pins of group */
+	static const uint32_t Mask = PinMask;
+
+	/* Configures function and drive mode of all pins */
+	static void Configure(uint32_t functionNo, uint32_t driveMode)
+	{
+		Drv_GPIO_ConfigurePort(PortNo, Mask, functionNo, driveMode);
+	}
+
+	static void SetOutput(void)
+	{
+		Port::SetDirection(Mask, DRV_GPIO_DIRECTION_OUTPUT);
+	}
+
+	static void SetInput(void)
+	{
+		Port::SetDirection(Mask, DRV_GPIO_DIRECTION_INPUT);
+	}
+
+	/* Sets (High) all pins of group */
+	static void Set(void)
+	{
+		Port::Set(Mask);
+	}
+
+	/* Clears (Low) all pins of group */
+	static void Clear(void)
+	{
+		Port::Clear(Mask);
+	}
+
+	/* Writes value (bit n for pin n) to pins of group at once */
+	static void Write(uint32_t value)
+	{
+		Port::Write(Mask, value);
+	}
+
+	/* Reads pins of group (bit n for pin n, other bits are zero) */
+	static uint32_t Read(void)
+	{
+		return Port::Read() & Mask;
+	}
+};
+
+/*
+ * Single GPIO Pin.
+ *  Single pin writes and reads use Bit-Band alias of pin so they are single
+ *  store or load instructions to a constant address (see 
+ *  DRV_GPIO_USE_PIN_ALIASES).
+ */
+template <uint32_t PortNo, uint32_t PinNo>
+class GPIOPin
+{
+	DRV_STATIC_CHECK(PinNo < GPIO_NUM_OF_PINS, GPIO_Pin_Number_Is_Out_Of_Range);
+
+	typedef GPIOPort<PortNo> Port;
+
+public:
+	/* Mask of pin in port registers */
+	static const uint32_t Mask = ((uint32_t)1) << PinNo;
+
+	/* Bit-Band alias address of pin in FIOPIN register */
+	static const uint32_t AliasAddress =
+			GPIO_BITBAND_ALIAS_BASE +
+			((Port::BaseAddress + offsetof(LPC_GPIO_TypeDef, FIOPIN) - GPIO_BITBAND_REGION_BASE) * 32) +
+			(PinNo * 4);
+
+	/* Bit-Band alias of pin */
+	static Drv_GPIO_PinAlias Alias(void)
+	{
+		return (Drv_GPIO_PinAlias)AliasAddress;
+	}
+
+	/* Configures function and drive mode of pin */
+	static void Configure(uint32_t functionNo, uint32_t driveMode)
+	{
+		Drv_GPIO_ConfigurePin(PortNo, PinNo, functionNo, driveMode);
+	}
+
+	static void SetOutput(void)
+	{
+		Port::SetDirection(Mask, DRV_GPIO_DIRECTION_OUTPUT);
+	}
+
+	static void SetInput(void)
+	{
+		Port::SetDirection(Mask, DRV_GPIO_DIRECTION_INPUT);
+	}
+
+	/* Sets (High) pin */
+	static void High(void)
+	{
+		Port::Set(Mask);
+	}
+
+	/* Clears (Low) pin */
+	static void Low(void)
+	{
+		Port::Clear(Mask);
+	}
+
+#if DRV_GPIO_USE_PIN_ALIASES
+	/* Writes state of pin */
+	static void Write(Drv_GPIO_PinState state)
+	{
+		*Alias() = (uint32_t)state;
+	}
+
+	/* Reads state of pin */
+	static Drv_GPIO_PinState Read(void)
+	{
+		return (Drv_GPIO_PinState)(*Alias());
+	}
+
+	/* Toggles pin using one load and one store */
+	static void Toggle(void)
+	{
+		*Alias() = *Alias() ^ 1;
+	}
+#else
+	/* Writes state of pin */
+	static void Write(Drv_GPIO_PinState state)
+	{
+		if (state == DRV_GPIO_PINSTATE_LOW)
+		{
+			Port::Clear(Mask);
+		}
+		else
+		{
+			Port::Set(Mask);
+		}
+	}
+
+	/* Reads state of pin */
+	static Drv_GPIO_PinState Read(void)
+	{
+		return (Drv_GPIO_PinState)((Port::Read() >> PinNo) & 1);
+	}
+
+	/* Toggles pin using one load and one store (to set or clear register) */
+	static void Toggle(void)
+	{
+		Write((Drv_GPIO_PinState)(Read() ^ 1));
+	}
+#endif /* DRV_GPIO_USE_PIN_ALIASES */
+
+	/* Enables edge interrupt of pin (only Port 0 and Port 2 pins) */
+	static int32_t EnableInterrupt(Drv_GPIO_Edge edges, Drv_GPIO_InterruptCallback callback)
+	{
+		return Drv_GPIO_EnableInterrupt(PortNo, PinNo, edges, callback);
+	}
+
+	/* Disables edge interrupt of pin */
+	static void DisableInterrupt(void)
+	{
+		Drv_GPIO_DisableInterrupt(PortNo, PinNo);
+	}
+};
+
+} /* namespace Drv */
+
+#endif	/* __DRV_GPIO_HPP */
@@ -12,6 +12,26 @@
  *			Timer resolution is 1 microsecond so clock dividers and prescale
  *			values are set according to this resolution.
  *
+ *			A HW Timer can also be created as free running timer. In this
+ *			mode, Timer Counter is never resetted or stopped and each of four
+ *			match registers (MR0~MR3) is used as an independent one shot
+ *			channel with its own callback. Channel timeouts are relative to
+ *			the same counter so four precise timeouts can run on single HW
+ *			Timer without SW multiplexing.
+ *
+ *			A HW Timer can also be created as periodic timer. Counter is
+ *			resetted by HW on MR0 match (reset on match) so period is phase
+ *			stable and it does not depend on ISR latency. New period is
+ *			applied on next period boundary.
+ *
+ *			One free running timer can be selected as system wide Time Base.
+ *			Its resolution is selectable (down to PCLK cycles) and its 32 bit
+ *			counter is extended to 64 bits in SW using last channel (MR3).
+ *			MR3 matches on each half of counter range (0x80000000 and 0) and
+ *			ISR increments a half period (epoch) counter. Reader combines
+ *			epoch with MSB of counter so reading is lock-free and it is safe
+ *			in any context even if overflow interrupt is not served yet.
+ *
  *        TODO
  *			- Timer Power should be closed when device enter sleep (Low Power)
  *			- IMP : Check for Cost of Timer Enable/Disable for each time.
@@ -31,6 +51,7 @@
 
 /********************************* INCLUDES ***********************************/
 #include "Drv_Timer.h"
+#include "Drv_CPUCore.h"
 
 #include "LPC17xx.h"
 #include "lpc17xx_clkpwr.h"
@@ -62,6 +83,21 @@
 #error "Unsupported HW Timer Number. LPC17xx has just 4 HW Timer!"
 #endif
 
+/* Preempt Priorities of HW Timers (defaults are in Drv_Timer.h) */
+#if (DRV_CONFIG_TIMER_PRIORITY_HIGH > DRV_IRQ_LOWEST_PREEMPT_PRIORITY) || \
+	(DRV_CONFIG_TIMER_PRIORITY_NORMAL > DRV_IRQ_LOWEST_PREEMPT_PRIORITY) || \
+	(DRV_CONFIG_TIMER_PRIORITY_LOW > DRV_IRQ_LOWEST_PREEMPT_PRIORITY)
+#error "Timer priority is out of range of preempt priority bits!"
+#endif
+
+/*
+ * Low Priority callbacks use driver services (e.g. User Timers) so they must
+ * be masked by critical sections.
+ */
+#if !DRV_IRQ_IS_KERNEL_AWARE(DRV_CONFIG_TIMER_PRIORITY_LOW)
+#error "Low timer priority must not be higher than MAX_SYSCALL_INTERRUPT_PRIORITY!"
+#endif
+
 /* Just a wrapper for to be used timer number */
 #define NUM_OF_TIMERS						DRV_CONFIG_NUM_OF_USED_HW_TIMERS
 
@@ -120,6 +156,43 @@
  */
 #define TIMER_RESOLUTION_US					(1000000)
 
+/* Prescale Value (PR) for 1 us resolution. PR is PrescaleValue - 1 */
+#define TIMER_PRESCALE_US					((TIMER_PCLK_FREQUENCY / TIMER_RESOLUTION_US) - 1)
+
+/* Mask of match channel interrupt pendings */
+#define TIMER_MATCH_INT_PENDINGS_MASK \
+				TIM_IR_CLR(TIM_MR0_INT) | \
+				TIM_IR_CLR(TIM_MR1_INT) | \
+				TIM_IR_CLR(TIM_MR2_INT) | \
+				TIM_IR_CLR(TIM_MR3_INT)
+
+/*
+ * Minimum distance (in ticks) between Timer Counter and a match value.
+ *  If a channel match is requested too close to (or behind) counter, match
+ *  can be missed while register is written so channel is rearmed with this
+ *  distance.
+ */
+#define TIMER_CHANNEL_MIN_TICKS				(2)
+
+/* Channel which is reserved to extend Time Base counter */
+#define TIMER_TIME_BASE_CHANNEL				(DRV_TIMER_NUM_OF_CHANNELS - 1)
+
+/* Half of counter range. Time Base epoch is incremented on each half */
+#define TIMER_TIME_BASE_HALF_RANGE			(0x80000000UL)
+
+/*
+ * Maximum distance (in CPU cycles) of a predicted one shot match. Cycle 
+ * Counter wraps on 32 bits so farther matches are not predicted.
+ */
+#define TIMER_MAX_MATCH_CYCLES				(0x80000000UL)
+
+/* Timer Clock (PCLK) frequency */
+#define TIMER_PCLK_FREQUENCY				((SystemCoreClock) / (TIMER_CLK_DIV))
+
+/* Match Register of a channel. MR0~MR3 are consecutive registers */
+#define TIMER_MATCH_REGISTER(LPC_TIM, channel) \
+				((&(LPC_TIM)->MR0)[(channel)])
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*
@@ -139,6 +212,19 @@ typedef struct
     uint32_t PCONP_Value;
 } HWTimerInfo;
 
+/*
+ * Timer Modes
+ */
+typedef enum
+{
+	/* Single timeout on MR0, timer is resetted on start and stopped on match */
+	TIMER_MODE_ONE_SHOT,
+	/* Free running counter, each match register is a one shot channel */
+	TIMER_MODE_FREE_RUNNING,
+	/* Auto reload on MR0, timer is resetted by HW on match */
+	TIMER_MODE_PERIODIC
+} TimerMode;
+
 /*
  * Timer Object to provide SW Timer functionality.
  */
@@ -150,8 +236,38 @@ typedef struct
 	uint32_t validationKey;
 #endif /* TIMER_DEBUG_MODE */
 
-	/* Client callback function to inform client about Timer Timeout */
-	DrvTimerCallback callback;
+	/*
+	 * Client callback functions to inform client about Timer Timeout.
+	 *  One shot timers use only first channel (MR0).
+	 */
+	DrvTimerCallback callbacks[DRV_TIMER_NUM_OF_CHANNELS];
+	/*
+	 * Armed state of free running timer channels.
+	 *  Each channel has its own flag (instead of a bit mask) so ISR and
+	 *  clients can update them without a read-modify-write race.
+	 */
+	volatile uint8_t armed[DRV_TIMER_NUM_OF_CHANNELS];
+	/* Mode of Timer */
+	TimerMode mode;
+	/*
+	 * Period (in us) to be applied on next period boundary of a periodic
+	 * timer. Zero if there is no pending period change.
+	 */
+	volatile uint32_t nextPeriod;
+	/*
+	 * Tick (prescaled counter) frequency in Hz. Kept to recalculate
+	 * prescaler when CPU Clock is changed.
+	 */
+	uint32_t frequency;
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	/*
+	 * Expected match time (Cycle Counter) of a one shot timer. Counter is
+	 * stopped on match so latency cannot be taken from counter.
+	 */
+	uint32_t matchCycle;
+	/* false if match is too far to predict, its latency is not recorded */
+	bool matchCycleValid;
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
 	/* Reference to HW Objects (e.g. Registers) */
 	const HWTimerInfo* hwTimerInfo;
 } Timer;
@@ -159,8 +275,24 @@ typedef struct
 /**************************** FUNCTION PROTOTYPES *****************************/
 PRIVATE void TIMER_IRQHandler(TimerNo timerNo);
 
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+PRIVATE void RecordIRQLatency(TimerNo timerNo, uint32_t pendings);
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 /******************************** VARIABLES ***********************************/
 
+/* Free running timer which is used as system wide Time Base */
+PRIVATE Timer* timeBase;
+
+/*
+ * Half periods of Time Base counter. Incremented by only Time Base ISR.
+ *  64 bit time = (epoch / 2) << 32 | counter. See Drv_Timer_ReadTimeBase()
+ */
+PRIVATE volatile uint32_t timeBaseEpoch;
+
+/* Actual (prescaled) Time Base frequency in Hz */
+PRIVATE uint32_t timeBaseFrequency;
+
 /*
  * Information about Timer Hardwares.
  *  This container collects constant information about Timer Hardwares like
@@ -193,15 +325,16 @@ PRIVATE const HWTimerInfo HWTimers[] =
 PRIVATE Timer timers[NUM_OF_TIMERS];
 
 /*
- * Custom (Emprically Defined) IRQ Priorities for HW Timers
- * 		Cortex M3 NVIC allows priorities between 0~31
- *  	max = 0, min = 31
+ * Preempt Priorities of HW Timers
+ *  Low Priority is in range of interrupts which are masked by critical 
+ *  sections (see Drv_CPUCore_EnterCritical) so its callbacks can use 
+ *  driver services (e.g. User Timers).
  */
 PRIVATE const uint32_t timerIRQPriorities[] =
 {
-	3,		/* High Priority */
-	9,		/* Midd Priority */
-	15		/* Low Priority  */
+	DRV_CONFIG_TIMER_PRIORITY_HIGH,		/* High Priority */
+	DRV_CONFIG_TIMER_PRIORITY_NORMAL,	/* Midd Priority */
+	DRV_CONFIG_TIMER_PRIORITY_LOW		/* Low Priority  */
 };
 /**************************** PRIVATE FUNCTIONS *******************************/
 
@@ -246,6 +379,83 @@ INTERNAL void POS_TIMER3_IRQHandler(void)
 #endif /* #if NUM_OF_TIMERS > 3 */
 }
 
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+/*
+ * ISR Function for one shot Timers.
+ *  One shot timers use only first channel so there is no pending channel to
+ *  dispatch. Installed into RAM Vector Table instead of common ISR.
+ *
+ * @param timerNo Number of Timer interrupt source
+ */
+PRIVATE ALWAYS_INLINE void ONE_SHOT_TIMER_IRQHandler(TimerNo timerNo)
+{
+	Timer* timer = &timers[timerNo];
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	RecordIRQLatency(timerNo, TIM_IR_CLR(0));
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
+	/* Clear before callback so client can restart timer in its callback */
+	HWTimers[timerNo].LPC_TIM->IR = (uint32_t)TIM_IR_CLR(0);
+
+	if (timer->callbacks[0] != NULL)
+	{
+		timer->callbacks[0]();
+	}
+}
+
+PRIVATE void TIMER0_OneShotIRQHandler(void)
+{
+	ONE_SHOT_TIMER_IRQHandler(0);
+}
+
+#if NUM_OF_TIMERS > 1
+PRIVATE void TIMER1_OneShotIRQHandler(void)
+{
+	ONE_SHOT_TIMER_IRQHandler(1);
+}
+#endif /* #if NUM_OF_TIMERS > 1 */
+
+#if NUM_OF_TIMERS > 2
+PRIVATE void TIMER2_OneShotIRQHandler(void)
+{
+	ONE_SHOT_TIMER_IRQHandler(2);
+}
+#endif /* #if NUM_OF_TIMERS > 2 */
+
+#if NUM_OF_TIMERS > 3
+PRIVATE void TIMER3_OneShotIRQHandler(void)
+{
+	ONE_SHOT_TIMER_IRQHandler(3);
+}
+#endif /* #if NUM_OF_TIMERS > 3 */
+
+/*
+ * Handlers which are installed into RAM Vector Table for each mode.
+ */
+PRIVATE const IRQHandler oneShotIRQHandlers[] =
+{
+	TIMER0_OneShotIRQHandler,
+#if NUM_OF_TIMERS > 1
+	TIMER1_OneShotIRQHandler,
+#endif /* #if NUM_OF_TIMERS > 1 */
+#if NUM_OF_TIMERS > 2
+	TIMER2_OneShotIRQHandler,
+#endif /* #if NUM_OF_TIMERS > 2 */
+#if NUM_OF_TIMERS > 3
+	TIMER3_OneShotIRQHandler
+#endif /* #if NUM_OF_TIMERS > 3 */
+};
+
+PRIVATE const IRQHandler commonIRQHandlers[] =
+{
+	POS_TIMER0_IRQHandler,
+	POS_TIMER1_IRQHandler,
+	POS_TIMER2_IRQHandler,
+	POS_TIMER3_IRQHandler
+};
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
 /*
  * Comman ISR Function for all Timer Interrupts.
  *  While all ISR functions do same things on different HW Timer registers,
@@ -258,17 +468,141 @@ PRIVATE void TIMER_IRQHandler(TimerNo timerNo)
 {
     /* Get HW TIMER Pointer */
     LPC_TIM_TypeDef* LPC_TIM = HWTimers[timerNo].LPC_TIM;
+	Timer* timer = &timers[timerNo];
+	uint32_t pendings;
+	TimerChannel channel;
+
+	/* Take a snapshot of match pendings and dispatch them one by one */
+	pendings = LPC_TIM->IR & (TIMER_MATCH_INT_PENDINGS_MASK);
 
-	if ((LPC_TIM->IR) & TIM_IR_CLR(TIM_MR0_INT))
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	RecordIRQLatency(timerNo, pendings);
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
+	for (channel = 0; pendings != 0; channel++)
 	{
-		/* Inform external (client) module if interrupt source is true*/
-		timers[timerNo].callback();
+		if (pendings & TIM_IR_CLR(channel))
+		{
+			pendings &= ~TIM_IR_CLR(channel);
+
+			/*
+			 * Clear Interrupt Pending Flag before callback so client can
+			 * restart channel in its callback.
+			 */
+			LPC_TIM->IR = (uint32_t)TIM_IR_CLR(channel);
+
+			if (timer->mode == TIMER_MODE_FREE_RUNNING)
+			{
+				/*
+				 * Counter is not stopped so a stopped channel matches again
+				 * after counter wraps. Just ignore it.
+				 */
+				if (timer->armed[channel] == false)
+				{
+					continue;
+				}
+
+				/* Channels are one shot */
+				timer->armed[channel] = false;
+			}
+			else if (timer->mode == TIMER_MODE_PERIODIC)
+			{
+				/*
+				 * Counter is just resetted by HW and new period has started.
+				 * Apply requested period as soon as possible, new match value
+				 * must be set before counter reaches it.
+				 */
+				if (timer->nextPeriod != 0)
+				{
+					LPC_TIM->MR0 = timer->nextPeriod - 1;
+					timer->nextPeriod = 0;
+				}
+			}
+
+			/* Inform external (client) module if interrupt source is true*/
+			if (timer->callbacks[channel] != NULL)
+			{
+				timer->callbacks[channel]();
+			}
+		}
+	}
+}
 
-		/* Clear Interrupt Pending Flag */
-		LPC_TIM->IR = (uint32_t)TIM_IR_CLR(TIM_MR0_INT);
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Records latency of a Timer interrupt.
+ *  Earliest pending match defines latency. Free running and periodic 
+ *  counters keep counting after match so time since match is taken from 
+ *  counters (Resolution is one PCLK). 
+ *
+ * @param timerNo Number of Timer interrupt source
+ * @param pendings Pending match interrupts
+ */
+PRIVATE void RecordIRQLatency(TimerNo timerNo, uint32_t pendings)
+{
+	LPC_TIM_TypeDef* LPC_TIM = HWTimers[timerNo].LPC_TIM;
+	Timer* timer = &timers[timerNo];
+	uint32_t counter = LPC_TIM->TC;
+	uint32_t prescaleCounter = LPC_TIM->PC;
+	uint32_t cyclesPerTick = (LPC_TIM->PR + 1) * TIMER_CLK_DIV;
+	uint32_t latency = 0;
+	uint32_t elapsed;
+	TimerChannel channel;
+
+	if (timer->mode == TIMER_MODE_ONE_SHOT)
+	{
+		if (!timer->matchCycleValid)
+		{
+			return;
+		}
+
+		latency = Drv_CPUCore_ReadCycleCounter() - timer->matchCycle;
+	}
+	else if (timer->mode == TIMER_MODE_PERIODIC)
+	{
+		/* Counter is resetted on next tick after match */
+		latency = (counter + 1) * cyclesPerTick + prescaleCounter * TIMER_CLK_DIV;
+	}
+	else
+	{
+		for (channel = 0; channel < DRV_TIMER_NUM_OF_CHANNELS; channel++)
+		{
+			/* Matches of stopped channels are ignored by ISR */
+			if ((pendings & TIM_IR_CLR(channel)) && timer->armed[channel])
+			{
+				elapsed = (counter - TIMER_MATCH_REGISTER(LPC_TIM, channel)) * cyclesPerTick + 
+						  prescaleCounter * TIMER_CLK_DIV;
+
+				if (elapsed > latency)
+				{
+					latency = elapsed;
+				}
+			}
+		}
 	}
+
+	Drv_CPUCore_RecordIRQLatency((int32_t)TIMER0_IRQn + (int32_t)timerNo, latency);
 }
 
+/*
+ * Predicts match time (Cycle Counter) of a running one shot timer.
+ *  Prediction is based on remaining ticks of timer itself so it must be 
+ *  repeated when CPU Clock (cycles per tick) is changed.
+ *
+ * @param timer One shot timer
+ */
+PRIVATE void PredictMatchCycle(Timer* timer)
+{
+	LPC_TIM_TypeDef* LPC_TIM = timer->hwTimerInfo->LPC_TIM;
+	uint32_t cyclesPerTick = (LPC_TIM->PR + 1) * TIMER_CLK_DIV;
+	uint32_t remainingTicks = LPC_TIM->MR0 - LPC_TIM->TC;
+
+	timer->matchCycleValid = (remainingTicks < (TIMER_MAX_MATCH_CYCLES / cyclesPerTick));
+	timer->matchCycle = Drv_CPUCore_ReadCycleCounter() + 
+						remainingTicks * cyclesPerTick - LPC_TIM->PC * TIMER_CLK_DIV;
+}
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 /*
  * Set Timer Match Value to fire an Interrupt.
  */
@@ -288,12 +622,65 @@ PRIVATE ALWAYS_INLINE void StartTimer(LPC_TIM_TypeDef* LPC_TIM, uint32_t timeout
     LPC_TIM->TCR |= TIM_ENABLE;
 }
 
+/*
+ * Arms a channel of a free running timer to match at specified tick.
+ *
+ * @param timer Free running timer
+ * @param channel Channel (Match Register) to be armed
+ * @param tick Absolute Timer Counter value to match
+ */
+PRIVATE void ArmChannel(Timer* timer, TimerChannel channel, uint32_t tick)
+{
+	LPC_TIM_TypeDef* LPC_TIM = timer->hwTimerInfo->LPC_TIM;
+
+	/* Disarm first so ISR ignores an old match while we are updating */
+	timer->armed[channel] = false;
+
+	TIMER_MATCH_REGISTER(LPC_TIM, channel) = tick;
+
+	/* Drop pending match of previous value */
+	LPC_TIM->IR = (uint32_t)TIM_IR_CLR(channel);
+
+	timer->armed[channel] = true;
+
+	/*
+	 * Counter may pass match value while we are writing registers (or tick is
+	 * already behind counter). In this case match is lost until counter wraps
+	 * so rearm channel just after counter.
+	 *
+	 * Signed difference is used to be safe on counter wrap. Timeouts must be
+	 * lower than half of counter range.
+	 */
+	while (((int32_t)(LPC_TIM->TC - TIMER_MATCH_REGISTER(LPC_TIM, channel)) >= 0) &&
+		   ((LPC_TIM->IR & TIM_IR_CLR(channel)) == 0))
+	{
+		TIMER_MATCH_REGISTER(LPC_TIM, channel) = LPC_TIM->TC + TIMER_CHANNEL_MIN_TICKS;
+	}
+}
+
+/*
+ * Handles half period match of Time Base counter.
+ *  Next match is set to other half of counter range.
+ */
+PRIVATE void TimeBaseEpochHandler(void)
+{
+	uint32_t epoch = timeBaseEpoch + 1;
+
+	timeBaseEpoch = epoch;
+
+	/* Odd epoch means counter is in upper half so next match is on wrap */
+	ArmChannel(timeBase, TIMER_TIME_BASE_CHANNEL,
+			   (epoch & 1) ? 0 : TIMER_TIME_BASE_HALF_RANGE);
+}
+
 /*
  * Initializes selected HW Timer.
  *
  * @param hwTimerInfo object which keeps hw specific information
+ * @param mode Timer mode
+ * @param prescale Prescale Value. TC is incremented on each prescale + 1 PCLK
  */
-PRIVATE ALWAYS_INLINE void InitializeHWTimer(const HWTimerInfo* hwTimerInfo)
+PRIVATE ALWAYS_INLINE void InitializeHWTimer(const HWTimerInfo* hwTimerInfo, TimerMode mode, uint32_t prescale)
 {
     /* Get HW Timer Register Address */
     LPC_TIM_TypeDef* LPC_TIM = hwTimerInfo->LPC_TIM;
@@ -331,32 +718,69 @@ PRIVATE ALWAYS_INLINE void InitializeHWTimer(const HWTimerInfo* hwTimerInfo)
 	 *
 	 * PR should be set to PrescaleValue - 1
 	 */
-    LPC_TIM->PR = ((SystemCoreClock) / (TIMER_CLK_DIV * TIMER_RESOLUTION_US)) - 1;
+    LPC_TIM->PR = prescale;
 
 	/* Clear all interrupt pendings */
 	LPC_TIM->IR = (uint32_t)TIMER_CLEAR_ALL_INT_PENDINGS_MASK;
 
-    /*
-	 * Set match register.
-	 *  - Just interrupt on match
-	 *  - Stop on match. This is because we are one shot timer.
-	 *  - No reset on match
-	 */
-	LPC_TIM->MCR &=~TIM_MCR_CHANNEL_MASKBIT(0);  /* Clear first */
-    LPC_TIM->MCR |= TIM_INT_ON_MATCH(0) | TIM_STOP_ON_MATCH(0);
+	if (mode == TIMER_MODE_ONE_SHOT)
+	{
+		/*
+		 * Set match register.
+		 *  - Just interrupt on match
+		 *  - Stop on match. This is because we are one shot timer.
+		 *  - No reset on match
+		 */
+		LPC_TIM->MCR &=~TIM_MCR_CHANNEL_MASKBIT(0);  /* Clear first */
+		LPC_TIM->MCR |= TIM_INT_ON_MATCH(0) | TIM_STOP_ON_MATCH(0);
+	}
+	else if (mode == TIMER_MODE_PERIODIC)
+	{
+		/*
+		 * Set match register.
+		 *  - Interrupt on match
+		 *  - Reset on match. HW reloads counter so period has no SW jitter.
+		 *  - No stop on match
+		 */
+		LPC_TIM->MCR &=~TIM_MCR_CHANNEL_MASKBIT(0);  /* Clear first */
+		LPC_TIM->MCR |= TIM_INT_ON_MATCH(0) | TIM_RESET_ON_MATCH(0);
+	}
+	else
+	{
+		/*
+		 * Free running timer
+		 *  - Interrupt on match for all channels. Channels are armed in SW.
+		 *  - No reset and stop on match so counter is never disturbed.
+		 */
+		LPC_TIM->MCR = TIM_INT_ON_MATCH(0) | TIM_INT_ON_MATCH(1) |
+					   TIM_INT_ON_MATCH(2) | TIM_INT_ON_MATCH(3);
+
+		/* Match registers keep reset value (0) until channels are armed */
+		LPC_TIM->MR0 = 0;
+		LPC_TIM->MR1 = 0;
+		LPC_TIM->MR2 = 0;
+		LPC_TIM->MR3 = 0;
+
+		/* Counter runs from now on */
+		LPC_TIM->TCR |= TIM_ENABLE;
+	}
 }
 
-/***************************** PUBLIC FUNCTIONS *******************************/
 /*
- * Creates a SW Timer which matches with a HW Timer.
+ * Acquires a HW Timer and initializes it in specified mode.
  *
- *  There is no special note about internal implementation details.
- *  See header files to function description.
+ * @param timerNo HW Timer Number
+ * @param priority Timer Priority
+ * @param mode Timer Mode
+ * @param prescale Prescale Value (PR) of HW Timer
+ *
+ * @return Initialized Timer Object
  */
-PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
+PRIVATE Timer* CreateTimer(TimerNo timerNo, DrvTimerPriority priority, TimerMode mode, uint32_t prescale)
 {
 	Timer* timer;
 	IRQn_Type timerIRQNo;
+	TimerChannel channel;
 
 	/* Internal Checks for debug mode */
 	DEBUG_ASSERT_MESSAGE((timerNo < NUM_OF_HW_TIMERS), "Invalid Timer No!");
@@ -370,21 +794,35 @@ PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority,
 	/* Rest of internal checks */
 	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer) == 0, "Timer is already assigned before!");
 	DEBUG_ASSERT_MESSAGE((priority < DRV_TIMER_PRI_NUM), "Invalid Timer Priority!");
-	DEBUG_ASSERT_MESSAGE(timerCallback != NULL, "Invalid (NULL) Callback!");
 
-	/* Save Client Callback to call in case of timer timeout */
-	timer->callback = timerCallback;
+	/* No client callback and armed channel yet */
+	for (channel = 0; channel < DRV_TIMER_NUM_OF_CHANNELS; channel++)
+	{
+		timer->callbacks[channel] = NULL;
+		timer->armed[channel] = false;
+	}
+
+	timer->mode = mode;
+	timer->nextPeriod = 0;
+	timer->frequency = TIMER_PCLK_FREQUENCY / (prescale + 1);
 	/* Link HW Info with Timer Objects */
 	timer->hwTimerInfo = &HWTimers[timerNo];
 
 	/* Initialize Timer HW Block for selected HW Timer */
-    InitializeHWTimer(timer->hwTimerInfo);
+    InitializeHWTimer(timer->hwTimerInfo, mode, prescale);
 
 	/* Calculate Timer IRQ Num. For LPC17xx all of them are sequential */
 	timerIRQNo = (IRQn_Type)(TIMER0_IRQn + timerNo);
 
 	/* Set interrupt priority using client's priority request */
-	NVIC_SetPriority(timerIRQNo, timerIRQPriorities[priority]);
+	Drv_CPUCore_SetIRQPriority(timerIRQNo, timerIRQPriorities[priority], 0);
+
+#if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+	/* CPU calls handler of timer mode directly */
+	(void)Drv_CPUCore_SetIRQHandler(timerIRQNo, (mode == TIMER_MODE_ONE_SHOT) ?
+										oneShotIRQHandlers[timerNo] : 
+										commonIRQHandlers[timerNo]);
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
 
 	/* We can enable interrupt of specified Timer */
     NVIC_EnableIRQ(timerIRQNo);
@@ -392,6 +830,27 @@ PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority,
 	/* We initialized timer so we can mark it as validated (initialized) */
 	TIMER_SET_VALIDATION_KEY(timer);
 
+	return timer;
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Creates a SW Timer which matches with a HW Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
+{
+	Timer* timer;
+
+	DEBUG_ASSERT_MESSAGE(timerCallback != NULL, "Invalid (NULL) Callback!");
+
+	timer = CreateTimer(timerNo, priority, TIMER_MODE_ONE_SHOT, TIMER_PRESCALE_US);
+
+	/* Save Client Callback to call in case of timer timeout */
+	timer->callbacks[0] = timerCallback;
+
 	/*
 	 * Return internal reference as an integer number as Timer Handle.
 	 * This hidden internal reference simplies to manage internal objects
@@ -401,7 +860,7 @@ PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority,
 
 void Drv_Timer_Release(TimerHandle timer)
 {
-
+	(void)timer;
 }
 
 /*
@@ -417,9 +876,14 @@ PUBLIC void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
 
 	/* Internal Checks for debug mode */
 	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->mode == TIMER_MODE_ONE_SHOT, "Not a one shot timer!");
 
 	/* Start specified HW Timer with timeout value */
 	StartTimer(timer->hwTimerInfo->LPC_TIM, timeoutInUs);
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+	PredictMatchCycle(timer);
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
 }
 
 /*
@@ -443,3 +907,340 @@ PUBLIC uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
 	/* Return just tick count (1 tick = 1 us) as elapsed time */
 	return (uint32_t)LPC_TIM->TC;
 }
+
+/*
+ * Stops a one shot or periodic Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_Stop(TimerHandle timerHandle)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->mode != TIMER_MODE_FREE_RUNNING, "Free running timer cannot be stopped!");
+
+	/* Disable counter and drop a match which may be occurred just before */
+	timer->hwTimerInfo->LPC_TIM->TCR &= ~TIM_ENABLE;
+	timer->hwTimerInfo->LPC_TIM->IR = (uint32_t)TIM_IR_CLR(TIM_MR0_INT);
+}
+
+/*
+ * Creates a periodic SW Timer which matches with a HW Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC TimerHandle Drv_Timer_CreatePeriodic(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
+{
+	Timer* timer;
+
+	DEBUG_ASSERT_MESSAGE(timerCallback != NULL, "Invalid (NULL) Callback!");
+
+	timer = CreateTimer(timerNo, priority, TIMER_MODE_PERIODIC, TIMER_PRESCALE_US);
+
+	/* Save Client Callback to call on each period */
+	timer->callbacks[0] = timerCallback;
+
+	return (TimerHandle)timer;
+}
+
+/*
+ * Starts a periodic Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->mode == TIMER_MODE_PERIODIC, "Not a periodic timer!");
+	DEBUG_ASSERT_MESSAGE(periodInUs != 0, "Invalid Period!");
+
+	/* Any pending period change is overridden by new period */
+	timer->nextPeriod = 0;
+
+	/*
+	 * Counter is resetted on match (TC == MR0) so a period includes MR0 + 1
+	 * ticks.
+	 */
+	StartTimer(timer->hwTimerInfo->LPC_TIM, periodInUs - 1);
+}
+
+/*
+ * Changes period of a running periodic Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_SetPeriod(TimerHandle timerHandle, uint32_t periodInUs)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->mode == TIMER_MODE_PERIODIC, "Not a periodic timer!");
+	DEBUG_ASSERT_MESSAGE(periodInUs != 0, "Invalid Period!");
+
+	/*
+	 * Writing MR0 in the middle of a period may set it behind counter and
+	 * timer would run until counter wraps. So ISR applies new period just
+	 * after next reset.
+	 */
+	timer->nextPeriod = periodInUs;
+}
+
+/*
+ * Creates a free running SW Timer which matches with a HW Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC TimerHandle Drv_Timer_CreateFreeRunning(TimerNo timerNo, DrvTimerPriority priority)
+{
+	return (TimerHandle)CreateTimer(timerNo, priority, TIMER_MODE_FREE_RUNNING, TIMER_PRESCALE_US);
+}
+
+/*
+ * Registers a callback for a channel of free running timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_CreateChannel(TimerHandle timerHandle, TimerChannel channel, DrvTimerCallback channelCallback)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->mode == TIMER_MODE_FREE_RUNNING, "Not a free running timer!");
+	DEBUG_ASSERT_MESSAGE(channel < DRV_TIMER_NUM_OF_CHANNELS, "Invalid Channel!");
+	DEBUG_ASSERT_MESSAGE(timer->callbacks[channel] == NULL, "Channel is already assigned before!");
+	DEBUG_ASSERT_MESSAGE(channelCallback != NULL, "Invalid (NULL) Callback!");
+
+	timer->callbacks[channel] = channelCallback;
+}
+
+/*
+ * Starts a channel with a timeout relative to current time.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_StartChannel(TimerHandle timerHandle, TimerChannel channel, uint32_t timeoutInTicks)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->callbacks[channel] != NULL, "Channel is not created!");
+
+	/* Timeout is in counter ticks so it is directly added to counter */
+	ArmChannel(timer, channel, timer->hwTimerInfo->LPC_TIM->TC + timeoutInTicks);
+}
+
+/*
+ * Starts a channel to match at an absolute time.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_StartChannelAt(TimerHandle timerHandle, TimerChannel channel, uint32_t tick)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->callbacks[channel] != NULL, "Channel is not created!");
+
+	ArmChannel(timer, channel, tick);
+}
+
+/*
+ * Stops a channel.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_StopChannel(TimerHandle timerHandle, TimerChannel channel)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(channel < DRV_TIMER_NUM_OF_CHANNELS, "Invalid Channel!");
+
+	/* Counter still matches but ISR ignores disarmed channels */
+	timer->armed[channel] = false;
+}
+
+/*
+ * Initializes system wide Time Base.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC TimerHandle Drv_Timer_InitializeTimeBase(TimerNo timerNo, DrvTimerPriority priority, uint32_t frequency)
+{
+	uint32_t prescale = 0;
+
+	DEBUG_ASSERT_MESSAGE(timeBase == NULL, "Time Base is already initialized!");
+	DEBUG_ASSERT_MESSAGE(frequency <= TIMER_PCLK_FREQUENCY, "Unsupported Time Base Frequency!");
+
+	/* Highest resolution is PCLK itself (PR = 0) */
+	if (frequency != DRV_TIMER_FREQUENCY_PCLK)
+	{
+		prescale = (TIMER_PCLK_FREQUENCY / frequency) - 1;
+	}
+
+	/* Keep actual frequency because PCLK may not be a multiple of requested one */
+	timeBaseFrequency = TIMER_PCLK_FREQUENCY / (prescale + 1);
+	timeBaseEpoch = 0;
+
+	timeBase = CreateTimer(timerNo, priority, TIMER_MODE_FREE_RUNNING, prescale);
+
+	/* Counter starts from 0 so first match is on half of counter range */
+	timeBase->callbacks[TIMER_TIME_BASE_CHANNEL] = TimeBaseEpochHandler;
+	ArmChannel(timeBase, TIMER_TIME_BASE_CHANNEL, TIMER_TIME_BASE_HALF_RANGE);
+
+	return (TimerHandle)timeBase;
+}
+
+/*
+ * Reads 64 bit Time Base.
+ *
+ *  Epoch must be read before counter. Epoch may be at most one half period
+ *  behind counter (ISR of half period match is pending or preempted). In this
+ *  case parity of epoch does not match with MSB of counter and epoch is
+ *  corrected. So neither locking nor retry is required.
+ */
+PUBLIC uint64_t Drv_Timer_ReadTimeBase(void)
+{
+	uint32_t epoch;
+	uint32_t counter;
+
+	DEBUG_ASSERT_MESSAGE(timeBase != NULL, "Time Base is not initialized!");
+
+	epoch = timeBaseEpoch;
+	counter = timeBase->hwTimerInfo->LPC_TIM->TC;
+
+	/* Correct epoch if ISR has not served last half period match yet */
+	epoch += ((counter >> 31) ^ epoch) & 1;
+
+	return ((uint64_t)(epoch >> 1) << 32) | counter;
+}
+
+/*
+ * Gets Time Base Frequency.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint32_t Drv_Timer_GetTimeBaseFrequency(void)
+{
+	return timeBaseFrequency;
+}
+
+/*
+ * Reads Time Base in microseconds.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint64_t Drv_Timer_ReadTimeBaseInUs(void)
+{
+	uint64_t ticks = Drv_Timer_ReadTimeBase();
+	uint64_t seconds = ticks / timeBaseFrequency;
+	uint32_t remainder = (uint32_t)(ticks - (seconds * timeBaseFrequency));
+
+	/* Convert seconds and remainder separately to avoid 64 bit overflow */
+	return (seconds * TIMER_RESOLUTION_US) +
+		   (((uint64_t)remainder * TIMER_RESOLUTION_US) / timeBaseFrequency);
+}
+
+/*
+ * Checks whether tick frequencies of all timers can be kept on a new CPU
+ * Clock.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC bool Drv_Timer_IsCPUFrequencySupported(uint32_t cpuFrequency)
+{
+	uint32_t pclk = cpuFrequency / TIMER_CLK_DIV;
+	TimerNo timerNo;
+
+	for (timerNo = 0; timerNo < NUM_OF_TIMERS; timerNo++)
+	{
+		/* HW Info is linked when timer is created */
+		if (timers[timerNo].hwTimerInfo == NULL)
+		{
+			continue;
+		}
+
+		/* Tick must be an exact number of PCLKs */
+		if ((pclk < timers[timerNo].frequency) ||
+			((pclk % timers[timerNo].frequency) != 0))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Updates prescalers of all timers after CPU Clock is changed.
+ *
+ *  Counter is paused while prescaler is rewritten. Otherwise Prescale
+ *  Counter (PC) may pass a lower Prescale Register (PR) value between two
+ *  writes and TC would not be incremented until PC wraps. Pause costs a few
+ *  PCLKs so tick error is far below a tick.
+ */
+PUBLIC void Drv_Timer_UpdateCPUFrequency(void)
+{
+	LPC_TIM_TypeDef* LPC_TIM;
+	uint32_t prescale;
+	uint32_t control;
+	TimerNo timerNo;
+
+	for (timerNo = 0; timerNo < NUM_OF_TIMERS; timerNo++)
+	{
+		if (timers[timerNo].hwTimerInfo == NULL)
+		{
+			continue;
+		}
+
+		LPC_TIM = timers[timerNo].hwTimerInfo->LPC_TIM;
+		prescale = (TIMER_PCLK_FREQUENCY / timers[timerNo].frequency) - 1;
+
+		control = LPC_TIM->TCR;
+		LPC_TIM->TCR = control & ~TIM_ENABLE;
+
+		/* Keep elapsed part of current tick */
+		LPC_TIM->PC = (LPC_TIM->PC * (prescale + 1)) / (LPC_TIM->PR + 1);
+		LPC_TIM->PR = prescale;
+
+		LPC_TIM->TCR = control;
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+		/* Remaining ticks of a running one shot timer take new cycles per tick */
+		if ((timers[timerNo].mode == TIMER_MODE_ONE_SHOT) && (control & TIM_ENABLE))
+		{
+			PredictMatchCycle(&timers[timerNo]);
+		}
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+	}
+}
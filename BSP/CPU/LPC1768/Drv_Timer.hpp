@@ -0,0 +1,174 @@
+/*******************************************************************************
+ *
+ * @file Drv_Timer.hpp
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief Compile Time HW Timer Binding (C++ Layer over Timer Driver)
+ *
+ *		  Header only C++ (C++98) layer for LPC17xx HW Timers. Timer number is
+ *		  a template parameter so register block of timer is a compile time
+ *		  constant and hot path accesses (e.g. reading counter or arming a
+ *		  match channel) do not look up HWTimers[timerNo] or a timer object
+ *		  at run-time.
+ *
+ *		  Timers are still created and configured by C API (prescaler, mode,
+ *		  interrupts), register accessors assume that timer is created before.
+ *
+ *			typedef Drv::HWTimer<1> UserTimerHW;
+ *
+ *			UserTimerHW::CreateFreeRunning(DRV_TIMER_PRI_LOW);
+ *			now = UserTimerHW::ReadCounter();
+ *			UserTimerHW::SetMatch<0>(now + 100);
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __DRV_TIMER_HPP
+#define __DRV_TIMER_HPP
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_Timer.h"
+
+#include "LPC17xx.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Compile Time Check for C++98 (no static_assert).
+ *  Fails with a negative array size if condition is false.
+ */
+#ifndef DRV_STATIC_CHECK
+#define DRV_STATIC_CHECK(condition, name)	typedef char name[(condition) ? 1 : -1] __attribute__((unused))
+#endif /* DRV_STATIC_CHECK */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+namespace Drv
+{
+
+/*
+ * Register Block Addresses of HW Timers.
+ *  Timers are not placed regularly (Timer 2 and 3 are on APB1) so each timer
+ *  has its own specialization. Unsupported timer numbers do not compile.
+ */
+template <TimerNo N>
+struct HWTimerInfo;
+
+template <>
+struct HWTimerInfo<0>
+{
+	static const uint32_t BaseAddress = LPC_TIM0_BASE;
+};
+
+template <>
+struct HWTimerInfo<1>
+{
+	static const uint32_t BaseAddress = LPC_TIM1_BASE;
+};
+
+template <>
+struct HWTimerInfo<2>
+{
+	static const uint32_t BaseAddress = LPC_TIM2_BASE;
+};
+
+template <>
+struct HWTimerInfo<3>
+{
+	static const uint32_t BaseAddress = LPC_TIM3_BASE;
+};
+
+/*
+ * HW Timer
+ */
+template <TimerNo N>
+class HWTimer
+{
+public:
+	/* HW Timer Number */
+	static const TimerNo Number = N;
+
+	/* Register Block of timer */
+	static LPC_TIM_TypeDef* Registers(void)
+	{
+		return (LPC_TIM_TypeDef*)HWTimerInfo<N>::BaseAddress;
+	}
+
+	/*
+	 * C API Bindings
+	 */
+
+	/* Creates timer as a one shot timer (see Drv_Timer_Create) */
+	static TimerHandle Create(DrvTimerPriority priority, DrvTimerCallback timerCallback)
+	{
+		return Drv_Timer_Create(N, priority, timerCallback);
+	}
+
+	/* Creates timer as a periodic timer (see Drv_Timer_CreatePeriodic) */
+	static TimerHandle CreatePeriodic(DrvTimerPriority priority, DrvTimerCallback timerCallback)
+	{
+		return Drv_Timer_CreatePeriodic(N, priority, timerCallback);
+	}
+
+	/* Creates timer as a free running timer (see Drv_Timer_CreateFreeRunning) */
+	static TimerHandle CreateFreeRunning(DrvTimerPriority priority)
+	{
+		return Drv_Timer_CreateFreeRunning(N, priority);
+	}
+
+	/*
+	 * Register Accessors
+	 */
+
+	/* Reads Timer Counter */
+	static uint32_t ReadCounter(void)
+	{
+		return Registers()->TC;
+	}
+
+	/*
+	 * Reads elapsed time of a one shot or periodic timer.
+	 *  Resolution of these timers is 1 us so counter is elapsed time.
+	 */
+	static uint32_t ReadElapsedTimeInUs(void)
+	{
+		return ReadCounter();
+	}
+
+	/*
+	 * Sets match value of a channel (Match Register) of a free running timer.
+	 *  Only Match Register is written. Channel callback and interrupt are
+	 *  still managed by Drv_Timer_CreateChannel and Drv_Timer_StartChannel.
+	 */
+	template <TimerChannel Channel>
+	static void SetMatch(uint32_t tick)
+	{
+		DRV_STATIC_CHECK(Channel < DRV_TIMER_NUM_OF_CHANNELS, Timer_Channel_Is_Out_Of_Range);
+
+		(&Registers()->MR0)[Channel] = tick;
+	}
+
+	/* Reads match value of a channel */
+	template <TimerChannel Channel>
+	static uint32_t ReadMatch(void)
+	{
+		DRV_STATIC_CHECK(Channel < DRV_TIMER_NUM_OF_CHANNELS, Timer_Channel_Is_Out_Of_Range);
+
+		return (&Registers()->MR0)[Channel];
+	}
+};
+
+} /* namespace Drv */
+
+#endif	/* __DRV_TIMER_HPP */
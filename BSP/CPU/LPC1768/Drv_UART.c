@@ -1,121 +1,1101 @@
+/*******************************************************************************
+ *
+ * @file Drv_UART.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief UART Driver Implementation for LPC17xx.
+ *
+ *			Driver supports all four UARTs (UART0~UART3) with 8N1 frame
+ *			format. Each UART has a RX and a TX ring buffer in RAM and HW
+ *			FIFOs (16 bytes) are drained/filled by UART interrupt.
+ *
+ *			Ring buffers are Single Producer Single Consumer (SPSC) rings
+ *			with free running head and tail indexes. Head is written only
+ *			by consumer and tail is written only by producer so neither
+ *			side needs a critical section.
+ *			  RX Ring : Producer is ISR, consumer is Drv_UART_Receive()
+ *			  TX Ring : Producer is Drv_UART_Send(), consumer is ISR
+ *
+ *			RX interrupt is raised when RX FIFO reaches trigger level or
+ *			when there are unread bytes below trigger level for a while
+ *			(Character Timeout) so client is informed once per burst instead
+ *			of once per byte.
+ *
+ *			Drv_UART_Send() never blocks. It queues as many bytes as TX Ring
+ *			can hold and returns number of queued bytes.
+ *
+ *			DMA Receive Mode is provided for long transfers (e.g. FW images)
+ *			at high baud rates. GPDMA moves received bytes into two caller
+ *			buffers alternately using a circular linked list (LLI) so CPU
+ *			does not touch each byte. Each UART uses GPDMA channel which has
+ *			same number with UART. UART asserts DMA request when RX FIFO
+ *			reaches trigger level and on Character Timeout. Character
+ *			Timeout interrupt is also used to inform client about idle line.
+ *
+ *			A UART is powered on when it is opened and powered off when it is
+ *			released (Drv_UART_Release()).
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
 
 /********************************* INCLUDES ***********************************/
 #include "Drv_UART.h"
+#include "Drv_CPUCore.h"
+#include "Drv_GPIO.h"
 
-#if !defined(UNIT_TEST)
-#include "TestData.h"
-#endif
+#include "LPC17xx.h"
+#include "lpc17xx_clkpwr.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+#include "DRVConfig.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
-#define EXTERNAL_TEST_DATA          1
-#define VALID_DATA                  0
+/*
+ * Number of UARTs in used CPU.
+ *  LPC17xx has 4 UART.
+ */
+#define NUM_OF_UARTS						(4)
+
+/*
+ * Size of RX and TX Ring Buffers of each UART.
+ *  Sizes must be power of two so free running indexes can be masked.
+ */
+#ifndef DRV_CONFIG_UART_RX_BUFFER_SIZE
+#define DRV_CONFIG_UART_RX_BUFFER_SIZE		(256)
+#endif	/* DRV_CONFIG_UART_RX_BUFFER_SIZE */
 
-#if EXTERNAL_TEST_DATA
-#define LENGTH_OF_REGULAR		sizeof(testImage) / (sizeof(char*))
+#ifndef DRV_CONFIG_UART_TX_BUFFER_SIZE
+#define DRV_CONFIG_UART_TX_BUFFER_SIZE		(128)
+#endif	/* DRV_CONFIG_UART_TX_BUFFER_SIZE */
 
-#else
-#define LENGTH_OF_REGULAR		sizeof(regularIntelHex) / (sizeof(char*))
+/*
+ * Preempt Priority of UART Interrupts.
+ *  Client callbacks are called from ISR and they may use driver services so
+ *  UART interrupts must be masked by critical sections.
+ */
+#ifndef DRV_CONFIG_UART_PRIORITY
+#define DRV_CONFIG_UART_PRIORITY			(26)
+#endif	/* DRV_CONFIG_UART_PRIORITY */
+
+/*
+ * RX FIFO Trigger Level
+ *  0 : 1 byte, 1 : 4 bytes, 2 : 8 bytes, 3 : 14 bytes
+ */
+#ifndef DRV_CONFIG_UART_RX_TRIGGER_LEVEL
+#define DRV_CONFIG_UART_RX_TRIGGER_LEVEL	(2)
+#endif	/* DRV_CONFIG_UART_RX_TRIGGER_LEVEL */
+
+/*
+ * Check External Configurations
+ */
+#if (DRV_CONFIG_UART_RX_BUFFER_SIZE & (DRV_CONFIG_UART_RX_BUFFER_SIZE - 1)) != 0
+#error "UART RX Buffer Size must be power of two!"
 #endif
 
+#if (DRV_CONFIG_UART_TX_BUFFER_SIZE & (DRV_CONFIG_UART_TX_BUFFER_SIZE - 1)) != 0
+#error "UART TX Buffer Size must be power of two!"
+#endif
+
+#if DRV_CONFIG_UART_PRIORITY > DRV_IRQ_LOWEST_PREEMPT_PRIORITY
+#error "UART priority is out of range of preempt priority bits!"
+#endif
+
+#if !DRV_IRQ_IS_KERNEL_AWARE(DRV_CONFIG_UART_PRIORITY)
+#error "UART priority must not be higher than MAX_SYSCALL_INTERRUPT_PRIORITY!"
+#endif
+
+#if DRV_CONFIG_UART_RX_TRIGGER_LEVEL > 3
+#error "Invalid UART RX Trigger Level!"
+#endif
+
+/* Size of HW RX and TX FIFOs */
+#define UART_HW_FIFO_SIZE					(16)
+
+/* Line Control Register (LCR) bits */
+#define UART_LCR_WLEN8						(0x03)	/* 8 bit data, 1 stop bit, no parity */
+#define UART_LCR_DLAB_EN					(0x80)	/* Divisor Latch Access */
+
+/* FIFO Control Register (FCR) bits */
+#define UART_FCR_FIFO_EN					(0x01)
+#define UART_FCR_RX_RESET					(0x02)
+#define UART_FCR_TX_RESET					(0x04)
+#define UART_FCR_TRG_LEVEL(level)			((level) << 6)
+
+/* Interrupt Enable Register (IER) bits */
+#define UART_IER_RBR_EN						(0x01)	/* RX Data Available and Character Timeout */
+#define UART_IER_THRE_EN					(0x02)	/* TX Holding Register Empty */
+#define UART_IER_RLS_EN						(0x04)	/* RX Line Status */
+
+/* FCR bit to enable DMA requests of UART */
+#define UART_FCR_DMA_MODE					(0x08)
+
+/* Interrupt Identification Register (IIR) interrupt id field */
+#define UART_IIR_INTID_MASK					(0x0E)
+#define UART_IIR_INTID_CTI					(0x0C)	/* Character Timeout */
+
+/* Line Status Register (LSR) bits */
+#define UART_LSR_RDR						(0x01)	/* Receiver Data Ready */
+#define UART_LSR_THRE						(0x20)	/* TX Holding Register Empty */
+#define UART_LSR_TEMT						(0x40)	/* Transmitter Empty (FIFO and Shift Register) */
+
+/* Pin Mode of UART Pins (Pull-up) */
+#define UART_PIN_MODE						(0)
+
+/* UART Pins are on Port 0 for all UARTs */
+#define UART_PIN_PORT						(0)
+
+/*
+ * UART Clock (PCLK) is selected by SystemInit before PLL0 is connected and it
+ * is never changed at run time (PCLKSEL must not be written while PLL0 is 
+ * connected, see LPC17xx Errata). Driver reads selected divider, so baud 
+ * rates are right for any selection. SystemInit selects CPU Clock (not 
+ * default CCLK / 4) so high baud rates (e.g. 921600) can be reached with 
+ * fractional divider in tolerance.
+ */
+#define UART_PCLK_DIVIDERS					{ 4, 1, 2, 8 }
+
+/* Max value of fractional divider multiplier (MULVAL) */
+#define UART_FDR_MAX_MULVAL					(15)
+
+/* Fractional Divider Register value */
+#define UART_FDR_VALUE(divAddVal, mulVal)	(((mulVal) << 4) | (divAddVal))
+
+/*
+ * Minimum Divisor Latch value if fractional divider is active (DIVADDVAL > 0).
+ *  See LPC17xx User Manual.
+ */
+#define UART_MIN_DIVISOR_WITH_FRACTION		(3)
+
+/* Max Divisor Latch value (DLM:DLL) */
+#define UART_MAX_DIVISOR					(0xFFFF)
+
+/*
+ * Max allowed baud rate error in permille.
+ *  Total error of both sides must be less than ~3% for 8N1 frames.
+ */
+#define UART_MAX_BAUD_ERROR_PERMILLE		(15)
+
+/* UART Clock (PCLK) frequency of a UART for a CPU Clock */
+#define UART_PCLK_FREQUENCY(uartNo, cpuClock)	((cpuClock) / GetPCLKDivider(uartNo))
+
+/* RX FIFO Trigger Level in DMA Receive Mode (8 bytes) and matching burst */
+#define UART_DMA_RX_TRIGGER_LEVEL			(2)
+#define UART_DMA_RX_BURST_SIZE				(2)		/* 8 transfers */
+
+/* Number of buffers in DMA Receive Mode */
+#define UART_DMA_NUM_OF_BUFFERS				(2)
+
+/* GPDMA Peripheral Request Number of UART RX : UART0 RX is 9, UART1 RX is 11.. */
+#define UART_DMA_RX_REQUEST(uartNo)			(9 + ((uartNo) * 2))
+
+/* DMAREQSEL bit to select Timer (instead of UART) for a DMA request (8~15) */
+#define UART_DMAREQSEL_BIT(request)			(1 << ((request) - 8))
+
+/* GPDMA Configuration (DMACConfig) enable bit */
+#define DMA_CONFIG_ENABLE					(0x01)
+
+/* GPDMA Channel Control (DMACCControl) fields */
+#define DMA_CONTROL_TRANSFER_SIZE_MASK		(0xFFF)
+#define DMA_CONTROL_SBSIZE(burst)			((burst) << 12)
+#define DMA_CONTROL_DBSIZE(burst)			((burst) << 15)
+#define DMA_CONTROL_DI						(1UL << 27)		/* Destination Increment */
+#define DMA_CONTROL_I						(1UL << 31)		/* Terminal Count Interrupt */
+
+/* GPDMA Channel Configuration (DMACCConfig) fields */
+#define DMA_CH_CONFIG_ENABLE				(0x01)
+#define DMA_CH_CONFIG_SRC_PERIPHERAL(req)	((req) << 1)
+#define DMA_CH_CONFIG_P2M					(2 << 11)		/* Peripheral to Memory */
+#define DMA_CH_CONFIG_IE					(1 << 14)		/* Error Interrupt Mask */
+#define DMA_CH_CONFIG_ITC					(1 << 15)		/* Terminal Count Interrupt Mask */
+
+/* Index of a free running ring index in buffer */
+#define UART_RX_INDEX(index)				((index) & (DRV_CONFIG_UART_RX_BUFFER_SIZE - 1))
+#define UART_TX_INDEX(index)				((index) & (DRV_CONFIG_UART_TX_BUFFER_SIZE - 1))
+
 /***************************** TYPE DEFINITIONS *******************************/
 
+/*
+ * Structure to keep UART specific HW information.
+ *  Like HW Timers, there is no relation between UART Register addresses, IRQ
+ *  numbers and pins so we collect them in an array of this structure.
+ */
+typedef struct
+{
+	/* Address of UART Registers */
+	LPC_UART_TypeDef* LPC_UART;
+	/* Value (Mask) for Peripheral Control Block to power up UART */
+	uint32_t PCONP_Value;
+	/* Interrupt Number of UART */
+	IRQn_Type irqNo;
+	/* GPDMA Channel Registers for DMA Receive Mode */
+	LPC_GPDMACH_TypeDef* LPC_DMACH;
+	/* TX and RX Pins (on Port 0) */
+	uint8_t txPin;
+	uint8_t rxPin;
+	/* Pin Function Number of TX and RX Pins */
+	uint8_t pinFunction;
+	/* Peripheral Clock Selection position (PCLKSEL0 : 0~31, PCLKSEL1 : 32~63) */
+	uint8_t pclkSelection;
+} HWUARTInfo;
+
+/*
+ * Baud Rate Divisors
+ *  baudRate = PCLK / (16 x divisor x (1 + DIVADDVAL / MULVAL))
+ */
+typedef struct
+{
+	/* Divisor Latch (DLM:DLL) */
+	uint32_t divisor;
+	/* Fractional Divider Register (FDR) */
+	uint32_t fractionalDivider;
+} UARTBaudDivisors;
+
+/*
+ * GPDMA Linked List Item.
+ *  DMA loads next item to channel registers when a transfer completes.
+ */
+typedef struct
+{
+	uint32_t srcAddr;
+	uint32_t dstAddr;
+	uint32_t nextLLI;
+	uint32_t control;
+} DMALinkedListItem;
+
+/*
+ * DMA Receive Mode Object
+ */
+typedef struct
+{
+	/* Client Event Handler. NULL if DMA Receive Mode is not active */
+	UARTDMAEventHandler eventHandler;
+	/* Caller buffers which are filled alternately */
+	uint8_t* buffers[UART_DMA_NUM_OF_BUFFERS];
+	/* Size of each buffer */
+	uint32_t bufferSize;
+	/* Buffer which is filled by DMA now */
+	uint32_t activeBuffer;
+	/* Number of bytes in active buffer which are already reported */
+	uint32_t reported;
+	/* Circular linked list : buffer0 -> buffer1 -> buffer0 */
+	DMALinkedListItem lli[UART_DMA_NUM_OF_BUFFERS];
+} UARTDMAReceiver;
+
+/*
+ * UART Object
+ */
+typedef struct
+{
+	/* Client callback to inform client about received data */
+	UARTDataReceivedEventHandler dataReceivedEventHandler;
+	/* UART is assigned to a client */
+	bool opened;
+	/* Baud Rate. Kept to recalculate divisors when CPU Clock is changed */
+	uint32_t baudRate;
+	/*
+	 * TX is in progress. ISR feeds HW FIFO from TX Ring until ring is empty.
+	 *  If it is false, sender must prime HW FIFO.
+	 */
+	volatile bool txActive;
+	/* Free running RX Ring indexes. Head : Receive(), Tail : ISR */
+	volatile uint32_t rxHead;
+	volatile uint32_t rxTail;
+	/* Free running TX Ring indexes. Head : ISR, Tail : Send() */
+	volatile uint32_t txHead;
+	volatile uint32_t txTail;
+	/* DMA Receive Mode */
+	UARTDMAReceiver dmaReceiver;
+	/* Ring Buffers */
+	uint8_t rxBuffer[DRV_CONFIG_UART_RX_BUFFER_SIZE];
+	uint8_t txBuffer[DRV_CONFIG_UART_TX_BUFFER_SIZE];
+} UART;
+
 /**************************** FUNCTION PROTOTYPES *****************************/
+PRIVATE void UART_IRQHandler(uint32_t uartNo);
+PRIVATE void DMAReceiveIdle(uint32_t uartNo);
 
 /******************************** VARIABLES ***********************************/
 
-#if !EXTERNAL_TEST_DATA
-
-#if VALID_DATA
-PRIVATE char* regularIntelHex[] =
-{
-	":020000040000FA",
-	":0402FC00FFFFFFFF02",
-	":020000040000FA",
-	":10800000600400104D810000558100005781000080",
-	":10801000598100005B8100005D81000000000000CC",
-	":108020000000000000000000000000005F81000070",
-	":108030006181000000000000638100006581000094",
-	":108040006781000067810000678100006781000090",
-	":108050006781000067810000678100006781000080",
-	":1080D00000F02CF80AA090E8000C82448344AAF136",
-	":1080E0000107DA4501D100F021F8AFF2090EBAE834",
-	":10847000C8FEFFF7ECFF0000888400000000001039",
-	":08848000600400000881000007",
-	":04000005000080CDAA",
-	":00000001FF"
-};
-#else
-PRIVATE char* regularIntelHex[] =
-{
-	":020000040000FA",
-	":0402FC00FFFFFFFF02",
-	":0402FC00FFFFFFFF01", // ":0402FC00FFFFFFFF02",
-	":020000040000FA",
-	":10800000:10800000600400104D810000558100005781000080",
-	"1000598100005B8100005D81000000000000CC",     /* Missing line */
-	":10801000598100005B8100005D81000000000000CC",
-	":108020000000000000000000000000005F81000070",
-	":108030006181000000000000",
-	"638100006581000094",
-	":108040006781000067810000678100006781000090",
-	":108050006781000067810000678100006781000080:1080D00000F02CF80AA090E8000C82448344AAF136",
-	":1080E0000107DA4501D100F021F8AFF2090EBAE834",
-	":10847000C8FEFFF7ECFF00008884",
-	"00000000001039:08848000600400000881000007",
-	":04000005000080CDAA",
-	":00000001FF",
-	""
+/* CPU Clock dividers of PCLKSEL values */
+PRIVATE const uint8_t pclkDividers[] = UART_PCLK_DIVIDERS;
+
+/*
+ * Information about UART Hardwares.
+ */
+PRIVATE const HWUARTInfo HWUARTs[NUM_OF_UARTS] =
+{
+	/* UART 0 : TXD0 P0.2, RXD0 P0.3 */
+	{ LPC_UART0, CLKPWR_PCONP_PCUART0, UART0_IRQn, LPC_GPDMACH0, 2, 3, 1, CLKPWR_PCLKSEL_UART0 },
+	/* UART 1 : TXD1 P0.15, RXD1 P0.16 (Register layout is compatible with others) */
+	{ (LPC_UART_TypeDef*)LPC_UART1, CLKPWR_PCONP_PCUART1, UART1_IRQn, LPC_GPDMACH1, 15, 16, 1, CLKPWR_PCLKSEL_UART1 },
+	/* UART 2 : TXD2 P0.10, RXD2 P0.11 */
+	{ LPC_UART2, CLKPWR_PCONP_PCUART2, UART2_IRQn, LPC_GPDMACH2, 10, 11, 1, CLKPWR_PCLKSEL_UART2 },
+	/* UART 3 : TXD3 P0.0, RXD3 P0.1 */
+	{ LPC_UART3, CLKPWR_PCONP_PCUART3, UART3_IRQn, LPC_GPDMACH3, 0, 1, 2, CLKPWR_PCLKSEL_UART3 }
 };
-#endif
 
-#endif
+/*
+ * All UART objects
+ */
+PRIVATE UART uarts[NUM_OF_UARTS];
 
-#if defined(UNIT_TEST)
-    char* testImage[1];
-#endif
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * ISR Function for UART 0 Interrupt
+ */
+INTERNAL void POS_UART0_IRQHandler(void)
+{
+	UART_IRQHandler(0);
+}
+
+/*
+ * ISR Function for UART 1 Interrupt
+ */
+INTERNAL void POS_UART1_IRQHandler(void)
+{
+	UART_IRQHandler(1);
+}
+
+/*
+ * ISR Function for UART 2 Interrupt
+ */
+INTERNAL void POS_UART2_IRQHandler(void)
+{
+	UART_IRQHandler(2);
+}
+
+/*
+ * ISR Function for UART 3 Interrupt
+ */
+INTERNAL void POS_UART3_IRQHandler(void)
+{
+	UART_IRQHandler(3);
+}
+
+/*
+ * Moves bytes from TX Ring to HW TX FIFO.
+ *  Must be called when HW TX FIFO is empty (THRE) and only by TX Ring
+ *  consumer (ISR or Send() while UART interrupt is masked).
+ *
+ * @param uart UART Object
+ * @param LPC_UART UART Registers
+ *
+ * @return true if any byte is written into HW FIFO
+ */
+PRIVATE bool FillTxFIFO(UART* uart, LPC_UART_TypeDef* LPC_UART)
+{
+	uint32_t head = uart->txHead;
+	uint32_t tail = uart->txTail;
+	uint32_t count = 0;
+
+	while ((head != tail) && (count < UART_HW_FIFO_SIZE))
+	{
+		LPC_UART->THR = uart->txBuffer[UART_TX_INDEX(head)];
+		head++;
+		count++;
+	}
+
+	/* Release consumed slots to producer */
+	uart->txHead = head;
+
+	return (count > 0);
+}
+
+/*
+ * Common ISR Function for all UART Interrupts.
+ *
+ *  UART interrupts are level sensitive so ISR serves each source once. If
+ *  another source is still pending on return, interrupt is taken again.
+ *
+ * @param uartNo Number of UART interrupt source
+ */
+PRIVATE void UART_IRQHandler(uint32_t uartNo)
+{
+	LPC_UART_TypeDef* LPC_UART = HWUARTs[uartNo].LPC_UART;
+	UART* uart = &uarts[uartNo];
+	uint32_t interruptId;
+	uint32_t lineStatus;
+	uint32_t tail;
+	uint32_t count;
+	bool received = false;
+
+	/* Reading IIR clears THRE interrupt */
+	interruptId = LPC_UART->IIR & UART_IIR_INTID_MASK;
+	/* Reading LSR clears RX Line Status interrupt (errors) */
+	lineStatus = LPC_UART->LSR;
+
+	if (uart->dmaReceiver.eventHandler != NULL)
+	{
+		/* RX FIFO is drained by DMA, just check for idle line */
+		if (interruptId == UART_IIR_INTID_CTI)
+		{
+			DMAReceiveIdle(uartNo);
+		}
+
+		/* Do not touch RX FIFO */
+		lineStatus &= ~UART_LSR_RDR;
+	}
+
+	/*
+	 * RX : Drain HW FIFO into RX Ring. Reading RBR clears RX Data Available
+	 * and Character Timeout interrupts. If ring is full, bytes are dropped to
+	 * keep HW FIFO from overrunning.
+	 */
+	tail = uart->rxTail;
+	count = 0;
+	while ((lineStatus & UART_LSR_RDR) && (count < UART_HW_FIFO_SIZE))
+	{
+		uint8_t data = (uint8_t)LPC_UART->RBR;
+
+		if ((tail - uart->rxHead) < DRV_CONFIG_UART_RX_BUFFER_SIZE)
+		{
+			uart->rxBuffer[UART_RX_INDEX(tail)] = data;
+			tail++;
+			received = true;
+		}
+
+		count++;
+		lineStatus = LPC_UART->LSR;
+	}
+	/* Publish received bytes to consumer */
+	uart->rxTail = tail;
+
+	/* TX : Refill HW FIFO if it is empty */
+	if (uart->txActive && (lineStatus & UART_LSR_THRE))
+	{
+		if (!FillTxFIFO(uart, LPC_UART))
+		{
+			/* Nothing to send, next sender must prime HW FIFO */
+			uart->txActive = false;
+		}
+	}
+
+	if (received && (uart->dataReceivedEventHandler != NULL))
+	{
+		uart->dataReceivedEventHandler();
+	}
+}
+
+/*
+ * Reports new bytes in active DMA buffer to client.
+ *
+ * @param receiver DMA Receive Mode Object
+ * @param event Event to report
+ * @param filled Number of bytes in active buffer
+ */
+PRIVATE void ReportDMAReceive(UARTDMAReceiver* receiver, Drv_UART_DMAEvent event, uint32_t filled)
+{
+	uint8_t* buffer = receiver->buffers[receiver->activeBuffer];
+	uint32_t reported = receiver->reported;
+
+	receiver->reported = filled;
+
+	receiver->eventHandler(event, &buffer[reported], filled - reported);
+}
+
+/*
+ * Handles DMA Terminal Count (a buffer is full) of a UART.
+ *  DMA has already switched to the other buffer.
+ *
+ * @param uartNo UART Number
+ */
+PRIVATE void DMAReceiveCompleted(uint32_t uartNo)
+{
+	UARTDMAReceiver* receiver = &uarts[uartNo].dmaReceiver;
+
+	LPC_GPDMA->DMACIntTCClear = (1 << uartNo);
+
+	ReportDMAReceive(receiver, DRV_UART_DMA_EVENT_BUFFER_FULL, receiver->bufferSize);
+
+	receiver->activeBuffer = (receiver->activeBuffer + 1) % UART_DMA_NUM_OF_BUFFERS;
+	receiver->reported = 0;
+}
+
+/*
+ * Handles idle line in DMA Receive Mode.
+ *  Reports bytes which are moved into active buffer since last report.
+ *
+ * @param uartNo UART Number
+ */
+PRIVATE void DMAReceiveIdle(uint32_t uartNo)
+{
+	UARTDMAReceiver* receiver = &uarts[uartNo].dmaReceiver;
+	uint32_t filled;
+
+	/*
+	 * DMA and UART interrupts have same priority so a buffer may be completed
+	 * but not served yet. Serve it first to get remaining size of new buffer.
+	 */
+	if (LPC_GPDMA->DMACIntTCStat & (1 << uartNo))
+	{
+		DMAReceiveCompleted(uartNo);
+	}
+
+	filled = receiver->bufferSize -
+			 (HWUARTs[uartNo].LPC_DMACH->DMACCControl & DMA_CONTROL_TRANSFER_SIZE_MASK);
+
+	if (filled > receiver->reported)
+	{
+		ReportDMAReceive(receiver, DRV_UART_DMA_EVENT_IDLE_LINE, filled);
+	}
+}
+
+/*
+ * Stops DMA channel of a UART and restores interrupt driven reception.
+ *
+ * @param uartNo UART Number
+ */
+PRIVATE void StopDMAReceive(uint32_t uartNo)
+{
+	HWUARTs[uartNo].LPC_DMACH->DMACCConfig = 0;
+	LPC_GPDMA->DMACIntTCClear = (1 << uartNo);
+	LPC_GPDMA->DMACIntErrClr = (1 << uartNo);
+
+	uarts[uartNo].dmaReceiver.eventHandler = NULL;
+
+	/* Disable DMA requests and drop bytes which are left in FIFO */
+	HWUARTs[uartNo].LPC_UART->FCR = UART_FCR_FIFO_EN | UART_FCR_RX_RESET |
+									UART_FCR_TRG_LEVEL(DRV_CONFIG_UART_RX_TRIGGER_LEVEL);
+}
+
+/*
+ * ISR Function for GPDMA Interrupt
+ *  GPDMA has single interrupt for all channels. Channels 0~3 belong to UARTs.
+ */
+INTERNAL void POS_DMA_IRQHandler(void)
+{
+	uint32_t tcPendings = LPC_GPDMA->DMACIntTCStat;
+	uint32_t errorPendings = LPC_GPDMA->DMACIntErrStat;
+	uint32_t uartNo;
+
+	for (uartNo = 0; uartNo < NUM_OF_UARTS; uartNo++)
+	{
+		UARTDMAReceiver* receiver = &uarts[uartNo].dmaReceiver;
+
+		if (receiver->eventHandler == NULL)
+		{
+			continue;
+		}
+
+		if (errorPendings & (1 << uartNo))
+		{
+			UARTDMAEventHandler eventHandler = receiver->eventHandler;
+
+			StopDMAReceive(uartNo);
+			eventHandler(DRV_UART_DMA_EVENT_ERROR, NULL, 0);
+		}
+		else if (tcPendings & (1 << uartNo))
+		{
+			DMAReceiveCompleted(uartNo);
+		}
+	}
+}
 
-UARTDataReceivedEventHandler evHandler;
-PRIVATE uint32_t index = 0;
+/*
+ * Returns CPU Clock divider of UART Clock (PCLK) which is selected by 
+ * SystemInit. PCLKSEL0 and PCLKSEL1 are consecutive registers.
+ */
+PRIVATE uint32_t GetPCLKDivider(uint32_t uartNo)
+{
+	uint32_t pclkSelection = HWUARTs[uartNo].pclkSelection;
+	uint32_t pclkSel = (&LPC_SC->PCLKSEL0)[pclkSelection / 32];
+
+	return pclkDividers[CLKPWR_PCLKSEL_GET(pclkSelection % 32, pclkSel)];
+}
+
+/*
+ * Calculates Divisor Latch and Fractional Divider values for a baud rate.
+ *  Searches all MULVAL/DIVADDVAL pairs and selects the one with minimum
+ *  error. Integer only divisor (DIVADDVAL = 0) is preferred on equal error.
+ *
+ * @param pclk UART Clock (PCLK) frequency
+ * @param baudRate Requested Baud Rate
+ * @param divisors Calculated divisors
+ *
+ * @return true if baud rate can be generated in tolerance
+ */
+PRIVATE bool CalculateBaudDivisors(uint32_t pclk, uint32_t baudRate, UARTBaudDivisors* divisors)
+{
+	uint32_t bestError = UINT32_MAX;
+	uint32_t mulVal;
+	uint32_t divAddVal;
+
+	/* Baud Rate can not exceed PCLK / 16 */
+	if ((baudRate == 0) || (baudRate > (pclk / 16)))
+	{
+		return false;
+	}
+
+	for (mulVal = 1; mulVal <= UART_FDR_MAX_MULVAL; mulVal++)
+	{
+		for (divAddVal = 0; divAddVal < mulVal; divAddVal++)
+		{
+			/* DL = PCLK x MULVAL / (16 x baudRate x (MULVAL + DIVADDVAL)), rounded */
+			uint32_t denominator = 16 * baudRate * (mulVal + divAddVal);
+			uint32_t divisor = ((pclk * mulVal) + (denominator / 2)) / denominator;
+			uint32_t actualBaudRate;
+			uint32_t error;
+
+			if ((divisor == 0) || (divisor > UART_MAX_DIVISOR) ||
+				((divAddVal > 0) && (divisor < UART_MIN_DIVISOR_WITH_FRACTION)))
+			{
+				continue;
+			}
+
+			actualBaudRate = (pclk * mulVal) / (16 * divisor * (mulVal + divAddVal));
+			error = (actualBaudRate > baudRate) ? (actualBaudRate - baudRate) : (baudRate - actualBaudRate);
+
+			if (error < bestError)
+			{
+				bestError = error;
+				divisors->divisor = divisor;
+				divisors->fractionalDivider = UART_FDR_VALUE(divAddVal, mulVal);
+			}
+		}
+	}
+
+	return (bestError != UINT32_MAX) &&
+		   ((bestError * 1000) <= (baudRate * UART_MAX_BAUD_ERROR_PERMILLE));
+}
 
-/**************************** PRIVATE FUNCTIONS ******************************/
+/*
+ * Writes baud rate divisors into UART registers. Sets frame format to 8N1.
+ *
+ * @param LPC_UART UART Registers
+ * @param divisors Baud Rate Divisors
+ */
+PRIVATE void SetBaudDivisors(LPC_UART_TypeDef* LPC_UART, const UARTBaudDivisors* divisors)
+{
+	LPC_UART->LCR = UART_LCR_DLAB_EN;
+	LPC_UART->DLM = (uint8_t)(divisors->divisor >> 8);
+	LPC_UART->DLL = (uint8_t)divisors->divisor;
+	LPC_UART->FDR = divisors->fractionalDivider;
+	LPC_UART->LCR = UART_LCR_WLEN8;
+}
 
 /***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes UART Driver
+ *
+ * @param none
+ * @return none
+ */
 void Drv_UART_Init(void)
 {
-
+	memset(uarts, 0, sizeof(uarts));
 }
 
+/*
+ * Opens a UART and starts reception.
+ *
+ * @param uartNo UART Number (0~3)
+ * @param baudRate Baud Rate
+ * @param dataReceivedEventHandler Client callback which is called from ISR
+ *        when new bytes are received. Can be NULL.
+ *
+ * @return Handle of UART or DRV_UART_INVALID_HANDLER if UART can not be opened.
+ */
 UartHandle Drv_UART_Get(uint32_t uartNo, uint32_t baudRate, UARTDataReceivedEventHandler dataReceivedEventHandler)
 {
-	evHandler = dataReceivedEventHandler;
+	const HWUARTInfo* hwUARTInfo;
+	LPC_UART_TypeDef* LPC_UART;
+	UARTBaudDivisors divisors;
+	UART* uart;
+
+	if ((uartNo >= NUM_OF_UARTS) ||
+		!CalculateBaudDivisors(UART_PCLK_FREQUENCY(uartNo, SystemCoreClock), baudRate, &divisors))
+	{
+		return DRV_UART_INVALID_HANDLER;
+	}
+
+	uart = &uarts[uartNo];
+	if (uart->opened)
+	{
+		return DRV_UART_INVALID_HANDLER;
+	}
+
+	hwUARTInfo = &HWUARTs[uartNo];
+	LPC_UART = hwUARTInfo->LPC_UART;
+
+	uart->dataReceivedEventHandler = dataReceivedEventHandler;
+	uart->baudRate = baudRate;
+	uart->txActive = false;
+	uart->rxHead = uart->rxTail = 0;
+	uart->txHead = uart->txTail = 0;
+	uart->opened = true;
 
-	evHandler();
+	/* Power up UART */
+	LPC_SC->PCONP |= hwUARTInfo->PCONP_Value & CLKPWR_PCONP_BITMASK;
+
+	/* Route pins to UART */
+	Drv_GPIO_ConfigurePin(UART_PIN_PORT, hwUARTInfo->txPin, hwUARTInfo->pinFunction, UART_PIN_MODE);
+	Drv_GPIO_ConfigurePin(UART_PIN_PORT, hwUARTInfo->rxPin, hwUARTInfo->pinFunction, UART_PIN_MODE);
+
+	SetBaudDivisors(LPC_UART, &divisors);
+
+	/* Enable and reset FIFOs */
+	LPC_UART->FCR = UART_FCR_FIFO_EN | UART_FCR_RX_RESET | UART_FCR_TX_RESET |
+					UART_FCR_TRG_LEVEL(DRV_CONFIG_UART_RX_TRIGGER_LEVEL);
+
+	/* Enable RX, TX and Line Status Interrupts */
+	LPC_UART->IER = UART_IER_RBR_EN | UART_IER_THRE_EN | UART_IER_RLS_EN;
+
+	Drv_CPUCore_SetIRQPriority(hwUARTInfo->irqNo, DRV_CONFIG_UART_PRIORITY, 0);
+	NVIC_EnableIRQ(hwUARTInfo->irqNo);
 
 	return (UartHandle)uartNo;
 }
 
+/*
+ * Closes UART. Unsent bytes are dropped.
+ *
+ * @param uart Handle of UART
+ * @return none
+ */
 void Drv_UART_Release(UartHandle uart)
 {
+	const HWUARTInfo* hwUARTInfo;
+
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened)
+	{
+		return;
+	}
+
+	hwUARTInfo = &HWUARTs[uart];
+
+	if (uarts[uart].dmaReceiver.eventHandler != NULL)
+	{
+		StopDMAReceive((uint32_t)uart);
+	}
+
+	hwUARTInfo->LPC_UART->IER = 0;
+	NVIC_DisableIRQ(hwUARTInfo->irqNo);
+
+	/* Power down UART */
+	LPC_SC->PCONP &= ~hwUARTInfo->PCONP_Value;
+
+	uarts[uart].dataReceivedEventHandler = NULL;
+	uarts[uart].txActive = false;
+	uarts[uart].opened = false;
 }
 
-int32_t Drv_UART_Receive(UartHandle uart, uint8_t* receiveBuffer, uint32_t receiveLength)
+/*
+ * Changes baud rate of an open UART.
+ *  Bytes which are being sent would be corrupted so all queued bytes must be
+ *  sent before (see Drv_UART_IsSendCompleted()).
+ *
+ * @param uart Handle of UART
+ * @param baudRate New Baud Rate
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL if handle is invalid, baud rate can
+ *         not be generated in tolerance or send is not completed.
+ */
+int32_t Drv_UART_SetBaudRate(UartHandle uart, uint32_t baudRate)
 {
-    size_t msgLeng;
-    const char* hexLine;
-#if EXTERNAL_TEST_DATA
-    hexLine = testImage[index];
-#else
-	hexLine = regularIntelHex[index];
-#endif
+	UARTBaudDivisors divisors;
+
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened ||
+		!Drv_UART_IsSendCompleted(uart) ||
+		!CalculateBaudDivisors(UART_PCLK_FREQUENCY(uart, SystemCoreClock), baudRate, &divisors))
+	{
+		return RESULT_FAIL;
+	}
+
+	SetBaudDivisors(HWUARTs[uart].LPC_UART, &divisors);
+	uarts[uart].baudRate = baudRate;
 
-    msgLeng = strlen(hexLine);
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Checks whether all queued bytes are sent out (including HW FIFO and shift
+ * register).
+ *
+ * @param uart Handle of UART
+ * @return true if there is nothing to send
+ */
+bool Drv_UART_IsSendCompleted(UartHandle uart)
+{
+	UART* uartObj;
 
-	memcpy(receiveBuffer, hexLine, msgLeng);
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened)
+	{
+		return true;
+	}
 
-	if (index++ < LENGTH_OF_REGULAR)
-		evHandler();
-	else
+	uartObj = &uarts[uart];
+
+	return (uartObj->txHead == uartObj->txTail) &&
+		   ((HWUARTs[uart].LPC_UART->LSR & UART_LSR_TEMT) != 0);
+}
+
+/*
+ * Queues bytes to send. Never blocks.
+ *  Must not be called concurrently for same UART (TX Ring has single
+ *  producer).
+ *
+ * @param uart Handle of UART
+ * @param sendBuffer Bytes to send
+ * @param sendLength Number of bytes to send
+ *
+ * @return Number of queued bytes (may be less than sendLength if TX Ring is
+ *         full) or -1 in case of error.
+ */
+int32_t Drv_UART_Send(UartHandle uart, uint8_t* sendBuffer, uint32_t sendLength)
+{
+	const HWUARTInfo* hwUARTInfo;
+	UART* uartObj;
+	uint32_t tail;
+	uint32_t count = 0;
+
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened || (sendBuffer == NULL))
+	{
 		return -1;
+	}
+
+	hwUARTInfo = &HWUARTs[uart];
+	uartObj = &uarts[uart];
+
+	/* Copy into TX Ring as much as possible */
+	tail = uartObj->txTail;
+	while ((count < sendLength) && ((tail - uartObj->txHead) < DRV_CONFIG_UART_TX_BUFFER_SIZE))
+	{
+		uartObj->txBuffer[UART_TX_INDEX(tail)] = sendBuffer[count];
+		tail++;
+		count++;
+	}
+	/* Publish queued bytes to consumer */
+	uartObj->txTail = tail;
+
+	/*
+	 * If TX is idle, ISR will not be triggered by itself so prime HW FIFO.
+	 *  ISR may be just clearing txActive so we mask UART interrupt (not all
+	 *  interrupts) while we check and prime.
+	 */
+	NVIC_DisableIRQ(hwUARTInfo->irqNo);
+	if (!uartObj->txActive)
+	{
+		uartObj->txActive = FillTxFIFO(uartObj, hwUARTInfo->LPC_UART);
+	}
+	NVIC_EnableIRQ(hwUARTInfo->irqNo);
+
+	return (int32_t)count;
+}
+
+/*
+ * Reads received bytes. Never blocks.
+ *
+ * @param uart Handle of UART
+ * @param receiveBuffer Buffer to copy received bytes
+ * @param receiveLength Size of receiveBuffer
+ *
+ * @return Number of read bytes, zero if there is no unread bytes or -1 in case
+ *         of error.
+ */
+int32_t Drv_UART_Receive(UartHandle uart, uint8_t* receiveBuffer, uint32_t receiveLength)
+{
+	UART* uartObj;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t count = 0;
+
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened || (receiveBuffer == NULL))
+	{
+		return -1;
+	}
+
+	uartObj = &uarts[uart];
+
+	head = uartObj->rxHead;
+	tail = uartObj->rxTail;
+	while ((head != tail) && (count < receiveLength))
+	{
+		receiveBuffer[count] = uartObj->rxBuffer[UART_RX_INDEX(head)];
+		head++;
+		count++;
+	}
+	/* Release read slots to producer */
+	uartObj->rxHead = head;
+
+	return (int32_t)count;
+}
+
+/*
+ * Starts DMA Receive Mode.
+ *
+ * @param uart Handle of UART
+ * @param buffer0 First Receive Buffer
+ * @param buffer1 Second Receive Buffer
+ * @param bufferSize Size of each buffer
+ * @param eventHandler DMA Receive Event Handler
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+int32_t Drv_UART_StartDMAReceive(UartHandle uart, uint8_t* buffer0, uint8_t* buffer1, uint32_t bufferSize, UARTDMAEventHandler eventHandler)
+{
+	const HWUARTInfo* hwUARTInfo;
+	UARTDMAReceiver* receiver;
+	LPC_GPDMACH_TypeDef* LPC_DMACH;
+	uint32_t request;
+	uint32_t control;
+	uint32_t i;
+
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || !uarts[uart].opened ||
+		(uarts[uart].dmaReceiver.eventHandler != NULL) ||
+		(buffer0 == NULL) || (buffer1 == NULL) || (eventHandler == NULL) ||
+		(bufferSize == 0) || (bufferSize > DRV_UART_DMA_MAX_BUFFER_SIZE))
+	{
+		return RESULT_FAIL;
+	}
+
+	hwUARTInfo = &HWUARTs[uart];
+	receiver = &uarts[uart].dmaReceiver;
+	LPC_DMACH = hwUARTInfo->LPC_DMACH;
+	request = UART_DMA_RX_REQUEST(uart);
+
+	receiver->buffers[0] = buffer0;
+	receiver->buffers[1] = buffer1;
+	receiver->bufferSize = bufferSize;
+	receiver->activeBuffer = 0;
+	receiver->reported = 0;
+
+	/* Byte transfers from RBR to incrementing buffer address */
+	control = bufferSize |
+			  DMA_CONTROL_SBSIZE(UART_DMA_RX_BURST_SIZE) |
+			  DMA_CONTROL_DBSIZE(UART_DMA_RX_BURST_SIZE) |
+			  DMA_CONTROL_DI |
+			  DMA_CONTROL_I;
+
+	/* Circular list so DMA switches buffers by itself */
+	for (i = 0; i < UART_DMA_NUM_OF_BUFFERS; i++)
+	{
+		receiver->lli[i].srcAddr = (uint32_t)(uintptr_t)&hwUARTInfo->LPC_UART->RBR;
+		receiver->lli[i].dstAddr = (uint32_t)(uintptr_t)receiver->buffers[i];
+		receiver->lli[i].nextLLI = (uint32_t)(uintptr_t)&receiver->lli[(i + 1) % UART_DMA_NUM_OF_BUFFERS];
+		receiver->lli[i].control = control;
+	}
+
+	/* Power up and enable GPDMA. It is shared by all UARTs */
+	LPC_SC->PCONP |= CLKPWR_PCONP_PCGPDMA & CLKPWR_PCONP_BITMASK;
+	LPC_GPDMA->DMACConfig = DMA_CONFIG_ENABLE;
+
+	/* DMA request line is shared with Timer Match, select UART */
+	LPC_SC->DMAREQSEL &= ~UART_DMAREQSEL_BIT(request);
+
+	/* Load first item into channel */
+	LPC_DMACH->DMACCConfig = 0;
+	LPC_GPDMA->DMACIntTCClear = (1 << uart);
+	LPC_GPDMA->DMACIntErrClr = (1 << uart);
+	LPC_DMACH->DMACCSrcAddr = receiver->lli[0].srcAddr;
+	LPC_DMACH->DMACCDestAddr = receiver->lli[0].dstAddr;
+	LPC_DMACH->DMACCLLI = receiver->lli[0].nextLLI;
+	LPC_DMACH->DMACCControl = receiver->lli[0].control;
+
+	/* DMA interrupt has same priority with UART interrupts (see DMAReceiveIdle) */
+	Drv_CPUCore_SetIRQPriority(DMA_IRQn, DRV_CONFIG_UART_PRIORITY, 0);
+	NVIC_EnableIRQ(DMA_IRQn);
+
+	/* Mark as active before any DMA event */
+	receiver->eventHandler = eventHandler;
+
+	LPC_DMACH->DMACCConfig = DMA_CH_CONFIG_ENABLE |
+							 DMA_CH_CONFIG_SRC_PERIPHERAL(request) |
+							 DMA_CH_CONFIG_P2M |
+							 DMA_CH_CONFIG_IE |
+							 DMA_CH_CONFIG_ITC;
+
+	/* Enable DMA requests of UART. Unread bytes in FIFO are taken by DMA */
+	hwUARTInfo->LPC_UART->FCR = UART_FCR_FIFO_EN | UART_FCR_DMA_MODE |
+								UART_FCR_TRG_LEVEL(UART_DMA_RX_TRIGGER_LEVEL);
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Stops DMA Receive Mode.
+ *
+ * @param uart Handle of UART
+ * @return none
+ */
+void Drv_UART_StopDMAReceive(UartHandle uart)
+{
+	if ((uart < 0) || (uart >= NUM_OF_UARTS) || (uarts[uart].dmaReceiver.eventHandler == NULL))
+	{
+		return;
+	}
+
+	/* Do not let DMA or UART ISR see a half stopped receiver */
+	NVIC_DisableIRQ(DMA_IRQn);
+	NVIC_DisableIRQ(HWUARTs[uart].irqNo);
+
+	StopDMAReceive((uint32_t)uart);
+
+	NVIC_EnableIRQ(HWUARTs[uart].irqNo);
+	NVIC_EnableIRQ(DMA_IRQn);
+}
+
+/*
+ * Checks whether baud rates of all open UARTs can be kept on a new CPU Clock.
+ *
+ * @param cpuFrequency New CPU Clock in Hz
+ * @return true if all baud rates can be generated in tolerance and nothing
+ *         is being sent
+ */
+bool Drv_UART_IsCPUFrequencySupported(uint32_t cpuFrequency)
+{
+	UARTBaudDivisors divisors;
+	uint32_t uartNo;
+
+	for (uartNo = 0; uartNo < NUM_OF_UARTS; uartNo++)
+	{
+		if (!uarts[uartNo].opened)
+		{
+			continue;
+		}
+
+		/* A byte in shift register would be corrupted (like Drv_UART_SetBaudRate) */
+		if (!Drv_UART_IsSendCompleted((UartHandle)uartNo) ||
+			!CalculateBaudDivisors(UART_PCLK_FREQUENCY(uartNo, cpuFrequency),
+								   uarts[uartNo].baudRate, &divisors))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Recalculates baud divisors of all open UARTs after CPU Clock is changed.
+ *
+ * @param none
+ * @return none
+ */
+void Drv_UART_UpdateCPUFrequency(void)
+{
+	UARTBaudDivisors divisors;
+	uint32_t uartNo;
 
-	return (int32_t)msgLeng;
+	for (uartNo = 0; uartNo < NUM_OF_UARTS; uartNo++)
+	{
+		if (uarts[uartNo].opened &&
+			CalculateBaudDivisors(UART_PCLK_FREQUENCY(uartNo, SystemCoreClock),
+								  uarts[uartNo].baudRate, &divisors))
+		{
+			SetBaudDivisors(HWUARTs[uartNo].LPC_UART, &divisors);
+		}
+	}
 }
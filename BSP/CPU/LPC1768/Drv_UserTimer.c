@@ -0,0 +1,636 @@
+/*******************************************************************************
+ *
+ * @file Drv_UserTimer.c
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief User Timer Driver Implementation.
+ *
+ *			LPC17xx has only four HW Timers so all user timers are multiplexed
+ *			on a single HW (one shot) Timer using a hierarchical timer wheel.
+ *
+ *			Wheel has WHEEL_NUM_OF_LEVELS levels and each level has 64 slots.
+ *			A slot of level 0 keeps timers which expire at exact microsecond,
+ *			a slot of level N keeps timers which expire in a 64^N us range.
+ *			When wheel time reaches start of a range, timers of that slot are
+ *			cascaded into lower levels.
+ *
+ *			- Insert and cancel are O(1) (doubly linked slot lists).
+ *			- Wheel is tickless. HW Timer is programmed for next event
+ *			  (expiry or cascade) which is found using occupancy bitmaps of
+ *			  levels. HW Timer is reprogrammed only if earliest event changes.
+ *			- Timers can be started with a slack (accepted lateness). Expiry
+ *			  of such a timer is moved into an already programmed wake-up or
+ *			  rounded to coarsest time in its window so loosely timed timers
+ *			  with overlapping windows expire in same interrupt.
+ *
+ *			Wheel time is derived from system wide Time Base (free running)
+ *			so it does not drift when HW Timer is reprogrammed or its
+ *			interrupt is served late. HW Timer is only a wake-up source.
+ *
+ *			[IMP] Time Base must be initialized before User Timers.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_UserTimer.h"
+#include "Drv_Timer.h"
+#include "Drv_CPUCore.h"
+
+#include "LPC17xx.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+#include "BSPConfig.h"
+#include "DRVConfig.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Maximum number of User Timers
+ */
+#ifndef CPU_TIMER_MAX_TIMER_COUNT
+#define CPU_TIMER_MAX_TIMER_COUNT			(30)
+#endif /* CPU_TIMER_MAX_TIMER_COUNT */
+
+/*
+ * HW Timer which is used to multiplex User Timers.
+ */
+#ifndef DRV_CONFIG_USER_TIMER_HW_TIMER_NO
+#define DRV_CONFIG_USER_TIMER_HW_TIMER_NO	(1)
+#endif /* DRV_CONFIG_USER_TIMER_HW_TIMER_NO */
+
+/* Number of bits (slots) of each wheel level */
+#define WHEEL_LEVEL_BITS					(6)
+#define WHEEL_SLOTS_PER_LEVEL				(1 << WHEEL_LEVEL_BITS)
+#define WHEEL_SLOT_MASK						(WHEEL_SLOTS_PER_LEVEL - 1)
+
+/*
+ * Number of wheel levels.
+ *  5 levels covers 30 bits of time so 32 bit time arithmetic never wraps
+ *  in range of wheel.
+ */
+#define WHEEL_NUM_OF_LEVELS					(5)
+#define WHEEL_NUM_OF_SLOTS					(WHEEL_NUM_OF_LEVELS * WHEEL_SLOTS_PER_LEVEL)
+
+/* Number of words in occupancy bitmap of a level */
+#define WHEEL_BITMAP_WORDS					(WHEEL_SLOTS_PER_LEVEL / 32)
+
+/* Maximum timeout in microseconds (~17.9 minutes) */
+#define USER_TIMER_MAX_TIMEOUT_US \
+			((1UL << (WHEEL_LEVEL_BITS * WHEEL_NUM_OF_LEVELS)) - 1)
+
+/*
+ * Minimum HW Timer Timeout.
+ *  Events which are closer than this value are delayed to this value. 
+ *  Otherwise, a very close match can be cleared by interrupt handler of HW 
+ *  Timer before it is processed.
+ */
+#define USER_TIMER_MIN_HW_TIMEOUT_US		(10)
+
+/* Shift value of a level */
+#define WHEEL_LEVEL_SHIFT(level)			((level) * WHEEL_LEVEL_BITS)
+
+/* Index of a time in a level */
+#define WHEEL_SLOT_INDEX(time, level) \
+			(((time) >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK)
+
+/* Slot value for timers which are not in wheel */
+#define TIMER_NOT_QUEUED					(-1)
+
+/* Returns index of lowest set bit of a non zero word */
+#define FIND_FIRST_SET(word)				(__CLZ(__RBIT(word)))
+
+/* Checks whether a handle addresses a created timer */
+#define TIMER_HANDLE_IS_VALID(handle) \
+			(((uint32_t)(handle) < CPU_TIMER_MAX_TIMER_COUNT) && \
+			 (userTimers[(handle)].callback != NULL))
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * User Timer Object
+ */
+typedef struct UserTimerStruct
+{
+	/* Client callback. NULL for free timers. */
+	Drv_TimerCallback callback;
+	/* Expiry time (wheel time in microseconds) */
+	uint32_t expiry;
+	/* Wheel slot of timer or TIMER_NOT_QUEUED */
+	int32_t slot;
+	/* Links of slot list */
+	struct UserTimerStruct* next;
+	struct UserTimerStruct* prev;
+} UserTimer;
+
+/*
+ * Timer Wheel
+ */
+typedef struct
+{
+	/* Slot lists of all levels */
+	UserTimer* slots[WHEEL_NUM_OF_SLOTS];
+	/* Occupancy bitmaps. A bit is set if slot list is not empty. */
+	uint32_t occupancy[WHEEL_NUM_OF_LEVELS][WHEEL_BITMAP_WORDS];
+	/* Wheel Time. All events until (including) this time are processed. */
+	uint32_t time;
+	/* Time of programmed HW Timer event */
+	uint32_t hwEvent;
+	/* HW Timer to multiplex user timers */
+	TimerHandle hwTimer;
+} TimerWheel;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* User Timer Pool */
+PRIVATE UserTimer userTimers[CPU_TIMER_MAX_TIMER_COUNT];
+
+/* Timer Wheel */
+PRIVATE TimerWheel wheel;
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Returns actual time (lower 32 bits of Time Base in microseconds).
+ *  Time Base is lock-free so it can be read with interrupts masked.
+ */
+PRIVATE ALWAYS_INLINE uint32_t getTime(void)
+{
+	return (uint32_t)Drv_Timer_ReadTimeBaseInUs();
+}
+
+/*
+ * Programs HW Timer for an event.
+ */
+PRIVATE void programHWTimer(uint32_t event)
+{
+	uint32_t now = getTime();
+	uint32_t timeout = event - now;
+
+	if ((int32_t)timeout < USER_TIMER_MIN_HW_TIMEOUT_US)
+	{
+		timeout = USER_TIMER_MIN_HW_TIMEOUT_US;
+	}
+
+	wheel.hwEvent = now + timeout;
+
+	Drv_Timer_Start(wheel.hwTimer, timeout);
+}
+
+/*
+ * Returns first occupied slot of a level starting from a slot index.
+ *
+ * @return Slot Index or -1 if there is no occupied slot after start index
+ */
+PRIVATE int32_t findOccupiedSlot(const uint32_t* bitmap, uint32_t start)
+{
+	uint32_t word = start >> 5;
+	uint32_t bits = bitmap[word] & (0xFFFFFFFFUL << (start & 31));
+
+	while (bits == 0)
+	{
+		if (++word >= WHEEL_BITMAP_WORDS)
+		{
+			return -1;
+		}
+
+		bits = bitmap[word];
+	}
+
+	return (int32_t)((word << 5) + FIND_FIRST_SET(bits));
+}
+
+/*
+ * Finds earliest event (expiry or cascade) of wheel.
+ *
+ * @param event Time of event
+ *
+ * @return true if wheel has an event, false if wheel is empty.
+ */
+PRIVATE bool getNextEvent(uint32_t* event)
+{
+	bool found = false;
+	uint32_t nearest = 0;
+	uint32_t level;
+
+	for (level = 0; level < WHEEL_NUM_OF_LEVELS; level++)
+	{
+		uint32_t current = WHEEL_SLOT_INDEX(wheel.time, level);
+		int32_t slot;
+		uint32_t distance;
+		uint32_t levelEvent;
+
+		/* Slots after current slot are in order, current slot is last one */
+		slot = findOccupiedSlot(wheel.occupancy[level], (current + 1) & WHEEL_SLOT_MASK);
+		if (slot < 0)
+		{
+			slot = findOccupiedSlot(wheel.occupancy[level], 0);
+			if (slot < 0)
+			{
+				continue;
+			}
+		}
+
+		/* Start time of slot range (1..64 ranges later) */
+		distance = (((uint32_t)slot - current - 1) & WHEEL_SLOT_MASK) + 1;
+		levelEvent = ((wheel.time >> WHEEL_LEVEL_SHIFT(level)) + distance) << WHEEL_LEVEL_SHIFT(level);
+
+		if (!found || (levelEvent - wheel.time < nearest - wheel.time))
+		{
+			nearest = levelEvent;
+			found = true;
+		}
+	}
+
+	*event = nearest;
+
+	return found;
+}
+
+/*
+ * Adds a timer to its slot according to its expiry and wheel time.
+ *
+ * @return Time of event (expiry or cascade) of slot
+ */
+PRIVATE uint32_t enqueueTimer(UserTimer* timer)
+{
+	uint32_t delta = timer->expiry - wheel.time;
+	uint32_t level = 0;
+	uint32_t index;
+	int32_t slot;
+
+	/* Level N keeps timers which expire in [64^N, 64^(N+1)) us */
+	if (delta >= WHEEL_SLOTS_PER_LEVEL)
+	{
+		level = (31 - __CLZ(delta)) / WHEEL_LEVEL_BITS;
+	}
+
+	index = WHEEL_SLOT_INDEX(timer->expiry, level);
+	slot = (int32_t)(level * WHEEL_SLOTS_PER_LEVEL + index);
+
+	/* Insert to head of slot list */
+	timer->prev = NULL;
+	timer->next = wheel.slots[slot];
+	if (timer->next != NULL)
+	{
+		timer->next->prev = timer;
+	}
+	wheel.slots[slot] = timer;
+	timer->slot = slot;
+
+	wheel.occupancy[level][index >> 5] |= (1UL << (index & 31));
+
+	return (timer->expiry >> WHEEL_LEVEL_SHIFT(level)) << WHEEL_LEVEL_SHIFT(level);
+}
+
+/*
+ * Removes a timer from its slot.
+ */
+PRIVATE void dequeueTimer(UserTimer* timer)
+{
+	int32_t slot = timer->slot;
+
+	if (timer->prev != NULL)
+	{
+		timer->prev->next = timer->next;
+	}
+	else
+	{
+		wheel.slots[slot] = timer->next;
+
+		if (timer->next == NULL)
+		{
+			/* Slot is empty now */
+			uint32_t index = (uint32_t)slot & WHEEL_SLOT_MASK;
+			wheel.occupancy[(uint32_t)slot / WHEEL_SLOTS_PER_LEVEL][index >> 5] &= ~(1UL << (index & 31));
+		}
+	}
+
+	if (timer->next != NULL)
+	{
+		timer->next->prev = timer->prev;
+	}
+
+	timer->slot = TIMER_NOT_QUEUED;
+}
+
+/*
+ * Selects an expiry in window of a timer [expiry, expiry + slack].
+ *
+ *  If programmed HW Timer event is in window, timer joins that wake-up.
+ *  Otherwise, expiry is rounded down to the time which has most trailing
+ *  zero bits in window. Timers whose windows overlap are rounded to same time
+ *  (or at least to same coarse slot) and they are processed in same interrupt.
+ *
+ * @return Selected expiry
+ */
+PRIVATE uint32_t applySlack(uint32_t expiry, uint32_t slack)
+{
+	uint32_t limit;
+	uint32_t mask;
+
+	if (slack == 0)
+	{
+		return expiry;
+	}
+
+	/* Unsigned distance is also out of window if event is before expiry */
+	if ((wheel.hwEvent - expiry) <= slack)
+	{
+		return wheel.hwEvent;
+	}
+
+	limit = expiry + slack;
+
+	/* Clear bits of limit below highest bit which differs from expiry */
+	mask = expiry ^ limit;
+	mask = (1UL << (31 - __CLZ(mask))) - 1;
+
+	return limit & ~mask;
+}
+
+/*
+ * Moves wheel time towards actual time without passing an unprocessed event.
+ */
+PRIVATE void syncWheelTime(uint32_t now)
+{
+	uint32_t event;
+
+	if (getNextEvent(&event) && ((int32_t)(event - now) <= 0))
+	{
+		/* Event is due but not processed yet (HW Timer IRQ is pending) */
+		wheel.time = event - 1;
+	}
+	else
+	{
+		wheel.time = now;
+	}
+}
+
+/*
+ * Processes all slots of an event. Wheel time must be set to event time.
+ */
+PRIVATE void processEvent(uint32_t event)
+{
+	int32_t level;
+
+	/* Cascade higher levels first, they may fill slot of lower levels */
+	for (level = WHEEL_NUM_OF_LEVELS - 1; level >= 0; level--)
+	{
+		UserTimer* timer;
+		int32_t slot;
+
+		/* Slot of a level is processed only on its range boundary */
+		if ((event & ((1UL << WHEEL_LEVEL_SHIFT(level)) - 1)) != 0)
+		{
+			continue;
+		}
+
+		slot = level * WHEEL_SLOTS_PER_LEVEL + (int32_t)WHEEL_SLOT_INDEX(event, level);
+
+		/* Callbacks can start or stop timers so take timers one by one */
+		while ((timer = wheel.slots[slot]) != NULL)
+		{
+			dequeueTimer(timer);
+
+			if (level > 0)
+			{
+				/* Cascade into a lower level */
+				(void)enqueueTimer(timer);
+			}
+			else
+			{
+				/* Expired */
+				timer->callback();
+			}
+		}
+	}
+}
+
+/*
+ * HW Timer Callback.
+ *  Processes all due events and programs HW Timer for next event.
+ */
+PRIVATE void wheelTimerCallback(void)
+{
+	uint32_t event;
+
+	Drv_CPUCore_EnterCritical();
+
+	/* Only due events are processed. A close event is left to HW Timer. */
+	while (getNextEvent(&event) && ((int32_t)(event - getTime()) <= 0))
+	{
+		wheel.time = event;
+		processEvent(event);
+	}
+
+	if (!getNextEvent(&event))
+	{
+		/* Keep a wake-up so slack of new timers has a reference */
+		event = getTime() + USER_TIMER_MAX_TIMEOUT_US;
+	}
+
+	programHWTimer(event);
+
+	Drv_CPUCore_ExitCritical();
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes User Timers
+ */
+PUBLIC void Drv_UserTimer_Init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < CPU_TIMER_MAX_TIMER_COUNT; i++)
+	{
+		userTimers[i].callback = NULL;
+		userTimers[i].slot = TIMER_NOT_QUEUED;
+	}
+
+	wheel.hwTimer = Drv_Timer_Create(DRV_CONFIG_USER_TIMER_HW_TIMER_NO,
+									 DRV_TIMER_PRI_LOW,
+									 wheelTimerCallback);
+
+	Drv_CPUCore_EnterCritical();
+	/* Time Base is already running, wheel starts from actual time */
+	wheel.time = getTime();
+	programHWTimer(wheel.time + USER_TIMER_MAX_TIMEOUT_US);
+	Drv_CPUCore_ExitCritical();
+}
+
+/*
+ * Creates a user timer
+ */
+PUBLIC Drv_TimerHandle Drv_UserTimer_Create(Drv_TimerCallback userTimerCB)
+{
+	Drv_TimerHandle handle = DRV_TIMER_INVALID_HANDLE;
+	int32_t i;
+
+	DEBUG_ASSERT_MESSAGE(userTimerCB != NULL, "Invalid (NULL) Callback!");
+
+	if (userTimerCB == NULL)
+	{
+		return DRV_TIMER_INVALID_HANDLE;
+	}
+
+	Drv_CPUCore_EnterCritical();
+
+	for (i = 0; i < CPU_TIMER_MAX_TIMER_COUNT; i++)
+	{
+		if (userTimers[i].callback == NULL)
+		{
+			userTimers[i].callback = userTimerCB;
+			userTimers[i].slot = TIMER_NOT_QUEUED;
+			handle = i;
+			break;
+		}
+	}
+
+	Drv_CPUCore_ExitCritical();
+
+	return handle;
+}
+
+/*
+ * Releases a user timer
+ */
+PUBLIC void Drv_UserTimer_Remove(Drv_TimerHandle timer)
+{
+	if (!TIMER_HANDLE_IS_VALID(timer))
+	{
+		return;
+	}
+
+	Drv_CPUCore_EnterCritical();
+
+	if (userTimers[timer].slot != TIMER_NOT_QUEUED)
+	{
+		dequeueTimer(&userTimers[timer]);
+	}
+
+	userTimers[timer].callback = NULL;
+
+	Drv_CPUCore_ExitCritical();
+}
+
+/*
+ * Starts a user timer
+ */
+PUBLIC void Drv_UserTimer_Start(Drv_TimerHandle timer, uint32_t timeout)
+{
+	Drv_UserTimer_StartWithSlack(timer, timeout, 0);
+}
+
+/*
+ * Starts a user timer with slack
+ */
+PUBLIC void Drv_UserTimer_StartWithSlack(Drv_TimerHandle timer, uint32_t timeout, uint32_t slack)
+{
+	UserTimer* userTimer;
+	uint32_t event;
+	uint32_t now;
+
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+
+	if (!TIMER_HANDLE_IS_VALID(timer))
+	{
+		return;
+	}
+
+	userTimer = &userTimers[timer];
+
+	if (timeout == 0)
+	{
+		/* Expire on next microsecond */
+		timeout = 1;
+	}
+
+	Drv_CPUCore_EnterCritical();
+
+	if (userTimer->slot != TIMER_NOT_QUEUED)
+	{
+		/* Restart */
+		dequeueTimer(userTimer);
+	}
+
+	now = getTime();
+	syncWheelTime(now);
+
+	userTimer->expiry = applySlack(now + timeout, slack);
+
+	/* Wheel time may stay behind actual time only if an event is pending */
+	if (userTimer->expiry - wheel.time > USER_TIMER_MAX_TIMEOUT_US)
+	{
+		userTimer->expiry = wheel.time + USER_TIMER_MAX_TIMEOUT_US;
+	}
+
+	event = enqueueTimer(userTimer);
+
+	/* Reprogram HW Timer only if earliest event is changed */
+	if ((int32_t)(event - wheel.hwEvent) < 0)
+	{
+		programHWTimer(event);
+	}
+
+	Drv_CPUCore_ExitCritical();
+}
+
+/*
+ * Stops a user timer.
+ *  HW Timer is not reprogrammed. If stopped timer was the earliest one,
+ *  HW Timer fires without an expiry and it is reprogrammed for next event.
+ */
+PUBLIC void Drv_UserTimer_Stop(Drv_TimerHandle timer)
+{
+	if (!TIMER_HANDLE_IS_VALID(timer))
+	{
+		return;
+	}
+
+	Drv_CPUCore_EnterCritical();
+
+	if (userTimers[timer].slot != TIMER_NOT_QUEUED)
+	{
+		dequeueTimer(&userTimers[timer]);
+	}
+
+	Drv_CPUCore_ExitCritical();
+}
+
+/*
+ * Busy waits in microseconds
+ *  Time Base keeps counting while interrupts are masked so delay also works
+ *  in critical sections and ISRs.
+ */
+PUBLIC void Drv_UserTimer_DelayUs(uint32_t microseconds)
+{
+	uint32_t start = getTime();
+
+	while (getTime() - start < microseconds);
+}
+
+/*
+ * Busy waits in milliseconds
+ */
+PUBLIC void Drv_UserTimer_DelayMs(uint32_t milliseconds)
+{
+	while (milliseconds-- > 0)
+	{
+		Drv_UserTimer_DelayUs(1000);
+	}
+}
@@ -24,6 +24,14 @@
 #include "postypes.h"
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Debug configuration of unit tests (normally provided by SysConfig.h and
+ * ProjectConfig.h of project). Asserts and debug outputs are disabled.
+ */
+#define ENABLE_DEBUG_ASSERT								0
+#define DEBUG_OUTPUT									0
+#define DEBUG_LEVEL										DEBUG_LEVEL_DISABLED
+
 /***************************** TYPE DEFINITIONS *******************************/
 /*
  * Used HW Timer count in that projects.
@@ -201,6 +201,56 @@ typedef struct
   uint32_t CTCR;
 } LPC_TIM_TypeDef;
 
+/*
+ * [IMP]
+ * Shared registers (unions in original version e.g. RBR/THR/DLL) are separate
+ * fields so tests can check written and read values independently.
+ */
+typedef struct
+{
+	uint32_t RBR;
+	uint32_t THR;
+	uint32_t DLL;
+	uint32_t DLM;
+	uint32_t IER;
+	uint32_t IIR;
+	uint32_t FCR;
+	uint32_t LCR;
+	uint32_t LSR;
+	uint32_t SCR;
+	uint32_t ACR;
+	uint32_t ICR;
+	uint32_t FDR;
+	uint32_t TER;
+} LPC_UART_TypeDef;
+
+typedef struct
+{
+	uint32_t DMACIntStat;
+	uint32_t DMACIntTCStat;
+	uint32_t DMACIntTCClear;
+	uint32_t DMACIntErrStat;
+	uint32_t DMACIntErrClr;
+	uint32_t DMACRawIntTCStat;
+	uint32_t DMACRawIntErrStat;
+	uint32_t DMACEnbldChns;
+	uint32_t DMACSoftBReq;
+	uint32_t DMACSoftSReq;
+	uint32_t DMACSoftLBReq;
+	uint32_t DMACSoftLSReq;
+	uint32_t DMACConfig;
+	uint32_t DMACSync;
+} LPC_GPDMA_TypeDef;
+
+typedef struct
+{
+	uint32_t DMACCSrcAddr;
+	uint32_t DMACCDestAddr;
+	uint32_t DMACCLLI;
+	uint32_t DMACCControl;
+	uint32_t DMACCConfig;
+} LPC_GPDMACH_TypeDef;
+
 typedef struct
 {
        uint32_t FLASHCFG;               /* Flash Accelerator Module           */
@@ -256,6 +306,15 @@ typedef struct
 		uint32_t svc_handler_call : 1;		/* Flag to see whether SVC Handler is called or not */
 	} flags;
 
+	/* Value to return as Main Stack Pointer (MSP) */
+	uint32_t mainStackPointer;
+
+	/* Base Priority Mask Register (BASEPRI) */
+	uint32_t basePriority;
+
+	/* Number of next exclusive stores (STREX) to fail (lost exclusivity) */
+	uint32_t exclusiveStoreFailures;
+
 } LPC17xxMockObjects;
 /**************************** FUNCTION PROTOTYPES *****************************/
 
@@ -269,12 +328,45 @@ extern void POS_PendSV_Handler(void);
 MOCK_REG_DEF(SCB_Type, SCB);
 MOCK_REG_DEF(LPC_PINCON_TypeDef, LPC_PINCON);
 MOCK_REG_DEF(LPC_GPIO_TypeDef, LPC_GPIO0);
-MOCK_REG_DEF(LPC_TIM_TypeDef, LPC_TIM0);
-MOCK_REG_DEF(LPC_TIM_TypeDef, LPC_TIM1);
-MOCK_REG_DEF(LPC_TIM_TypeDef, LPC_TIM2);
-MOCK_REG_DEF(LPC_TIM_TypeDef, LPC_TIM3);
 MOCK_REG_DEF(LPC_SC_TypeDef, LPC_SC);
 
+/*
+ * Timer Register addresses are also used in constant initializers (HW info
+ * table of Timer Driver).
+ */
+MOCK_STATIC LPC_TIM_TypeDef REGLPC_TIM0;
+MOCK_STATIC LPC_TIM_TypeDef REGLPC_TIM1;
+MOCK_STATIC LPC_TIM_TypeDef REGLPC_TIM2;
+MOCK_STATIC LPC_TIM_TypeDef REGLPC_TIM3;
+#define LPC_TIM0							(&REGLPC_TIM0)
+#define LPC_TIM1							(&REGLPC_TIM1)
+#define LPC_TIM2							(&REGLPC_TIM2)
+#define LPC_TIM3							(&REGLPC_TIM3)
+
+/*
+ * UART Register addresses are used in constant initializers (HW info tables)
+ * so they are defined as addresses of register objects like original ones.
+ */
+MOCK_STATIC LPC_UART_TypeDef REGLPC_UART0;
+MOCK_STATIC LPC_UART_TypeDef REGLPC_UART1;
+MOCK_STATIC LPC_UART_TypeDef REGLPC_UART2;
+MOCK_STATIC LPC_UART_TypeDef REGLPC_UART3;
+#define LPC_UART0							(&REGLPC_UART0)
+#define LPC_UART1							(&REGLPC_UART1)
+#define LPC_UART2							(&REGLPC_UART2)
+#define LPC_UART3							(&REGLPC_UART3)
+
+/* GPDMA and its channels which are used by UARTs */
+MOCK_REG_DEF(LPC_GPDMA_TypeDef, LPC_GPDMA);
+MOCK_STATIC LPC_GPDMACH_TypeDef REGLPC_GPDMACH0;
+MOCK_STATIC LPC_GPDMACH_TypeDef REGLPC_GPDMACH1;
+MOCK_STATIC LPC_GPDMACH_TypeDef REGLPC_GPDMACH2;
+MOCK_STATIC LPC_GPDMACH_TypeDef REGLPC_GPDMACH3;
+#define LPC_GPDMACH0						(&REGLPC_GPDMACH0)
+#define LPC_GPDMACH1						(&REGLPC_GPDMACH1)
+#define LPC_GPDMACH2						(&REGLPC_GPDMACH2)
+#define LPC_GPDMACH3						(&REGLPC_GPDMACH3)
+
 /*
  * System Clock.
  */
@@ -297,7 +389,19 @@ static INLINE void ResetRegistersAndObjects(void)
 	memset(LPC_PINCON, 0, sizeof(LPC_PINCON_TypeDef));
 	memset(LPC_GPIO0, 0, sizeof(LPC_GPIO_TypeDef));
 	memset(LPC_TIM0, 0, sizeof(LPC_TIM_TypeDef));
+	memset(LPC_TIM1, 0, sizeof(LPC_TIM_TypeDef));
+	memset(LPC_TIM2, 0, sizeof(LPC_TIM_TypeDef));
+	memset(LPC_TIM3, 0, sizeof(LPC_TIM_TypeDef));
 	memset(LPC_SC, 0, sizeof(LPC_SC_TypeDef));
+	memset(LPC_UART0, 0, sizeof(LPC_UART_TypeDef));
+	memset(LPC_UART1, 0, sizeof(LPC_UART_TypeDef));
+	memset(LPC_UART2, 0, sizeof(LPC_UART_TypeDef));
+	memset(LPC_UART3, 0, sizeof(LPC_UART_TypeDef));
+	memset(LPC_GPDMA, 0, sizeof(LPC_GPDMA_TypeDef));
+	memset(LPC_GPDMACH0, 0, sizeof(LPC_GPDMACH_TypeDef));
+	memset(LPC_GPDMACH1, 0, sizeof(LPC_GPDMACH_TypeDef));
+	memset(LPC_GPDMACH2, 0, sizeof(LPC_GPDMACH_TypeDef));
+	memset(LPC_GPDMACH3, 0, sizeof(LPC_GPDMACH_TypeDef));
 
 	memset(&lpcMockObjects, 0, sizeof(lpcMockObjects));
 }
@@ -342,6 +446,15 @@ static INLINE void __enable_irq(void)
 	lpcMockObjects.flags.interrupt_disabled = 0;
 }
 
+/*
+ * Mock Implementation for __get_PRIMASK
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __get_PRIMASK(void)
+{
+	return lpcMockObjects.flags.interrupt_disabled;
+}
+
 /*
  * Mock Implementation for NVIC_SetPriority
  */
@@ -359,7 +472,112 @@ static INLINE void NVIC_EnableIRQ(IRQn_Type IRQn __attribute__((__unused__)) )
 
 }
 
+/*
+ * Mock Implementation for NVIC_DisableIRQ
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void NVIC_DisableIRQ(IRQn_Type IRQn __attribute__((__unused__)) )
+{
+
+}
+
+/*
+ * Mock Implementation for NVIC_SetPriorityGrouping
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void NVIC_SetPriorityGrouping(uint32_t priorityGroup)
+{
+	/* PRIGROUP field of AIRCR */
+	SCB->AIRCR = (priorityGroup & 0x07) << 8;
+}
+
+/*
+ * Mock Implementations for NVIC Pending Set/Clear
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void NVIC_SetPendingIRQ(IRQn_Type IRQn __attribute__((__unused__)) )
+{
+
+}
+
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void NVIC_ClearPendingIRQ(IRQn_Type IRQn __attribute__((__unused__)) )
+{
+
+}
+
 SPLINT_SUPPRESS_UNUSED_ERROR
 static INLINE void NVIC_SystemReset(void) {  }
 
+/*
+ * Mock Implementation for __set_BASEPRI
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __set_BASEPRI(uint32_t basePri)
+{
+	lpcMockObjects.basePriority = basePri;
+}
+
+/*
+ * Mock Implementation for __get_BASEPRI
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __get_BASEPRI(void)
+{
+	return lpcMockObjects.basePriority;
+}
+
+/*
+ * Mock Implementations for Barriers
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __DSB(void) {  }
+
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __ISB(void) {  }
+
+/*
+ * Mock Implementation for Wait For Interrupt
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __WFI(void) {  }
+
+/*
+ * Mock Implementations for Exclusive Accesses
+ *  Exclusive stores fail as many as exclusiveStoreFailures to simulate an
+ *  interrupt between LDREX and STREX.
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __LDREXW(volatile uint32_t* addr)
+{
+	return *addr;
+}
+
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __STREXW(uint32_t value, volatile uint32_t* addr)
+{
+	if (lpcMockObjects.exclusiveStoreFailures > 0)
+	{
+		lpcMockObjects.exclusiveStoreFailures--;
+
+		return 1;
+	}
+
+	*addr = value;
+
+	return 0;
+}
+
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __CLREX(void) {  }
+
+/*
+ * Mock Implementation for __get_MSP
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __get_MSP(void)
+{
+	return lpcMockObjects.mainStackPointer;
+}
+
 #endif		/* __LPC17XX_H */
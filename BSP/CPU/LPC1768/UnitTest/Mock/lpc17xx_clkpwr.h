@@ -38,15 +38,61 @@
 #define	 CLKPWR_PCONP_PCTIM2				((uint32_t)(1<<22))
 /** Timer 3 power/clock control bit */
 #define	 CLKPWR_PCONP_PCTIM3				((uint32_t)(1<<23))
+/** UART 0 power/clock control bit */
+#define	 CLKPWR_PCONP_PCUART0				((uint32_t)(1<<3))
+/** UART 1 power/clock control bit */
+#define	 CLKPWR_PCONP_PCUART1				((uint32_t)(1<<4))
+/** UART 2 power/clock control bit */
+#define	 CLKPWR_PCONP_PCUART2				((uint32_t)(1<<24))
+/** UART 3 power/clock control bit */
+#define	 CLKPWR_PCONP_PCUART3				((uint32_t)(1<<25))
+/** GP DMA function power/clock control bit */
+#define	 CLKPWR_PCONP_PCGPDMA				((uint32_t)(1<<29))
+
+/* Power/clock control bits of other grantable peripherals */
+#define	 CLKPWR_PCONP_PCPWM1				((uint32_t)(1<<6))
+#define	 CLKPWR_PCONP_PCI2C0				((uint32_t)(1<<7))
+#define	 CLKPWR_PCONP_PCSPI					((uint32_t)(1<<8))
+#define	 CLKPWR_PCONP_PCRTC					((uint32_t)(1<<9))
+#define	 CLKPWR_PCONP_PCSSP1				((uint32_t)(1<<10))
+#define	 CLKPWR_PCONP_PCAD					((uint32_t)(1<<12))
+#define	 CLKPWR_PCONP_PCQEI					((uint32_t)(1<<18))
+#define	 CLKPWR_PCONP_PCI2C1				((uint32_t)(1<<19))
+#define	 CLKPWR_PCONP_PCSSP0				((uint32_t)(1<<21))
+#define	 CLKPWR_PCONP_PCI2C2				((uint32_t)(1<<26))
 
 #define CLKPWR_PCLKSEL_BITMASK(p)			_SBF(p,0x03)
 
 #define CLKPWR_PCLKSEL_SET(p,n)				_SBF(p,n)
+/** Macro to get peripheral clock of each type of peripheral */
+#define CLKPWR_PCLKSEL_GET(p, n)			((uint32_t)((n>>p)&0x03))
 
 /** Peripheral clock divider bit position for TIMER0 */
 #define	CLKPWR_PCLKSEL_TIMER0  				((uint32_t)(2))
 
 #define	CLKPWR_PCLKSEL_CCLK_DIV_4  			((uint32_t)(0))
+#define	CLKPWR_PCLKSEL_CCLK_DIV_1  			((uint32_t)(1))
+
+/* Peripheral Clock Selection positions of UARTs (PCLKSEL1 starts from 32) */
+#define	CLKPWR_PCLKSEL_UART0  				((uint32_t)(6))
+#define	CLKPWR_PCLKSEL_UART1  				((uint32_t)(8))
+#define	CLKPWR_PCLKSEL_UART2  				((uint32_t)(48))
+#define	CLKPWR_PCLKSEL_UART3  				((uint32_t)(50))
+
+/* Peripheral Clock Selection positions of other grantable peripherals */
+#define	CLKPWR_PCLKSEL_TIMER1  				((uint32_t)(4))
+#define	CLKPWR_PCLKSEL_PWM1  				((uint32_t)(12))
+#define	CLKPWR_PCLKSEL_I2C0  				((uint32_t)(14))
+#define	CLKPWR_PCLKSEL_SPI  				((uint32_t)(16))
+#define	CLKPWR_PCLKSEL_SSP1  				((uint32_t)(20))
+#define	CLKPWR_PCLKSEL_DAC  				((uint32_t)(22))
+#define	CLKPWR_PCLKSEL_ADC  				((uint32_t)(24))
+#define	CLKPWR_PCLKSEL_QEI  				((uint32_t)(32))
+#define	CLKPWR_PCLKSEL_I2C1  				((uint32_t)(38))
+#define	CLKPWR_PCLKSEL_SSP0  				((uint32_t)(42))
+#define	CLKPWR_PCLKSEL_TIMER2  				((uint32_t)(44))
+#define	CLKPWR_PCLKSEL_TIMER3  				((uint32_t)(46))
+#define	CLKPWR_PCLKSEL_I2C2  				((uint32_t)(52))
 
 #define TIM_CTCR_MODE_MASK  				0x3
 
@@ -34,3 +34,11 @@ void Drv_GPIO_Init(void)
 {
 
 }
+
+void Drv_GPIO_ConfigurePin(uint32_t port __attribute__((__unused__)),
+						   uint32_t pin __attribute__((__unused__)),
+						   uint32_t functionNo __attribute__((__unused__)),
+						   uint32_t driveMode __attribute__((__unused__)))
+{
+
+}
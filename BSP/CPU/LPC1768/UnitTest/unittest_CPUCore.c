@@ -5,13 +5,6 @@
  * @author Murat Cakmak (MC)
  *
  * @brief Unit test file for CPU module
-/*******************************************************************************
- *
- * @file BSPConfig.h
- *
- * @author Murat Cakmak (MC)
- *
- * @brief Project Specific BSP Configurations
  *
  * @see https://github.com/ZA-YA/ZAYA-OS/wiki
  *
@@ -44,11 +37,24 @@
 /* Include CPU source file for WHITE-BOX unit testing */
 #include "../Drv_CPUCore.c"
 
+/* Include UART source file for WHITE-BOX unit testing */
+#include "../Drv_UART.c"
+
+/* Include Timer and Clock source files for WHITE-BOX unit testing */
+#include "../Drv_Timer.c"
+#include "../Drv_Clock.c"
+
 /* Include Unity Framework */
 #include "unity.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+/* Peripheral Clock Selections of SystemInit : UARTs are clocked by CCLK */
+#define STARTUP_PCLKSEL0		(CLKPWR_PCLKSEL_SET(CLKPWR_PCLKSEL_UART0, CLKPWR_PCLKSEL_CCLK_DIV_1) | \
+								 CLKPWR_PCLKSEL_SET(CLKPWR_PCLKSEL_UART1, CLKPWR_PCLKSEL_CCLK_DIV_1))
+#define STARTUP_PCLKSEL1		(CLKPWR_PCLKSEL_SET((CLKPWR_PCLKSEL_UART2 - 32), CLKPWR_PCLKSEL_CCLK_DIV_1) | \
+								 CLKPWR_PCLKSEL_SET((CLKPWR_PCLKSEL_UART3 - 32), CLKPWR_PCLKSEL_CCLK_DIV_1))
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*
@@ -78,6 +84,18 @@ typedef struct
 
 /******************************** VARIABLES ***********************************/
 
+/* Number of UART Data Received events */
+PRIVATE uint32_t uartDataReceivedCount;
+
+/* Last UART DMA Receive events */
+PRIVATE struct
+{
+	uint32_t count;
+	Drv_UART_DMAEvent event[4];
+	uint8_t* data[4];
+	uint32_t length[4];
+} uartDMAEvents;
+
 /**************************** INTERNAL FUNCTIONS ******************************/
 /**
  * @brief Constructor Method for each test case
@@ -87,6 +105,10 @@ void setUp(void)
 {
 	/* Clear all registers for each test */
 	ResetRegistersAndObjects();
+
+	/* Peripheral Clocks are selected by SystemInit before PLL0 is connected */
+	LPC_SC->PCLKSEL0 = STARTUP_PCLKSEL0;
+	LPC_SC->PCLKSEL1 = STARTUP_PCLKSEL1;
 }
 
 /**
@@ -113,6 +135,55 @@ TCB* GetNextTCB(void)
 	return &tcb;
 }
 
+/*
+ * UART Data Received Event Handler to use in UART tests
+ */
+void UARTDataReceived(void)
+{
+	uartDataReceivedCount++;
+}
+
+/*
+ * UART DMA Receive Event Handler to use in UART tests
+ */
+void UARTDMAEvent(Drv_UART_DMAEvent event, uint8_t* data, uint32_t length)
+{
+	if (uartDMAEvents.count < 4)
+	{
+		uartDMAEvents.event[uartDMAEvents.count] = event;
+		uartDMAEvents.data[uartDMAEvents.count] = data;
+		uartDMAEvents.length[uartDMAEvents.count] = length;
+	}
+	uartDMAEvents.count++;
+}
+
+/*
+ * Timer Callback to use in Clock tests
+ */
+void TimerTimeout(void)
+{
+
+}
+
+/*
+ * Sets startup clock configuration : 100 MHz (400 MHz PLL0 output / 4)
+ */
+PRIVATE void SetStartupClock(void)
+{
+	SystemCoreClock = 100000000;
+	LPC_SC->PLL0STAT = CLOCK_PLL0STAT_ENABLED | CLOCK_PLL0STAT_CONNECTED;
+	LPC_SC->CCLKCFG = 3;
+	LPC_SC->FLASHCFG = (4 << CLOCK_FLASHTIM_POS) | 0x03A;
+}
+
+/*
+ * Simulates DMA progress by setting remaining transfer size of a channel
+ */
+PRIVATE void SetDMARemaining(LPC_GPDMACH_TypeDef* LPC_DMACH, uint32_t remaining)
+{
+	LPC_DMACH->DMACCControl = (LPC_DMACH->DMACCControl & ~DMA_CONTROL_TRANSFER_SIZE_MASK) | remaining;
+}
+
 /***************************** TEST FUNCTIONS *******************************/
 
 /*
@@ -145,6 +216,89 @@ void test_CPU_Halt(void)
 	/* TODO : Check also whether execution entered into endless while loop or not */
 }
 
+/*
+ * Tests nested critical sections.
+ *  BASEPRI must be raised by first enter and cleared only by last exit.
+ */
+void test_CPU_CriticalSection(void)
+{
+	criticalNesting = 0;
+
+	Drv_CPUCore_EnterCritical();
+	TEST_ASSERT((__get_BASEPRI() == MAX_SYSCALL_INTERRUPT_PRIORITY));
+
+	Drv_CPUCore_EnterCritical();
+	TEST_ASSERT((criticalNesting == 2));
+
+	Drv_CPUCore_ExitCritical();
+	TEST_ASSERT((__get_BASEPRI() == MAX_SYSCALL_INTERRUPT_PRIORITY));
+
+	Drv_CPUCore_ExitCritical();
+	TEST_ASSERT((__get_BASEPRI() == 0));
+	TEST_ASSERT((criticalNesting == 0));
+
+	/* Unbalanced exit must not underflow nesting count */
+	Drv_CPUCore_ExitCritical();
+	TEST_ASSERT((criticalNesting == 0));
+}
+
+/*
+ * Tests interrupt masking of flash programming.
+ *  Vectors are in flash in this configuration so all interrupts must be 
+ *  disabled during programming and critical section must be kept.
+ */
+void test_CPU_FlashProgramming(void)
+{
+	uint32_t state;
+
+	criticalNesting = 0;
+	ResetRegistersAndObjects();
+
+	Drv_CPUCore_EnterCritical();
+
+	state = Drv_CPUCore_EnterFlashProgramming();
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 1));
+
+	Drv_CPUCore_ExitFlashProgramming(state);
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 0));
+	TEST_ASSERT((__get_BASEPRI() == MAX_SYSCALL_INTERRUPT_PRIORITY));
+
+	Drv_CPUCore_ExitCritical();
+
+	/* Interrupts which are disabled by caller must stay disabled */
+	__disable_irq();
+
+	state = Drv_CPUCore_EnterFlashProgramming();
+	Drv_CPUCore_ExitFlashProgramming(state);
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 1));
+
+	__enable_irq();
+}
+
+/*
+ * Tests atomic compare and swap.
+ *  Word must be replaced only if it has expected value and store must be
+ *  retried when exclusivity is lost.
+ */
+void test_CPU_AtomicCompareAndSwap(void)
+{
+	volatile uint32_t word = 5;
+
+	TEST_ASSERT(Drv_CPUCore_AtomicCompareAndSwap(&word, 5, 6));
+	TEST_ASSERT((word == 6));
+
+	/* Word is already changed by someone else */
+	TEST_ASSERT(!Drv_CPUCore_AtomicCompareAndSwap(&word, 5, 7));
+	TEST_ASSERT((word == 6));
+
+	/* An interrupt breaks exclusivity twice */
+	lpcMockObjects.exclusiveStoreFailures = 2;
+
+	TEST_ASSERT(Drv_CPUCore_AtomicCompareAndSwap(&word, 6, 7));
+	TEST_ASSERT((word == 7));
+	TEST_ASSERT((lpcMockObjects.exclusiveStoreFailures == 0));
+}
+
 /*
  * Tests Functionality which starts Context Switching
  */
@@ -237,3 +391,430 @@ void test_CPU_CS_StackAlignmentTest(void)
 		TEST_ASSERT((((uintptr_t)tcb.topOfStack) & 0x7) == 0);
 	}
 }
+
+/*
+ * Tests UART opening.
+ *  UART must be powered, configured as 8N1 and its interrupts must be enabled.
+ */
+void test_UART_Get(void)
+{
+	UartHandle uart;
+
+	Drv_UART_Init();
+
+	uart = Drv_UART_Get(0, 115200, UARTDataReceived);
+	TEST_ASSERT((uart == 0));
+
+	TEST_ASSERT((LPC_SC->PCONP & CLKPWR_PCONP_PCUART0) != 0);
+	/* 100 MHz PCLK / (16 x 31 x (1 + 3 / 4)) = 115207 */
+	TEST_ASSERT((LPC_UART0->DLL == 31));
+	TEST_ASSERT((LPC_UART0->DLM == 0));
+	TEST_ASSERT((LPC_UART0->FDR == UART_FDR_VALUE(3, 4)));
+	/* PCLK selection of SystemInit is used, PCLKSEL is not written (Errata) */
+	TEST_ASSERT((LPC_SC->PCLKSEL0 == STARTUP_PCLKSEL0));
+	TEST_ASSERT((LPC_UART0->LCR == UART_LCR_WLEN8));
+	TEST_ASSERT((LPC_UART0->IER == (UART_IER_RBR_EN | UART_IER_THRE_EN | UART_IER_RLS_EN)));
+
+	/* UART is already in use */
+	TEST_ASSERT((Drv_UART_Get(0, 115200, UARTDataReceived) == DRV_UART_INVALID_HANDLER));
+	/* There is no such a UART */
+	TEST_ASSERT((Drv_UART_Get(NUM_OF_UARTS, 115200, UARTDataReceived) == DRV_UART_INVALID_HANDLER));
+
+	Drv_UART_Release(uart);
+	TEST_ASSERT((LPC_SC->PCONP & CLKPWR_PCONP_PCUART0) == 0);
+	TEST_ASSERT((LPC_UART0->IER == 0));
+
+	/* Default selection (CCLK / 4) : 25 MHz / (16 x 10 x (1 + 5 / 14)) = 115131 */
+	LPC_SC->PCLKSEL0 = 0;
+	uart = Drv_UART_Get(0, 115200, UARTDataReceived);
+	TEST_ASSERT((uart == 0));
+	TEST_ASSERT((LPC_UART0->DLL == 10));
+	TEST_ASSERT((LPC_UART0->FDR == UART_FDR_VALUE(5, 14)));
+	TEST_ASSERT((LPC_SC->PCLKSEL0 == 0));
+	Drv_UART_Release(uart);
+}
+
+/*
+ * Tests interrupt driven reception.
+ *  ISR must drain HW FIFO into RX Ring and inform client once per burst.
+ */
+void test_UART_Receive(void)
+{
+	UartHandle uart;
+	uint8_t buffer[32];
+	int32_t i;
+
+	Drv_UART_Init();
+	uartDataReceivedCount = 0;
+
+	uart = Drv_UART_Get(2, 9600, UARTDataReceived);
+
+	/* Nothing received yet */
+	TEST_ASSERT((Drv_UART_Receive(uart, buffer, sizeof(buffer)) == 0));
+
+	/* HW FIFO has data. ISR reads at most FIFO size bytes in one pass */
+	LPC_UART2->LSR = UART_LSR_RDR;
+	LPC_UART2->RBR = 0x5A;
+	POS_UART2_IRQHandler();
+	TEST_ASSERT((uartDataReceivedCount == 1));
+
+	/* Read in two parts */
+	TEST_ASSERT((Drv_UART_Receive(uart, buffer, 10) == 10));
+	TEST_ASSERT((Drv_UART_Receive(uart, &buffer[10], sizeof(buffer) - 10) == (UART_HW_FIFO_SIZE - 10)));
+	for (i = 0; i < UART_HW_FIFO_SIZE; i++)
+	{
+		TEST_ASSERT((buffer[i] == 0x5A));
+	}
+
+	/* Line status interrupt without data must not inform client */
+	LPC_UART2->LSR = 0;
+	POS_UART2_IRQHandler();
+	TEST_ASSERT((uartDataReceivedCount == 1));
+
+	/* Invalid handles */
+	TEST_ASSERT((Drv_UART_Receive(DRV_UART_INVALID_HANDLER, buffer, sizeof(buffer)) == -1));
+	TEST_ASSERT((Drv_UART_Receive(3, buffer, sizeof(buffer)) == -1));
+
+	Drv_UART_Release(uart);
+}
+
+/*
+ * Tests interrupt driven transmission.
+ *  Send must prime idle HW FIFO and ISR must send rest of TX Ring.
+ */
+void test_UART_Send(void)
+{
+	UartHandle uart;
+	uint8_t data[UART_HW_FIFO_SIZE + 4];
+	uint32_t i;
+
+	for (i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (uint8_t)i;
+	}
+
+	Drv_UART_Init();
+
+	uart = Drv_UART_Get(3, 115200, NULL);
+
+	TEST_ASSERT((Drv_UART_Send(uart, data, sizeof(data)) == (int32_t)sizeof(data)));
+
+	/* First HW FIFO size bytes are written directly */
+	TEST_ASSERT((LPC_UART3->THR == (UART_HW_FIFO_SIZE - 1)));
+	TEST_ASSERT(uarts[3].txActive);
+
+	/* HW FIFO is empty, ISR sends rest of data */
+	LPC_UART3->LSR = UART_LSR_THRE;
+	POS_UART3_IRQHandler();
+	TEST_ASSERT((LPC_UART3->THR == (sizeof(data) - 1)));
+	TEST_ASSERT(uarts[3].txActive);
+
+	/* Nothing left, TX becomes idle */
+	POS_UART3_IRQHandler();
+	TEST_ASSERT(!uarts[3].txActive);
+
+	/* TX Ring can not hold more than its size */
+	uarts[3].txActive = true;
+	TEST_ASSERT((Drv_UART_Send(uart, data, sizeof(data)) == (int32_t)sizeof(data)));
+	for (i = sizeof(data); i < DRV_CONFIG_UART_TX_BUFFER_SIZE; i++)
+	{
+		TEST_ASSERT((Drv_UART_Send(uart, data, 1) == 1));
+	}
+	TEST_ASSERT((Drv_UART_Send(uart, data, 1) == 0));
+
+	Drv_UART_Release(uart);
+	TEST_ASSERT((Drv_UART_Send(uart, data, 1) == -1));
+}
+
+/*
+ * Tests DMA Receive Mode.
+ *  Full buffers and idle line must be reported and each byte must be
+ *  reported only once.
+ */
+void test_UART_DMAReceive(void)
+{
+	UartHandle uart;
+	uint8_t buffer0[64];
+	uint8_t buffer1[64];
+
+	Drv_UART_Init();
+	memset(&uartDMAEvents, 0, sizeof(uartDMAEvents));
+	uartDataReceivedCount = 0;
+
+	uart = Drv_UART_Get(1, 921600, UARTDataReceived);
+
+	/* Invalid parameters */
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, buffer1, 0, UARTDMAEvent) == RESULT_FAIL));
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, buffer1, DRV_UART_DMA_MAX_BUFFER_SIZE + 1, UARTDMAEvent) == RESULT_FAIL));
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, NULL, sizeof(buffer0), UARTDMAEvent) == RESULT_FAIL));
+	TEST_ASSERT((Drv_UART_StartDMAReceive(0, buffer0, buffer1, sizeof(buffer0), UARTDMAEvent) == RESULT_FAIL));
+
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, buffer1, sizeof(buffer0), UARTDMAEvent) == RESULT_SUCCESS));
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, buffer1, sizeof(buffer0), UARTDMAEvent) == RESULT_FAIL));
+
+	/* DMA and UART are configured */
+	TEST_ASSERT((LPC_GPDMACH1->DMACCControl & DMA_CONTROL_TRANSFER_SIZE_MASK) == sizeof(buffer0));
+	TEST_ASSERT((LPC_GPDMACH1->DMACCConfig & DMA_CH_CONFIG_ENABLE) != 0);
+	TEST_ASSERT((LPC_GPDMACH1->DMACCConfig & DMA_CH_CONFIG_SRC_PERIPHERAL(0x1F)) == DMA_CH_CONFIG_SRC_PERIPHERAL(11));
+	TEST_ASSERT((LPC_UART1->FCR & UART_FCR_DMA_MODE) != 0);
+	TEST_ASSERT((LPC_SC->PCONP & CLKPWR_PCONP_PCGPDMA) != 0);
+
+	/* 10 bytes are received then line is idle */
+	SetDMARemaining(LPC_GPDMACH1, sizeof(buffer0) - 10);
+	LPC_UART1->IIR = UART_IIR_INTID_CTI;
+	LPC_UART1->LSR = UART_LSR_RDR;
+	POS_UART1_IRQHandler();
+	TEST_ASSERT((uartDMAEvents.count == 1));
+	TEST_ASSERT((uartDMAEvents.event[0] == DRV_UART_DMA_EVENT_IDLE_LINE));
+	TEST_ASSERT((uartDMAEvents.data[0] == buffer0));
+	TEST_ASSERT((uartDMAEvents.length[0] == 10));
+	/* RX FIFO belongs to DMA, interrupt driven path must not be used */
+	TEST_ASSERT((uartDataReceivedCount == 0));
+
+	/* Spurious timeout without new data */
+	POS_UART1_IRQHandler();
+	TEST_ASSERT((uartDMAEvents.count == 1));
+
+	/* First buffer is full, DMA switched to second one */
+	SetDMARemaining(LPC_GPDMACH1, sizeof(buffer1));
+	LPC_GPDMA->DMACIntTCStat = (1 << 1);
+	POS_DMA_IRQHandler();
+	LPC_GPDMA->DMACIntTCStat = 0;
+	TEST_ASSERT((uartDMAEvents.count == 2));
+	TEST_ASSERT((uartDMAEvents.event[1] == DRV_UART_DMA_EVENT_BUFFER_FULL));
+	TEST_ASSERT((uartDMAEvents.data[1] == &buffer0[10]));
+	TEST_ASSERT((uartDMAEvents.length[1] == sizeof(buffer0) - 10));
+
+	/* Second buffer is full but not served yet when line becomes idle */
+	SetDMARemaining(LPC_GPDMACH1, sizeof(buffer0) - 2);
+	LPC_GPDMA->DMACIntTCStat = (1 << 1);
+	POS_UART1_IRQHandler();
+	LPC_GPDMA->DMACIntTCStat = 0;
+	TEST_ASSERT((uartDMAEvents.count == 4));
+	TEST_ASSERT((uartDMAEvents.event[2] == DRV_UART_DMA_EVENT_BUFFER_FULL));
+	TEST_ASSERT((uartDMAEvents.data[2] == buffer1));
+	TEST_ASSERT((uartDMAEvents.length[2] == sizeof(buffer1)));
+	TEST_ASSERT((uartDMAEvents.event[3] == DRV_UART_DMA_EVENT_IDLE_LINE));
+	TEST_ASSERT((uartDMAEvents.data[3] == buffer0));
+	TEST_ASSERT((uartDMAEvents.length[3] == 2));
+
+	/* DMA Error stops reception */
+	uartDMAEvents.count = 0;
+	LPC_GPDMA->DMACIntErrStat = (1 << 1);
+	POS_DMA_IRQHandler();
+	LPC_GPDMA->DMACIntErrStat = 0;
+	TEST_ASSERT((uartDMAEvents.count == 1));
+	TEST_ASSERT((uartDMAEvents.event[0] == DRV_UART_DMA_EVENT_ERROR));
+	TEST_ASSERT((LPC_GPDMACH1->DMACCConfig == 0));
+	TEST_ASSERT((LPC_UART1->FCR & UART_FCR_DMA_MODE) == 0);
+
+	/* Restart and stop */
+	TEST_ASSERT((Drv_UART_StartDMAReceive(uart, buffer0, buffer1, sizeof(buffer0), UARTDMAEvent) == RESULT_SUCCESS));
+	Drv_UART_StopDMAReceive(uart);
+	TEST_ASSERT((uarts[1].dmaReceiver.eventHandler == NULL));
+	TEST_ASSERT((LPC_GPDMACH1->DMACCConfig == 0));
+
+	Drv_UART_Release(uart);
+}
+
+/*
+ * Tests baud rate calculation with fractional divider.
+ *  High baud rates must be generated in tolerance and baud rate must not be
+ *  changed while sending.
+ */
+void test_UART_BaudRate(void)
+{
+	UartHandle uart;
+	uint8_t data = 0x55;
+
+	Drv_UART_Init();
+
+	/* Out of range baud rates */
+	TEST_ASSERT((Drv_UART_Get(2, 0, NULL) == DRV_UART_INVALID_HANDLER));
+	TEST_ASSERT((Drv_UART_Get(2, 3000000, NULL) == DRV_UART_INVALID_HANDLER));
+
+	/* Integer divisor is enough : 100 MHz / (16 x 651) = 9600 */
+	uart = Drv_UART_Get(2, 9600, NULL);
+	TEST_ASSERT((uart == 2));
+	TEST_ASSERT((LPC_UART2->DLM == 0x02));
+	TEST_ASSERT((LPC_UART2->DLL == 0x8B));
+	TEST_ASSERT((LPC_UART2->FDR == UART_FDR_VALUE(0, 1)));
+	TEST_ASSERT((LPC_SC->PCLKSEL1 == STARTUP_PCLKSEL1));
+
+	/* Step up : 100 MHz / (16 x 5 x (1 + 5 / 14)) = 921052 (0.06%) */
+	LPC_UART2->LSR = UART_LSR_TEMT;
+	TEST_ASSERT((Drv_UART_SetBaudRate(uart, 921600) == RESULT_SUCCESS));
+	TEST_ASSERT((LPC_UART2->DLM == 0));
+	TEST_ASSERT((LPC_UART2->DLL == 5));
+	TEST_ASSERT((LPC_UART2->FDR == UART_FDR_VALUE(5, 14)));
+	TEST_ASSERT((LPC_UART2->LCR == UART_LCR_WLEN8));
+
+	/* Can not be changed while sending */
+	LPC_UART2->LSR = 0;
+	(void)Drv_UART_Send(uart, &data, 1);
+	TEST_ASSERT(!Drv_UART_IsSendCompleted(uart));
+	TEST_ASSERT((Drv_UART_SetBaudRate(uart, 115200) == RESULT_FAIL));
+
+	/* Out of tolerance */
+	LPC_UART2->LSR = UART_LSR_TEMT | UART_LSR_THRE;
+	POS_UART2_IRQHandler();
+	TEST_ASSERT(Drv_UART_IsSendCompleted(uart));
+	TEST_ASSERT((Drv_UART_SetBaudRate(uart, 3000000) == RESULT_FAIL));
+	TEST_ASSERT((LPC_UART2->DLL == 5));
+
+	Drv_UART_Release(uart);
+	TEST_ASSERT((Drv_UART_SetBaudRate(uart, 115200) == RESULT_FAIL));
+}
+
+/*
+ * Tests CPU Clock level initialization.
+ *  Lower levels are derived from PLL0 output and startup clock is highest
+ *  level.
+ */
+void test_Clock_Init(void)
+{
+	SetStartupClock();
+
+	Drv_Clock_Init();
+	TEST_ASSERT((Drv_Clock_GetNumOfLevels() == 4));
+	TEST_ASSERT((Drv_Clock_GetLevel() == 3));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(0) == 20000000));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(1) == 40000000));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(2) == 80000000));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(3) == 100000000));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(4) == 0));
+
+	/* CPU is clocked by oscillator (PLL0 is not connected), no lower level */
+	LPC_SC->PLL0STAT = CLOCK_PLL0STAT_ENABLED;
+	LPC_SC->CCLKCFG = 0;
+	SystemCoreClock = 12000000;
+
+	Drv_Clock_Init();
+	TEST_ASSERT((Drv_Clock_GetNumOfLevels() == 1));
+	TEST_ASSERT((Drv_Clock_GetLevel() == 0));
+	TEST_ASSERT((Drv_Clock_GetLevelFrequency(0) == 12000000));
+	TEST_ASSERT((Drv_Clock_SetLevel(1) == RESULT_FAIL));
+
+	SystemCoreClock = 100000000;
+}
+
+/*
+ * Tests CPU Clock level switch.
+ *  Flash wait states, Timer prescalers and UART baud divisors must follow
+ *  CPU Clock and a level must not be applied while UART is sending.
+ */
+void test_Clock_SetLevel(void)
+{
+	UARTBaudDivisors divisors;
+	UartHandle uart;
+	uint8_t data = 0x55;
+
+	memset(timers, 0, sizeof(timers));
+	Drv_UART_Init();
+	SetStartupClock();
+	Drv_Clock_Init();
+
+	/* 1 us Timer and 1 MHz Time Base : PCLK 25 MHz, PR 24 */
+	(void)Drv_Timer_Create(1, DRV_TIMER_PRI_LOW, TimerTimeout);
+	(void)Drv_Timer_InitializeTimeBase(2, DRV_TIMER_PRI_LOW, 1000000);
+	TEST_ASSERT((LPC_TIM1->PR == 24));
+	TEST_ASSERT((LPC_TIM2->PR == 24));
+
+	uart = Drv_UART_Get(2, 115200, NULL);
+	TEST_ASSERT((uart == 2));
+	LPC_UART2->LSR = UART_LSR_TEMT;
+
+	/* Time Base is in the middle of a tick */
+	LPC_TIM2->PC = 12;
+	TEST_ASSERT((LPC_TIM2->TCR == TIM_ENABLE));
+
+	/* Slow down to 20 MHz : PCLK 5 MHz, PR 4, 1 flash clock */
+	TEST_ASSERT((Drv_Clock_SetLevel(0) == RESULT_SUCCESS));
+	TEST_ASSERT((Drv_Clock_GetLevel() == 0));
+	TEST_ASSERT((SystemCoreClock == 20000000));
+	TEST_ASSERT((LPC_SC->CCLKCFG == 19));
+	TEST_ASSERT((LPC_SC->FLASHCFG == 0x03A));
+	TEST_ASSERT((LPC_TIM1->PR == 4));
+	TEST_ASSERT((LPC_TIM2->PR == 4));
+	TEST_ASSERT((LPC_TIM2->PC == 2));
+	TEST_ASSERT((LPC_TIM2->TCR == TIM_ENABLE));
+	TEST_ASSERT((LPC_TIM1->TCR == 0));
+
+	/* Baud rate is kept */
+	TEST_ASSERT(CalculateBaudDivisors(20000000, 115200, &divisors));
+	TEST_ASSERT((LPC_UART2->DLL == (uint8_t)divisors.divisor));
+	TEST_ASSERT((LPC_UART2->DLM == (uint8_t)(divisors.divisor >> 8)));
+	TEST_ASSERT((LPC_UART2->FDR == divisors.fractionalDivider));
+
+	/* Speed up to 80 MHz : PCLK 20 MHz, PR 19, 4 flash clocks */
+	TEST_ASSERT((Drv_Clock_SetLevel(2) == RESULT_SUCCESS));
+	TEST_ASSERT((SystemCoreClock == 80000000));
+	TEST_ASSERT((LPC_SC->CCLKCFG == 4));
+	TEST_ASSERT((LPC_SC->FLASHCFG == ((3 << CLOCK_FLASHTIM_POS) | 0x03A)));
+	TEST_ASSERT((LPC_TIM1->PR == 19));
+	TEST_ASSERT((LPC_TIM2->PR == 19));
+
+	/* Can not be changed while sending */
+	LPC_UART2->LSR = 0;
+	(void)Drv_UART_Send(uart, &data, 1);
+	TEST_ASSERT((Drv_Clock_SetLevel(3) == RESULT_FAIL));
+	TEST_ASSERT((Drv_Clock_GetLevel() == 2));
+	TEST_ASSERT((LPC_SC->CCLKCFG == 4));
+	TEST_ASSERT((LPC_TIM1->PR == 19));
+
+	LPC_UART2->LSR = UART_LSR_TEMT | UART_LSR_THRE;
+	POS_UART2_IRQHandler();
+	Drv_UART_Release(uart);
+
+	/* Same level and invalid level */
+	TEST_ASSERT((Drv_Clock_SetLevel(2) == RESULT_SUCCESS));
+	TEST_ASSERT((Drv_Clock_SetLevel(4) == RESULT_FAIL));
+
+	/* Timer ticks can not be kept if PCLK is not a multiple of 1 MHz */
+	TEST_ASSERT(!Drv_Timer_IsCPUFrequencySupported(30000000));
+
+	/* Back to startup clock */
+	TEST_ASSERT((Drv_Clock_SetLevel(3) == RESULT_SUCCESS));
+	TEST_ASSERT((SystemCoreClock == 100000000));
+	TEST_ASSERT((LPC_SC->FLASHCFG == ((4 << CLOCK_FLASHTIM_POS) | 0x03A)));
+	TEST_ASSERT((LPC_TIM2->PR == 24));
+}
+
+/*
+ * Tests power and clock control of peripherals.
+ *  PCLKSEL must not be written while PLL0 is connected.
+ */
+void test_Clock_EnablePeripheral(void)
+{
+	SetStartupClock();
+	LPC_SC->PCONP = 0;
+
+	Drv_Clock_EnablePeripheral(Peripheral_SSP0);
+	Drv_Clock_EnablePeripheral(Peripheral_UART2);
+	TEST_ASSERT((LPC_SC->PCONP == (CLKPWR_PCONP_PCSSP0 | CLKPWR_PCONP_PCUART2)));
+	TEST_ASSERT((LPC_SC->PCLKSEL0 == STARTUP_PCLKSEL0));
+	TEST_ASSERT((LPC_SC->PCLKSEL1 == STARTUP_PCLKSEL1));
+
+	Drv_Clock_DisablePeripheral(Peripheral_SSP0);
+	TEST_ASSERT((LPC_SC->PCONP == CLKPWR_PCONP_PCUART2));
+
+	/* Clock is selected if CPU is clocked by oscillator */
+	LPC_SC->PLL0STAT = CLOCK_PLL0STAT_ENABLED;
+	LPC_SC->PCLKSEL0 = 0xFFFFFFFF;
+	LPC_SC->PCLKSEL1 = 0xFFFFFFFF;
+
+	Drv_Clock_EnablePeripheral(Peripheral_SPI);
+	Drv_Clock_EnablePeripheral(Peripheral_UART3);
+	TEST_ASSERT((CLKPWR_PCLKSEL_GET(CLKPWR_PCLKSEL_SPI, LPC_SC->PCLKSEL0) == CLKPWR_PCLKSEL_CCLK_DIV_4));
+	TEST_ASSERT((CLKPWR_PCLKSEL_GET((CLKPWR_PCLKSEL_UART3 - 32), LPC_SC->PCLKSEL1) == CLKPWR_PCLKSEL_CCLK_DIV_1));
+	TEST_ASSERT((LPC_SC->PCLKSEL0 == (uint32_t)~CLKPWR_PCLKSEL_BITMASK(CLKPWR_PCLKSEL_SPI)));
+
+	/* RTC is powered without Peripheral Clock */
+	Drv_Clock_EnablePeripheral(Peripheral_RTC);
+	TEST_ASSERT((LPC_SC->PCONP & CLKPWR_PCONP_PCRTC));
+
+	/* Unknown peripheral */
+	Drv_Clock_EnablePeripheral(Peripheral_NumOfPeripherals);
+	TEST_ASSERT((LPC_SC->PCONP == (CLKPWR_PCONP_PCUART2 | CLKPWR_PCONP_PCSPI |
+								   CLKPWR_PCONP_PCUART3 | CLKPWR_PCONP_PCRTC)));
+}
@@ -301,8 +301,9 @@
 #define PLL1CFG_Val           0x00000023
 #define CCLKCFG_Val           0x00000003
 #define USBCLKCFG_Val         0x00000000
-#define PCLKSEL0_Val          0x00000000
-#define PCLKSEL1_Val          0x00000000
+/* UART0~3 are clocked by CCLK (see Drv_UART.c), others by CCLK / 4 */
+#define PCLKSEL0_Val          0x00000140
+#define PCLKSEL1_Val          0x00050000
 #define PCONP_Val             0x042887DE
 #define CLKOUTCFG_Val         0x00000000
 
@@ -19,9 +19,11 @@
 #*****************************************************************************/
 
 #
-# Get all source files (.c files) using 'find' command except UnitTest folder
+# Get all source files (.c and .cpp files) using 'find' command except UnitTest folder
 #
-CPU_SRC_FILES := $(CPU_PATH)/internal/startup_ARMCM3.s $(shell /usr/bin/find $(CPU_PATH) -mindepth 0 -maxdepth 3 -name "*.c" ! -path "*UnitTest*")
+CPU_SRC_FILES := $(CPU_PATH)/internal/startup_ARMCM3.s $(shell /usr/bin/find $(CPU_PATH) -mindepth 0 -maxdepth 3 \( -name "*.c" -o -name "*.cpp" \) ! -path "*UnitTest*")
 
+# CPU path is for C++ HAL headers (Drv_GPIO.hpp, Drv_Timer.hpp)
 MODULE_INC_PATHS += \
+	-I$(CPU_PATH) \
 	-I$(CPU_PATH)/internal
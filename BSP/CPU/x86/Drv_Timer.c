@@ -26,3 +26,79 @@ uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
 {
 	return 0;
 }
+
+void Drv_Timer_Stop(TimerHandle timerHandle)
+{
+
+}
+
+TimerHandle Drv_Timer_CreatePeriodic(TimerNo timerNo,
+	DrvTimerPriority priority,
+	DrvTimerCallback timerCallback)
+{
+	return DRV_TIMER_INVALID_HANDLE;
+}
+
+void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs)
+{
+
+}
+
+void Drv_Timer_SetPeriod(TimerHandle timerHandle, uint32_t periodInUs)
+{
+
+}
+
+TimerHandle Drv_Timer_CreateFreeRunning(TimerNo timerNo,
+	DrvTimerPriority priority)
+{
+	return DRV_TIMER_INVALID_HANDLE;
+}
+
+void Drv_Timer_CreateChannel(TimerHandle timerHandle,
+	TimerChannel channel,
+	DrvTimerCallback channelCallback)
+{
+
+}
+
+void Drv_Timer_StartChannel(TimerHandle timerHandle,
+	TimerChannel channel,
+	uint32_t timeoutInTicks)
+{
+
+}
+
+void Drv_Timer_StartChannelAt(TimerHandle timerHandle,
+	TimerChannel channel,
+	uint32_t tick)
+{
+
+}
+
+void Drv_Timer_StopChannel(TimerHandle timerHandle, TimerChannel channel)
+{
+
+}
+
+TimerHandle Drv_Timer_InitializeTimeBase(TimerNo timerNo,
+	DrvTimerPriority priority,
+	uint32_t frequency)
+{
+	return DRV_TIMER_INVALID_HANDLE;
+}
+
+uint64_t Drv_Timer_ReadTimeBase(void)
+{
+	return 0;
+}
+
+uint32_t Drv_Timer_GetTimeBaseFrequency(void)
+{
+	return 0;
+}
+
+uint64_t Drv_Timer_ReadTimeBaseInUs(void)
+{
+	return 0;
+}
@@ -113,3 +113,19 @@ int32_t Drv_UART_Receive(UartHandle uart, uint8_t* receiveBuffer, uint32_t recei
 
 	return msgLeng;
 }
+
+int32_t Drv_UART_Send(UartHandle uart, uint8_t* sendBuffer, uint32_t sendLength)
+{
+	/* Simulation has no host, just drop data */
+	return (int32_t)sendLength;
+}
+
+int32_t Drv_UART_SetBaudRate(UartHandle uart, uint32_t baudRate)
+{
+	return RESULT_SUCCESS;
+}
+
+bool Drv_UART_IsSendCompleted(UartHandle uart)
+{
+	return true;
+}
@@ -45,6 +45,42 @@
 /* Buffer size for flash writes */
 #define BL_UPGRADE_FLASH_WRITE_BUFFER_SIZE          (4 * 1024)
 
+/* Buffer size for UART data */
+#define BL_UPGRADE_RECEIVE_BUFFER_SIZE				(256)
+
+/*
+ * Baud Rate Negotiation
+ *
+ *  Upgrade starts with base baud rate (BL_FW_UPGRADE_UART_BAUD_RATE) and
+ *  host can step up to highest rate which both sides support :
+ *
+ *    Device -> Host : "!BAUD 115200 230400 460800 921600"  (supported rates)
+ *    Host -> Device : "!BAUD 921600"                       (selected rate)
+ *    Device -> Host : "!ACK 921600" or "!NAK"              (at old rate)
+ *      Both sides switch to selected rate
+ *    Host -> Device : "!SYNC"                              (at new rate)
+ *    Device -> Host : "!ACK"                               (at new rate)
+ *
+ *  All lines end with "\r\n". If SYNC is not received in timeout, device
+ *  returns back to base rate (and host should do same if it does not receive
+ *  ACK). If host does not send a negotiation line (e.g. it sends Intel HEX
+ *  directly), received data is kept for image upload.
+ */
+#define BL_BAUD_NEGOTIATION_TIMEOUT_IN_MS			(200)
+
+/* Negotiation lines start with this character which is not a Intel HEX prefix */
+#define BL_BAUD_NEGOTIATION_PREFIX					'!'
+
+/* Negotiation Messages */
+#define BL_BAUD_MSG_BAUD							"!BAUD"
+#define BL_BAUD_MSG_ACK								"!ACK"
+#define BL_BAUD_MSG_NAK								"!NAK"
+#define BL_BAUD_MSG_SYNC							"!SYNC"
+#define BL_BAUD_MSG_LINE_END						"\r\n"
+
+/* Max length of a negotiation line */
+#define BL_BAUD_NEGOTIATION_LINE_SIZE				(64)
+
 /* Convert Big-Endian Array to Integer Value */
 #define CONVERT_BE_ARRAY_TO_INT(arr) \
 			((arr)[0] << 24) | ((arr)[1] << 16) | ((arr)[2] << 8) | ((arr)[3])
@@ -79,6 +115,22 @@ typedef struct
 /* Upgrade module internal settings */
 PRIVATE FWUpgradeSettings upgradeSettings;
 
+/*
+ * Buffer for received UART data.
+ *  It is shared by baud rate negotiation and image upload so data which is
+ *  received during negotiation is not lost.
+ */
+PRIVATE uint8_t recvBuffer[BL_UPGRADE_RECEIVE_BUFFER_SIZE];
+
+/* Length of unprocessed data in receive buffer */
+PRIVATE int32_t recvBufferLength;
+
+/* Baud Rates which can be negotiated (ascending order) */
+PRIVATE const uint32_t negotiableBaudRates[] =
+{
+	115200, 230400, 460800, 921600
+};
+
 /* Block data buffer for flash writes */
 PRIVATE uint8_t blockData[BL_UPGRADE_FLASH_WRITE_BUFFER_SIZE] = { 0 };
 
@@ -245,13 +297,13 @@ intelhex_process_err:
 PRIVATE BLStatusCode ProcessMessageImageUpload(void)
 {
 	BLStatusCode status;
-	uint8_t recvBuffer[256];
 	IntelHexLine intelHexLine;
 	int32_t recvDataLen = 0;
-	int32_t dataLength = 0;
+	/* Continue with data which is left from baud rate negotiation */
+	int32_t dataLength = recvBufferLength;
 	IntelHexStatusCode ihRetVal;
 	uint32_t parsedLineLength;
-	int32_t offset = 0;
+	int32_t offset = recvBufferLength;
 	bool eof = false;
 
 	/* Initialize flags at the beginning of upgrade transaction */
@@ -276,7 +328,7 @@ PRIVATE BLStatusCode ProcessMessageImageUpload(void)
 			 * Concatanate received data using offset to continue incomplete
 			 * intel HEX data.
 			 */
-			recvDataLen = Drv_UART_Receive(upgradeSettings.uartHandle, &recvBuffer[offset], sizeof(recvBuffer) - offset);
+			recvDataLen = Drv_UART_Receive(upgradeSettings.uartHandle, &recvBuffer[offset], sizeof(recvBuffer) - 1 - offset);
 			if (recvDataLen < 0) continue;
 
 			/* Increase total dta size */
@@ -425,8 +477,7 @@ PRIVATE ALWAYS_INLINE BLStatusCode InitializeBLUpgradeModule(void)
 	}
 #endif /* #if BL_DEBUG_MODE */
 
-	/* TODO Get configuration from project config */
-	upgradeSettings.uartHandle = Drv_UART_Get(BL_FW_UPGRADE_UART_NO, 115200, DataReceivedEventHandler);
+	upgradeSettings.uartHandle = Drv_UART_Get(BL_FW_UPGRADE_UART_NO, BL_FW_UPGRADE_UART_BAUD_RATE, DataReceivedEventHandler);
 
 #if BL_DEBUG_MODE
 	if (DRV_UART_INVALID_HANDLER == upgradeSettings.uartHandle)
@@ -464,6 +515,281 @@ PRIVATE ALWAYS_INLINE void DeInitializeBLUpgradeModule(void)
 	Drv_Timer_Release(upgradeSettings.timeoutTimerHandle);
 }
 
+/*
+ * Writes decimal string of a value.
+ *
+ * @param buffer Buffer to write digits
+ * @param value Value to format
+ *
+ * @return Number of written digits
+ */
+PRIVATE uint32_t FormatDecimal(char* buffer, uint32_t value)
+{
+	char digits[10];
+	uint32_t numOfDigits = 0;
+	uint32_t i;
+
+	do
+	{
+		digits[numOfDigits++] = (char)('0' + (value % 10));
+		value /= 10;
+	} while (value > 0);
+
+	for (i = 0; i < numOfDigits; i++)
+	{
+		buffer[i] = digits[numOfDigits - 1 - i];
+	}
+
+	return numOfDigits;
+}
+
+/*
+ * Parses a decimal string.
+ *
+ * @param str String which includes only digits
+ * @return Parsed value or zero if string is not a valid decimal
+ */
+PRIVATE uint32_t ParseDecimal(const char* str)
+{
+	uint32_t value = 0;
+
+	if (*str == '\0')
+	{
+		return 0;
+	}
+
+	while (*str != '\0')
+	{
+		if ((*str < '0') || (*str > '9') || (value > (UINT32_MAX / 10)))
+		{
+			return 0;
+		}
+
+		value = (value * 10) + (uint32_t)(*str - '0');
+		str++;
+	}
+
+	return value;
+}
+
+/*
+ * Checks whether a baud rate can be negotiated
+ */
+PRIVATE bool IsNegotiableBaudRate(uint32_t baudRate)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(negotiableBaudRates) / sizeof(negotiableBaudRates[0]); i++)
+	{
+		if ((negotiableBaudRates[i] == baudRate) &&
+			(baudRate <= BL_FW_UPGRADE_UART_MAX_BAUD_RATE))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Sends a negotiation message and waits until it is sent out.
+ *
+ * @param message Negotiation message
+ * @param baudRate Baud Rate to append message. Zero to send only message.
+ */
+PRIVATE void SendNegotiationMessage(const char* message, uint32_t baudRate)
+{
+	char line[BL_BAUD_NEGOTIATION_LINE_SIZE];
+	uint32_t length;
+
+	length = strlen(message);
+	memcpy(line, message, length);
+
+	if (baudRate != 0)
+	{
+		line[length++] = ' ';
+		length += FormatDecimal(&line[length], baudRate);
+	}
+
+	memcpy(&line[length], BL_BAUD_MSG_LINE_END, sizeof(BL_BAUD_MSG_LINE_END) - 1);
+	length += sizeof(BL_BAUD_MSG_LINE_END) - 1;
+
+	(void)Drv_UART_Send(upgradeSettings.uartHandle, (uint8_t*)line, length);
+
+	/* Baud Rate may be changed just after message so wait until it is sent */
+	while (!Drv_UART_IsSendCompleted(upgradeSettings.uartHandle));
+}
+
+/*
+ * Sends supported baud rates to host.
+ */
+PRIVATE void SendSupportedBaudRates(void)
+{
+	char line[BL_BAUD_NEGOTIATION_LINE_SIZE];
+	uint32_t length;
+	uint32_t i;
+
+	length = sizeof(BL_BAUD_MSG_BAUD) - 1;
+	memcpy(line, BL_BAUD_MSG_BAUD, length);
+
+	for (i = 0; i < sizeof(negotiableBaudRates) / sizeof(negotiableBaudRates[0]); i++)
+	{
+		if (IsNegotiableBaudRate(negotiableBaudRates[i]))
+		{
+			line[length++] = ' ';
+			length += FormatDecimal(&line[length], negotiableBaudRates[i]);
+		}
+	}
+
+	memcpy(&line[length], BL_BAUD_MSG_LINE_END, sizeof(BL_BAUD_MSG_LINE_END) - 1);
+	length += sizeof(BL_BAUD_MSG_LINE_END) - 1;
+
+	(void)Drv_UART_Send(upgradeSettings.uartHandle, (uint8_t*)line, length);
+}
+
+/*
+ * Waits a negotiation line from host.
+ *  Received data is collected in receive buffer. If host does not send a
+ *  negotiation line, data is kept in receive buffer for image upload.
+ *
+ * @param line Buffer (BL_BAUD_NEGOTIATION_LINE_SIZE) to copy received line
+ *        without line end
+ *
+ * @return true if a negotiation line is received in timeout
+ */
+PRIVATE bool ReceiveNegotiationLine(char* line)
+{
+	bool received = false;
+
+	upgradeSettings.flags.upgradeTimeout = false;
+	Drv_Timer_Start(upgradeSettings.timeoutTimerHandle, BL_BAUD_NEGOTIATION_TIMEOUT_IN_MS * 1000);
+
+	while (!upgradeSettings.flags.upgradeTimeout)
+	{
+		char* lineEnd;
+
+		if (upgradeSettings.flags.dataReceived)
+		{
+			int32_t recvDataLen;
+
+			upgradeSettings.flags.dataReceived = false;
+
+			recvDataLen = Drv_UART_Receive(upgradeSettings.uartHandle,
+										   &recvBuffer[recvBufferLength],
+										   sizeof(recvBuffer) - 1 - recvBufferLength);
+			if (recvDataLen > 0)
+			{
+				recvBufferLength += recvDataLen;
+			}
+		}
+
+		if (recvBufferLength == 0)
+		{
+			continue;
+		}
+
+		if (recvBuffer[0] != BL_BAUD_NEGOTIATION_PREFIX)
+		{
+			/* Host does not negotiate, keep data for image upload */
+			break;
+		}
+
+		/* Just add terminator char to guarantee string boundary */
+		recvBuffer[recvBufferLength] = '\0';
+
+		lineEnd = strchr((char*)recvBuffer, '\n');
+		if (lineEnd != NULL)
+		{
+			uint32_t lineLength = lineEnd - (char*)recvBuffer;
+			uint32_t copyLength = lineLength;
+
+			if (copyLength >= BL_BAUD_NEGOTIATION_LINE_SIZE)
+			{
+				copyLength = BL_BAUD_NEGOTIATION_LINE_SIZE - 1;
+			}
+
+			/* Drop CR of line end */
+			if ((copyLength > 0) && (recvBuffer[copyLength - 1] == '\r'))
+			{
+				copyLength--;
+			}
+
+			memcpy(line, recvBuffer, copyLength);
+			line[copyLength] = '\0';
+
+			/* Remove line from receive buffer */
+			shiftBufferLeft(recvBuffer, recvBufferLength, lineLength + 1);
+			recvBufferLength -= lineLength + 1;
+
+			received = true;
+			break;
+		}
+		else if (recvBufferLength >= BL_BAUD_NEGOTIATION_LINE_SIZE)
+		{
+			/* Too long to be a negotiation line, discard it */
+			recvBufferLength = 0;
+		}
+	}
+
+	Drv_Timer_Stop(upgradeSettings.timeoutTimerHandle);
+
+	return received;
+}
+
+/*
+ * Negotiates baud rate with host (see BL_BAUD_NEGOTIATION_TIMEOUT_IN_MS for
+ * protocol). UART stays at base baud rate if host does not negotiate or
+ * negotiation fails.
+ */
+PRIVATE void NegotiateBaudRate(void)
+{
+	char line[BL_BAUD_NEGOTIATION_LINE_SIZE];
+	uint32_t baudRate;
+
+	recvBufferLength = 0;
+
+	if (BL_FW_UPGRADE_UART_MAX_BAUD_RATE <= BL_FW_UPGRADE_UART_BAUD_RATE)
+	{
+		/* Nothing to negotiate */
+		return;
+	}
+
+	SendSupportedBaudRates();
+
+	if (!ReceiveNegotiationLine(line) ||
+		(strncmp(line, BL_BAUD_MSG_BAUD " ", sizeof(BL_BAUD_MSG_BAUD)) != 0))
+	{
+		return;
+	}
+
+	baudRate = ParseDecimal(&line[sizeof(BL_BAUD_MSG_BAUD)]);
+
+	if (!IsNegotiableBaudRate(baudRate))
+	{
+		SendNegotiationMessage(BL_BAUD_MSG_NAK, 0);
+		return;
+	}
+
+	/* Acknowledge at old rate then switch */
+	SendNegotiationMessage(BL_BAUD_MSG_ACK, baudRate);
+
+	if (Drv_UART_SetBaudRate(upgradeSettings.uartHandle, baudRate) != RESULT_SUCCESS)
+	{
+		return;
+	}
+
+	/* Host must confirm new rate */
+	if (ReceiveNegotiationLine(line) && (strcmp(line, BL_BAUD_MSG_SYNC) == 0))
+	{
+		SendNegotiationMessage(BL_BAUD_MSG_ACK, 0);
+		return;
+	}
+
+	/* Host could not follow, data received at new rate is meaningless */
+	recvBufferLength = 0;
+	(void)Drv_UART_SetBaudRate(upgradeSettings.uartHandle, BL_FW_UPGRADE_UART_BAUD_RATE);
+}
+
 /***************************** PUBLIC FUNCTIONS *******************************/
 /*
  * Upgrades Firmware
@@ -482,6 +808,9 @@ BLStatusCode BL_UpgradeFirmware(void)
 	}
 #endif
 
+	/* Step up to a faster link if host supports */
+	NegotiateBaudRate();
+
 	/* Start Timeout Timer First */
 	Drv_Timer_Start(upgradeSettings.timeoutTimerHandle, BL_UPGRADE_TIMEOUT_IN_MS);
 
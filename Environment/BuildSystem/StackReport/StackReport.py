@@ -0,0 +1,105 @@
+# -*- coding: utf-8 -*-
+#
+# Stack Report
+#
+#  Parses stack usage lines (see Kernel_ReportStackUsage()) from a debug 
+#  output log and suggests stack and ramSize values for AppImageMetaDataHeader
+#  (see ImageSign/config.py) using measured stack peaks.
+#
+#  Usage : 
+#    python StackReport.py <debug log> [margin percent]
+#
+#  Expected log lines :
+#    STK Kernel Size:<bytes> Peak:<bytes>
+#    STK App:<id> Ram:<bytes> Size:<bytes> Peak:<bytes>
+#
+#  A log may include several reports (e.g. one per exception or per 
+#  OS_ReportStackUsage() call), the deepest peak of each stack is used.
+#
+import re
+import sys
+
+# Default safety margin on top of measured peak (percent)
+DEFAULT_MARGIN = 25
+
+# Stacks are 8 bytes aligned (AAPCS)
+STACK_ALIGNMENT = 8
+
+# Stack Guard Size (bottom of stack, never painted or used). 0 if stack guard is disabled
+STACK_GUARD_SIZE = 32
+
+# Smallest MPU region size, RAM sections must be power of two and at least this size
+MPU_SMALLEST_REGION_SIZE = 32
+
+kernelLine = re.compile(r'STK Kernel Size:(\d+) Peak:(\d+)')
+appLine = re.compile(r'STK App:(-?\d+) Ram:(\d+) Size:(\d+) Peak:(\d+)')
+
+def align_up(val, alignment):
+	return (val + alignment - 1) & ~(alignment - 1)
+
+def power_of_two_up(val):
+	size = MPU_SMALLEST_REGION_SIZE
+	while size < val:
+		size <<= 1
+	return size
+
+def suggest_stack_size(peak, margin):
+	return align_up(peak + (peak * margin + 99) // 100 + STACK_GUARD_SIZE, STACK_ALIGNMENT)
+
+def parse_log(logFile):
+	kernel = None
+	apps = {}
+
+	for line in logFile:
+		match = kernelLine.search(line)
+		if match:
+			size, peak = int(match.group(1)), int(match.group(2))
+			if kernel is None or peak > kernel['peak']:
+				kernel = dict(size = size, peak = peak)
+			continue
+
+		match = appLine.search(line)
+		if match:
+			appId = int(match.group(1))
+			ram, size, peak = int(match.group(2)), int(match.group(3)), int(match.group(4))
+			if appId not in apps or peak > apps[appId]['peak']:
+				apps[appId] = dict(ram = ram, size = size, peak = peak)
+
+	return kernel, apps
+
+def main():
+	if len(sys.argv) < 2:
+		print('Usage : python StackReport.py <debug log> [margin percent]')
+		sys.exit(1)
+
+	margin = DEFAULT_MARGIN
+	if len(sys.argv) > 2:
+		margin = int(sys.argv[2])
+
+	with open(sys.argv[1]) as logFile:
+		kernel, apps = parse_log(logFile)
+
+	if kernel is None and not apps:
+		print('No stack usage found in ' + sys.argv[1])
+		sys.exit(1)
+
+	print('Stack Report (margin %d%%)' % margin)
+
+	if kernel is not None:
+		stack = suggest_stack_size(kernel['peak'], margin)
+		print(' Kernel : Stack_Size 0x%X, peak 0x%X -> suggested Stack_Size 0x%X (DRV_CONFIG_MAIN_STACK_SIZE)' % 
+			  (kernel['size'], kernel['peak'], stack))
+
+	for appId in sorted(apps):
+		app = apps[appId]
+		stack = suggest_stack_size(app['peak'], margin)
+		# Stack is located at the end of RAM section, rest of section is kept as is
+		ramSize = power_of_two_up(app['ram'] - app['size'] + stack)
+		print(' App %d : Stack_Size 0x%X, peak 0x%X -> suggested Stack_Size 0x%X (OS_USER_APP_STACK_SIZE)' % 
+			  (appId, app['size'], app['peak'], stack))
+		print('         ramSize 0x%X -> suggested ramSize 0x%X' % (app['ram'], ramSize))
+
+	print('[IMP] Peaks are measured values, run all code paths before taking report.')
+
+if __name__ == '__main__':
+	main()
@@ -79,9 +79,9 @@ PROJECT_OBJS_OUT_PATH= $(PROJECT_OUT_PATH)/obj
 
 
 # Get all Kernel Source files except Unit Test files
-KERNEL_SRC_FILES := $(shell /usr/bin/find $(KERNEL_PATH) -mindepth 1 -maxdepth 6 -name "*.c" ! -path "*UnitTest*")
+KERNEL_SRC_FILES := $(shell /usr/bin/find $(KERNEL_PATH) -mindepth 1 -maxdepth 6 \( -name "*.c" -o -name "*.cpp" \) ! -path "*UnitTest*")
 # Get all Project (Application) Source files except Unit Test files
-PROJECT_SRC_FILES := $(shell /usr/bin/find $(PROJECT_PATH) -mindepth 1 -maxdepth 6 -name "*.c" ! -path "*PSoCCreator*")
+PROJECT_SRC_FILES := $(shell /usr/bin/find $(PROJECT_PATH) -mindepth 1 -maxdepth 6 \( -name "*.c" -o -name "*.cpp" \) ! -path "*PSoCCreator*")
 
 # Include CPU, Board and Kernel makefiles to get specific rules
 include $(CPU_PATH)/module.mk
@@ -113,6 +113,7 @@ BUILD_TARGET = $(PROJECT_OUT_PATH)/$(PROJECT)
 # Building depends on object (.o) files so let's get object versions of source files
 PROJECT_OBJECTS := $(SRC_FILES) # Get all source files
 PROJECT_OBJECTS := $(PROJECT_OBJECTS:.c=.o) # Convert .c extensions to .o
+PROJECT_OBJECTS := $(PROJECT_OBJECTS:.cpp=.o) # Convert .cpp extensions to .o
 PROJECT_OBJECTS := $(PROJECT_OBJECTS:.s=.o) # Convert .s extensions to .o
 
 #
@@ -152,9 +153,12 @@ default: createoutdir $(BUILD_TARGET).bin
 
 #
 # Rule to build C++ (.cpp) files
+#	C++ sources use header only HAL templates (e.g. Drv_GPIO.hpp) so RTTI is
+#	not needed (exceptions are already disabled by CC_FLAGS)
 #
 .cpp.o:
-	$(CPP) $(CC_FLAGS) $(CC_SYMBOLS) -std=gnu++98 $(INCLUDE_PATHS) -o $@ $<
+	@echo "Compile " $<
+	$(CPP) $(CC_FLAGS) $(CC_SYMBOLS) -std=gnu++98 -fno-rtti $(INCLUDE_PATHS) -o $@ $<
 
 #
 # Rule to create .ELF file
@@ -28,9 +28,36 @@
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+#if BOARD_ENABLE_LCD_INTERFACE
+
+/* LCD Resolution (Portrait, native orientation of LCD Controller) */
+#define BOARD_LCD_WIDTH				(240)
+#define BOARD_LCD_HEIGHT			(320)
+
+/* Converts 8 bit Red, Green and Blue components to LCD Colour (RGB565) */
+#define BOARD_LCD_RGB(r, g, b)		((Board_LcdColor)((((r) & 0xF8) << 8) | \
+													  (((g) & 0xFC) << 3) | \
+													  (((b) & 0xF8) >> 3)))
+
+#define BOARD_LCD_COLOR_BLACK		BOARD_LCD_RGB(0x00, 0x00, 0x00)
+#define BOARD_LCD_COLOR_WHITE		BOARD_LCD_RGB(0xFF, 0xFF, 0xFF)
+
+#endif /* BOARD_ENABLE_LCD_INTERFACE */
+
 /***************************** TYPE DEFINITIONS *******************************/
 
+#if BOARD_ENABLE_LCD_INTERFACE
+
+/* LCD Colour (RGB565) */
+typedef uint16_t Board_LcdColor;
+
+#endif /* BOARD_ENABLE_LCD_INTERFACE */
+
 /*************************** FUNCTION DEFINITIONS *****************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void Board_Init(void);
 
 /*
@@ -44,4 +71,52 @@ void Board_LedOff(uint32_t ledNo);
 
 #endif /* BOARD_ENABLE_LED_INTERFACE */
 
+/*
+ * BOARD LCD INTERFACE
+ *
+ *  Drawing functions do not access LCD. They update a RAM copy of changed
+ *  screen regions and Board_LcdFlush() sends only changed regions to LCD.
+ *  So a client can redraw its whole frame but only changed pixels use bus.
+ *  Coordinates out of screen are clipped.
+ */
+#if BOARD_ENABLE_LCD_INTERFACE
+
+/*
+ * Initializes LCD and clears screen (black).
+ */
+void Board_LcdInit(void);
+
+/*
+ * Sets a pixel.
+ */
+void Board_LcdSetPixel(uint32_t x, uint32_t y, Board_LcdColor color);
+
+/*
+ * Fills a rectangle with a colour.
+ */
+void Board_LcdFillRect(uint32_t x, uint32_t y,
+					   uint32_t width, uint32_t height,
+					   Board_LcdColor color);
+
+/*
+ * Draws a bitmap.
+ *
+ * @param pixels Pixels of bitmap in row major order (width * height pixels)
+ */
+void Board_LcdDrawBitmap(uint32_t x, uint32_t y,
+						 uint32_t width, uint32_t height,
+						 const Board_LcdColor* pixels);
+
+/*
+ * Sends changed regions since last flush to LCD.
+ *  Should be called once per frame after drawing.
+ */
+void Board_LcdFlush(void);
+
+#endif /* BOARD_ENABLE_LCD_INTERFACE */
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif	/* __BOARD_H */
@@ -23,8 +23,124 @@
 /********************************* INCLUDES ***********************************/
 #include "postypes.h"
 
+#include "DRVConfig.h"
+
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Interrupt Priorities
+ *
+ *  NVIC implements DRV_IRQ_PRIORITY_BITS priority bits. These bits are split
+ *  into preempt (group) priority and sub priority. Only preempt priority
+ *  decides whether an interrupt preempts running one. Sub priority just orders
+ *  pending interrupts which have same preempt priority so frequent interrupts
+ *  can be grouped to avoid needless nesting. Lower value is higher priority.
+ */
+#define DRV_IRQ_PRIORITY_BITS							(5)
+
+/*
+ * Number of preempt priority bits. Rest of priority bits are sub priority
+ * bits. All bits are preempt bits as default (no sub priority).
+ */
+#ifndef DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS
+#define DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS			(DRV_IRQ_PRIORITY_BITS)
+#endif /* DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS */
+
+#if (DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS < 1) || \
+	(DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS > DRV_IRQ_PRIORITY_BITS)
+#error "DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS must be in range of 1~5!"
+#endif
+
+/* Number of sub priority bits */
+#define DRV_IRQ_SUB_PRIORITY_BITS \
+			(DRV_IRQ_PRIORITY_BITS - DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS)
+
+/* Lowest preempt and sub priorities */
+#define DRV_IRQ_LOWEST_PREEMPT_PRIORITY	((1 << DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS) - 1)
+#define DRV_IRQ_LOWEST_SUB_PRIORITY		((1 << DRV_IRQ_SUB_PRIORITY_BITS) - 1)
+
+/*
+ * (Comment from FreeRTOS)
+ * !!!! configMAX_SYSCALL_INTERRUPT_PRIORITY must not be set to zero !!!!
+ *
+ *  See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html.
+ *
+ *  Critical sections raise BASEPRI to this level so interrupts with a higher
+ *  (numerically lower) priority keep running in a critical section.
+ */
+#define MAX_SYSCALL_INTERRUPT_PRIORITY 					(191) /* 0xBF, NVIC keeps 5 MSBs (0xB8) : priority 23 of 0~31 */
+
+/*
+ * Highest preempt priority which is masked by critical sections. BASEPRI
+ * masks interrupts by their preempt priority only.
+ */
+#define DRV_IRQ_SYSCALL_PREEMPT_PRIORITY \
+			(MAX_SYSCALL_INTERRUPT_PRIORITY >> (8 - DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS))
+
+/*
+ * Checks whether an interrupt with specified preempt priority is masked by
+ * critical sections. Only such interrupts can use OS/Driver services.
+ * Can be used in preprocessor checks (#if).
+ */
+#define DRV_IRQ_IS_KERNEL_AWARE(preemptPriority) \
+			((preemptPriority) >= DRV_IRQ_SYSCALL_PREEMPT_PRIORITY)
+
+/*
+ * Checks whether an interrupt with specified preempt priority is in Zero 
+ * Latency Tier. These interrupts are above MAX_SYSCALL_INTERRUPT_PRIORITY so
+ * critical sections never mask them and they see no jitter from OS/Driver 
+ * activity. In return, they must not use services which are protected by 
+ * critical sections (see Kernel_ZeroLatency.h). 
+ * Can be used in preprocessor checks (#if).
+ */
+#define DRV_IRQ_IS_ZERO_LATENCY(preemptPriority) \
+			(!DRV_IRQ_IS_KERNEL_AWARE(preemptPriority))
+
+/*
+ * Enables RAM Vector Table.
+ *  When enabled, vector table is copied into RAM at CPU initialization and
+ *  VTOR is pointed to RAM copy so interrupt handlers can be installed at run
+ *  time (see Drv_CPUCore_SetIRQHandler). Drivers install their handlers
+ *  directly (e.g. a dedicated handler for one shot Timers).
+ */
+#ifndef DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE
+#define DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE				(0)
+#endif /* DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE */
+
+/*
+ * Enables IRQ Latency Statistics.
+ *  When enabled, DWT Cycle Counter is started on CPU initialization and 
+ *  interrupt handlers (Timers and PendSV) record time between raising of 
+ *  interrupt and start of their handler. See IRQLatencyStats.
+ */
+#ifndef DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+#define DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS				(0)
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
+/* Maximum number of interrupts which latencies are recorded */
+#ifndef DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES
+#define DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES			(8)
+#endif /* DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES */
+
+/* Number of (logarithmic) buckets of IRQ Latency Histogram */
+#define DRV_IRQ_LATENCY_NUM_OF_BUCKETS					(16)
+
+/*
+ * Number of highest preempt priorities (0 ~ value - 1) which stay enabled 
+ * while flash is programmed (see Drv_CPUCore_EnterFlashProgramming).
+ *  0 disables all interrupts during flash programming. Otherwise, lower 
+ *  priorities are masked using BASEPRI and interrupts of kept priorities run
+ *  during flash programming. Kept priorities must be in Zero Latency Tier 
+ *  and RAM Vector Table must be enabled.
+ *
+ *  [IMP] Handlers of kept interrupts and everything they use (functions, 
+ *  constants) must be in RAM (see RAM_FUNCTION) because flash cannot be 
+ *  read while it is programmed.
+ */
+#ifndef DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES
+#define DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES			(0)
+#endif /* DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES */
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*
@@ -50,9 +166,98 @@ typedef enum
 	Exception_DivideByZero = 10,
 	Exception_CodeAccessViolation,
 	Exception_DataAccessViolation,
-	Exception_AccessViolation
+	Exception_AccessViolation,
+	Exception_StackOverflow
 } Exception;
 
+/*
+ * Memory Region
+ *  Describes a memory (or peripheral register) window which an application 
+ *  is allowed to access. 
+ *
+ *  [IMP] Size must be a power of two (at least 32 bytes) and start address
+ *  must be aligned with size. See Drv_CPUCore_MPUIsValidRegion().
+ */
+typedef struct
+{
+	uint32_t startAddress;
+	uint32_t size;
+
+	struct
+	{
+		/* Application can write to region, otherwise region is read only */
+		uint32_t writable : 1;
+		/* Application can execute code from region */
+		uint32_t executable : 1;
+	} flags;
+} MemoryRegion;
+
+/*
+ * CPU Peripherals
+ *  Register block of a peripheral can be granted to an (unprivileged) 
+ *  application as a memory region. See Drv_CPUCore_GetPeripheralRegion().
+ */
+typedef enum
+{
+	Peripheral_Timer0 = 0,
+	Peripheral_Timer1,
+	Peripheral_Timer2,
+	Peripheral_Timer3,
+	Peripheral_UART0,
+	Peripheral_UART1,
+	Peripheral_UART2,
+	Peripheral_UART3,
+	Peripheral_I2C0,
+	Peripheral_I2C1,
+	Peripheral_I2C2,
+	Peripheral_SPI,
+	Peripheral_SSP0,
+	Peripheral_SSP1,
+	Peripheral_PWM1,
+	Peripheral_ADC,
+	Peripheral_DAC,
+	Peripheral_RTC,
+	Peripheral_QEI,
+	
+	Peripheral_NumOfPeripherals
+} Peripheral;
+
+/*
+ * Stack Usage
+ *  Unused part of a stack is painted with a known pattern so deepest point
+ *  (High-Water Mark) of stack can be found later by looking for first 
+ *  overwritten word. 
+ */
+typedef struct
+{
+	/* Size of stack area in bytes */
+	uint32_t size;
+	/* Maximum number of bytes which is used since stack is painted */
+	uint32_t maxUsage;
+} StackUsage;
+
+/*
+ * IRQ Latency Statistics
+ *  Latency is number of CPU cycles between raising of an interrupt (e.g. 
+ *  timer match or pending PendSV) and start of its handler. 
+ *
+ *  Histogram is logarithmic. Bucket N counts latencies in range of 
+ *  [2^N, 2^(N+1)) cycles. First bucket also counts zero latency and last 
+ *  bucket also counts all greater latencies.
+ */
+typedef struct
+{
+	/* IRQ Number (CMSIS IRQn numbering, negative for system exceptions) */
+	int32_t irqNo;
+	/* Number of recorded interrupts */
+	uint32_t count;
+	/* Minimum and Maximum latencies in CPU cycles */
+	uint32_t minLatency;
+	uint32_t maxLatency;
+	/* Latency Histogram */
+	uint32_t histogram[DRV_IRQ_LATENCY_NUM_OF_BUCKETS];
+} IRQLatencyStats;
+
 /*
  * Task Control Block (TCB)
  *
@@ -79,6 +284,30 @@ typedef struct
 	
 	uint32_t codeStartAddress;
 	uint32_t codeSize;
+
+	/*
+	 * Stack area of task (lowest address and size).
+	 *  Used to place a guard region at the bottom of stack so a stack overflow
+	 *  is caught by MPU before it corrupts neighbour data.
+	 */
+	uint32_t stackStartAddress;
+	uint32_t stackSize;
+
+	/*
+	 * Additional memory regions of task. 
+	 *  MPU has limited number of regions so these regions are not loaded 
+	 *  during context switching. A region is loaded on first access (when MPU
+	 *  faults) and an older region is evicted if there is no free MPU region.
+	 */
+	const MemoryRegion* memoryRegions;
+	uint32_t numOfMemoryRegions;
+
+	/*
+	 * Critical Section Nesting Count of task.
+	 *  Saved and restored on context switching so each task has its own 
+	 *  critical section state (BASEPRI).
+	 */
+	uint32_t criticalNesting;
 	
 	/*
 	 * Task Specific Flags
@@ -99,6 +328,24 @@ typedef struct
  */
 typedef TCB* (*Drv_CPUCore_CSGetNextTCBCallback)(void);
 
+/*
+ * System Call Handler of upper layer (e.g. Kernel).
+ *  Runs in SVC Handler (privileged) on behalf of calling task.
+ *
+ * @param callNo System Call Number
+ * @param arg0 First Argument of call
+ * @param arg1 Second Argument of call
+ * @param arg2 Third Argument of call
+ *
+ * @return Result of System Call which is returned to caller
+ */
+typedef uint32_t (*SystemCallHandler)(uint32_t callNo, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+/*
+ * Interrupt Handler which is placed into vector table.
+ */
+typedef void (*IRQHandler)(void);
+
 /*
  * Prinout Callback
  *  When upper layer decided to print stack content, it also provide a printer
@@ -149,6 +396,11 @@ typedef void (*StackDumpCallback)(PrintOutCallback printOut);
  *			Check 'val' value for unathorized data address for unpriviliged 
  *			app. Check also PC value in stuck dump to get where makes this 
  *			access.
+ *
+ *		  - Exception_StackOverflow : 
+ *			Stack of task grew into its guard region. 'val' keeps faulty 
+ *			address if it is known, otherwise it is zero (e.g. overflow 
+ *			during exception stacking).
  *						
  * 
  */
@@ -208,6 +460,82 @@ void Drv_CPUCore_EnableInterrupts(void);
  */
 void Drv_CPUCore_DisableInterrupts(void);
 
+/*
+ * Sleeps CPU (WFI) until an interrupt is pending.
+ *  Returns also if pending interrupt is masked by PRIMASK so caller can check
+ *  a wake up condition with interrupts disabled and sleep without missing it.
+ *
+ * @param none
+ * @return none
+ *
+ */
+void Drv_CPUCore_WaitForInterrupt(void);
+
+/*
+ * Masks interrupts which cannot run while flash is programmed (IAP).
+ *
+ *  If DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES is enabled, only interrupts of 
+ *  lower priorities are masked (BASEPRI) so time critical interrupts keep 
+ *  running during a sector erase. Kept interrupts (including System Handlers
+ *  like SysTick) are checked on each call, all interrupts are disabled if 
+ *  vector table or handler of an enabled kept interrupt is in flash.
+ *
+ *  [IMP] Privileged only. Must be paired with 
+ *  Drv_CPUCore_ExitFlashProgramming.
+ *
+ * @param none
+ * @return State to restore on exit
+ */
+uint32_t Drv_CPUCore_EnterFlashProgramming(void);
+
+/*
+ * Restores interrupt masking after flash programming.
+ *  Interrupts stay disabled if they were disabled before entry.
+ *
+ * @param state State which is returned by Drv_CPUCore_EnterFlashProgramming
+ * @return none
+ */
+void Drv_CPUCore_ExitFlashProgramming(uint32_t state);
+
+/*
+ * Enters a critical section.
+ *  Masks interrupts which are allowed to use OS/Driver services (priority 
+ *  of MAX_SYSCALL_INTERRUPT_PRIORITY and lower) using BASEPRI. Higher priority
+ *  interrupts are not blocked. Critical sections can be nested.
+ *
+ *  [IMP] Only privileged code and interrupts which are masked by critical 
+ *  sections can use critical sections. 
+ *
+ * @param none
+ * @return none
+ *
+ */
+void Drv_CPUCore_EnterCritical(void);
+
+/*
+ * Exits from a critical section.
+ *  Interrupts are unmasked when outermost critical section is exited.
+ *
+ * @param none
+ * @return none
+ *
+ */
+void Drv_CPUCore_ExitCritical(void);
+
+/*
+ * Atomically replaces a word if it still has expected value.
+ *  Implemented with exclusive accesses (LDREX/STREX) so it does not mask 
+ *  interrupts and it is safe at any interrupt priority (including Zero 
+ *  Latency Tier).
+ *
+ * @param address Address of word
+ * @param expected Expected (actual) value of word
+ * @param value New value of word
+ *
+ * @return true if word is replaced, false if word is not expected value.
+ */
+bool Drv_CPUCore_AtomicCompareAndSwap(volatile uint32_t* address, uint32_t expected, uint32_t value);
+
 /*
  * Starts Context Switching
  *  Configures HW for CS and starts first task
@@ -231,6 +559,29 @@ void Drv_CPUCore_CSStart(Drv_CPUCore_CSGetNextTCBCallback getNextTCBCB);
  */
 void Drv_CPUCore_CSYield(bool privileged);
 
+/*
+ * Registers System Call Handler of upper layer.
+ *
+ * @param handler System Call Handler
+ *
+ * @return none
+ */
+void Drv_CPUCore_InitializeSystemCalls(SystemCallHandler handler);
+
+/*
+ * Makes a System Call (SVC) to registered System Call Handler.
+ *  Used by unprivileged tasks to request privileged services. Located in 
+ *  shared code region so unprivileged tasks can call it.
+ *
+ * @param callNo System Call Number
+ * @param arg0 First Argument of call
+ * @param arg1 Second Argument of call
+ * @param arg2 Third Argument of call
+ *
+ * @return Result of System Call
+ */
+uint32_t Drv_CPUCore_SystemCall(uint32_t callNo, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
 /*
  * Initializes task stack
  *
@@ -260,6 +611,65 @@ void Drv_CPUCore_JumpToImage(reg32_t imageAddress);
  */
 uint32_t Drv_CPUCore_GetCPUFrequency(void);
 
+/*
+ * Sets priority of an interrupt.
+ *
+ *  Priority grouping (DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS) is set by 
+ *  Drv_CPUCore_Init() so all priorities must be set after CPU initialization.
+ *  [IMP] Privileged only.
+ *
+ * @param irqNo IRQ Number (CMSIS IRQn numbering, negative for system
+ *        exceptions)
+ * @param preemptPriority Preempt Priority (0 ~ DRV_IRQ_LOWEST_PREEMPT_PRIORITY)
+ * @param subPriority Sub Priority (0 ~ DRV_IRQ_LOWEST_SUB_PRIORITY)
+ *
+ * @return none
+ */
+void Drv_CPUCore_SetIRQPriority(int32_t irqNo, uint32_t preemptPriority, uint32_t subPriority);
+
+/*
+ * Installs an interrupt handler into (RAM) vector table.
+ *
+ *  Handler is called directly by CPU without any dispatching layer.
+ *  Available only if DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE is enabled.
+ *  [IMP] Privileged only.
+ *
+ * @param irqNo IRQ Number (CMSIS IRQn numbering, negative for system
+ *        exceptions)
+ * @param handler Interrupt Handler
+ *
+ * @return RESULT_SUCCESS if handler is installed, otherwise RESULT_FAIL
+ *         (invalid IRQ number or vector table is in Flash).
+ */
+int32_t Drv_CPUCore_SetIRQHandler(int32_t irqNo, IRQHandler handler);
+
+/*
+ * Initializes Software Interrupt.
+ *
+ *  Software Interrupt is a (unused) peripheral interrupt which is triggered
+ *  by SW. It runs in handler (privileged) mode with its own priority so work
+ *  can be deferred from an ISR to a lower priority.
+ *  Requires RAM Vector Table to install handler.
+ *
+ * @param handler Software Interrupt Handler
+ * @param priority Preempt Priority of Software Interrupt
+ *
+ * @return RESULT_SUCCESS if Software Interrupt is ready, otherwise RESULT_FAIL
+ */
+int32_t Drv_CPUCore_InitializeSoftIRQ(IRQHandler handler, uint32_t priority);
+
+/*
+ * Triggers (pends) Software Interrupt.
+ *  Handler runs as soon as priority of running code is lower than priority
+ *  of Software Interrupt (e.g. just after calling ISR returns).
+ *  [IMP] Privileged only.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void Drv_CPUCore_TriggerSoftIRQ(void);
+
 /*
  * Initializes MPU for Unauthorized Access Control
  *  Basically, restricts all resource (flash, ram, and peripherals (e.g. GPIO)) 
@@ -279,4 +689,117 @@ uint32_t Drv_CPUCore_GetCPUFrequency(void);
 void Drv_CPUCore_InitializeMPU(reg32_t sharedCodeStart, uint32_t sharedCodeSize,
 							   reg32_t sharedRAMStart,  uint32_t sharedRAMSize);
 
+/*
+ * Checks whether a memory region can be mapped to a MPU region.
+ *
+ * @param region Region to check
+ *
+ * @return true if region is valid, otherwise false.
+ */
+bool Drv_CPUCore_MPUIsValidRegion(const MemoryRegion* region);
+
+/*
+ * Provides memory region of register block of a peripheral. 
+ *  Region is read/write and not executable. Upper layer (e.g. Kernel) can 
+ *  add this region to region table of an application to let application 
+ *  access to peripheral registers directly.
+ *
+ * @param peripheral Peripheral
+ * @param region Region to fill
+ *
+ * @return RESULT_SUCCESS if peripheral can be granted, otherwise RESULT_FAIL
+ *         (unknown peripheral or MPU Region Virtualization is disabled).
+ */
+int32_t Drv_CPUCore_GetPeripheralRegion(Peripheral peripheral, MemoryRegion* region);
+
+/*
+ * Paints a (not used yet) task stack area to track its usage.
+ *  Stack guard region (if any) is not touched. 
+ *
+ * @param stackStart Stack Start (Lowest) Address
+ * @param stackSize Stack Size
+ *
+ * @return none
+ */
+void Drv_CPUCore_PaintStack(reg32_t stackStart, uint32_t stackSize);
+
+/*
+ * Measures usage of a painted task stack.
+ *
+ * @param stackStart Stack Start (Lowest) Address
+ * @param stackSize Stack Size
+ * @param usage Stack Usage to fill
+ *
+ * @return none
+ */
+void Drv_CPUCore_GetStackUsage(reg32_t stackStart, uint32_t stackSize, StackUsage* usage);
+
+/*
+ * Paints unused part of Main Stack (MSP) which is used by Kernel and ISRs.
+ *  [IMP] Must be called in thread mode before interrupts are enabled. Area
+ *  below actual stack pointer is painted.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void Drv_CPUCore_PaintMainStack(void);
+
+/*
+ * Measures usage of Main Stack (MSP).
+ *
+ * @param usage Stack Usage to fill
+ *
+ * @return none
+ */
+void Drv_CPUCore_GetMainStackUsage(StackUsage* usage);
+
+/*
+ * Provides latency statistics of an interrupt source.
+ *  Sources are interrupts which recorded a latency at least once, in order 
+ *  of their first record.
+ *
+ * @param source Index of source (0 ~ DRV_CONFIG_IRQ_LATENCY_NUM_OF_SOURCES - 1)
+ * @param stats Statistics to fill
+ *
+ * @return RESULT_SUCCESS if stats is filled, otherwise RESULT_FAIL (no such
+ *         source or IRQ Latency Statistics is disabled).
+ */
+int32_t Drv_CPUCore_GetIRQLatencyStats(uint32_t source, IRQLatencyStats* stats);
+
+/*
+ * Clears latency statistics of all sources (e.g. before a measurement under
+ * a known load). Sources are kept.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void Drv_CPUCore_ResetIRQLatencyStats(void);
+
+#if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS
+/*
+ * Records latency of an interrupt.
+ *  Called by interrupt handlers (of drivers) which know raise time of their 
+ *  interrupt. Safe at any interrupt priority.
+ *
+ * @param irqNo IRQ Number (CMSIS IRQn numbering, negative for system
+ *        exceptions)
+ * @param latency Latency in CPU cycles
+ *
+ * @return none
+ */
+void Drv_CPUCore_RecordIRQLatency(int32_t irqNo, uint32_t latency);
+
+/*
+ * Reads DWT Cycle Counter. Counter wraps on 32 bits so only differences of 
+ * readings are meaningful.
+ *
+ * @param none
+ *
+ * @return Number of CPU cycles since CPU initialization (modulo 2^32)
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void);
+#endif /* DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS */
+
 #endif	/* __DRV_CPUCORE_H */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ *
+ * @file Drv_Clock.h
+ *
+ * @author Murat Cakmak (MC)
+ *
+ * @brief CPU Clock Level Interface.
+ *
+ *			CPU Clock (CCLK) can be switched at runtime between a few clock
+ *			levels which are validated for flash and peripherals. Level 0 is
+ *			slowest level and highest level is clock which is configured at
+ *			startup (SystemInit).
+ *
+ *			On a level change, flash wait states, SystemCoreClock, Timer
+ *			prescalers and UART baud divisors are updated together so timer
+ *			ticks and baud rates are not affected.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __DRV_CLOCK_H
+#define __DRV_CLOCK_H
+
+/********************************* INCLUDES ***********************************/
+
+#include "Drv_CPUCore.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Maximum number of CPU Clock Levels */
+#define DRV_CLOCK_MAX_NUM_OF_LEVELS			(4)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/* CPU Clock Level. 0 is slowest level */
+typedef uint32_t ClockLevel;
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Initializes CPU Clock Levels.
+ *
+ *  Levels are derived from startup clock configuration. Startup clock is
+ *  highest level and CPU runs at highest level after initialization. If PLL
+ *  is not used, startup clock is the only level.
+ *
+ * @param none
+ * @return none
+ */
+void Drv_Clock_Init(void);
+
+/*
+ * Gets number of CPU Clock Levels.
+ *
+ * @param none
+ * @return Number of levels (at least 1)
+ */
+uint32_t Drv_Clock_GetNumOfLevels(void);
+
+/*
+ * Gets active CPU Clock Level.
+ *
+ * @param none
+ * @return Active level
+ */
+ClockLevel Drv_Clock_GetLevel(void);
+
+/*
+ * Gets CPU Clock Frequency of a level.
+ *
+ * @param level CPU Clock Level
+ * @return Frequency in Hz or 0 if level is invalid
+ */
+uint32_t Drv_Clock_GetLevelFrequency(ClockLevel level);
+
+/*
+ * Switches CPU Clock to a level.
+ *
+ *  Switch is done with all interrupts disabled (a few microseconds). Level
+ *  is not changed if a Timer or an open UART cannot keep its tick frequency
+ *  or baud rate at new clock, or a UART is still sending (see
+ *  Drv_UART_IsSendCompleted). Caller can retry later.
+ *
+ *  [IMP] Must not be called while interrupts are disabled.
+ *
+ * @param level CPU Clock Level
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL if level is invalid or cannot be
+ *         applied now.
+ */
+int32_t Drv_Clock_SetLevel(ClockLevel level);
+
+/*
+ * Powers on a peripheral and selects its Peripheral Clock.
+ *
+ *  UARTs are clocked by CPU Clock and other peripherals by CPU Clock / 4.
+ *  Peripheral Clock Selection is written only if PLL0 is not connected
+ *  (LPC17xx Errata). Otherwise selection of startup (SystemInit) is kept
+ *  which uses same dividers.
+ *
+ * @param peripheral Peripheral to power on
+ * @return none
+ */
+void Drv_Clock_EnablePeripheral(Peripheral peripheral);
+
+/*
+ * Powers off a peripheral. Registers of peripheral cannot be accessed
+ * until it is powered on again.
+ *
+ * @param peripheral Peripheral to power off
+ * @return none
+ */
+void Drv_Clock_DisablePeripheral(Peripheral peripheral);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* __DRV_CLOCK_H */
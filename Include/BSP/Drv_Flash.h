@@ -44,6 +44,7 @@ int32_t Drv_Flash_Write(uint32_t address, uint8_t* data, uint32_t length);
 int32_t Drv_Flash_WriteBlock(uint32_t blockNo, uint8_t* data, uint32_t length);
 
 int32_t Drv_Flash_GetBlockNoOfAddress(uint32_t address);
+uint32_t Drv_Flash_GetBlockAddress(uint32_t blockNo);
 
 uint32_t Drv_Flash_GetSize(void);
 #endif	/* __DRV_FLASH_H */
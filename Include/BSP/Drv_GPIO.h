@@ -24,6 +24,24 @@
 #include "postypes.h"
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Pin Alias (see Drv_GPIO_GetPinAlias()) accessors.
+ *  Each write or read is a single store or load instruction.
+ */
+#define DRV_GPIO_ALIAS_WRITE(alias, state)		(*(alias) = (uint32_t)(state))
+#define DRV_GPIO_ALIAS_READ(alias)				((Drv_GPIO_PinState)(*(alias)))
+/* Toggle is one load and one store, there is no read-modify-write on port */
+#define DRV_GPIO_ALIAS_TOGGLE(alias)			(*(alias) = (*(alias) ^ 1))
+
+/* Number of GPIO Ports (P0~P4) and pins per port */
+#define DRV_GPIO_NUM_OF_PORTS					(5)
+#define DRV_GPIO_NUM_OF_PINS_PER_PORT			(32)
+
+/* Pin Functions (GPIO and three alternate functions) and Drive Modes */
+#define DRV_GPIO_FUNCTION_GPIO					(0)
+#define DRV_GPIO_NUM_OF_FUNCTIONS				(4)
+#define DRV_GPIO_NUM_OF_DRIVE_MODES				(4)
+
 /***************************** TYPE DEFINITIONS *******************************/
 /* GPIO Pin States */
 typedef enum
@@ -32,10 +50,198 @@ typedef enum
 	DRV_GPIO_PINSTATE_HIGH = 1
 } Drv_GPIO_PinState;
 
+/* GPIO Pin Directions */
+typedef enum
+{
+	DRV_GPIO_DIRECTION_INPUT = 0,
+	DRV_GPIO_DIRECTION_OUTPUT = 1
+} Drv_GPIO_Direction;
+
+/*
+ * GPIO Interrupt Edges. Can be combined to get interrupt on both edges.
+ */
+typedef enum
+{
+	DRV_GPIO_EDGE_RISING = 0x01,
+	DRV_GPIO_EDGE_FALLING = 0x02,
+	DRV_GPIO_EDGE_BOTH = (DRV_GPIO_EDGE_RISING | DRV_GPIO_EDGE_FALLING)
+} Drv_GPIO_Edge;
+
+/*
+ * GPIO Interrupt Callback.
+ *  Called from GPIO ISR so it must be short. It can use Kernel services
+ *  which are allowed for ISRs (e.g. to wake up a blocked application).
+ *
+ * @param port Port Number of IO
+ * @param pin Pin Number of IO
+ * @param edge Detected Edge (Rising or Falling)
+ */
+typedef void (*Drv_GPIO_InterruptCallback)(uint32_t port, uint32_t pin, Drv_GPIO_Edge edge);
+
+/*
+ * Single word alias of a pin. Writing 1 (or 0) sets (or clears) pin and
+ * reading returns pin state.
+ */
+typedef volatile uint32_t* Drv_GPIO_PinAlias;
+
 /*************************** FUNCTION DEFINITIONS *****************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void Drv_GPIO_Init(void);
+
+/*
+ * Configures Function and Drive Mode of a pin.
+ *
+ *  [IMP] Pin Configuration registers are privileged only. Applications
+ *  configure pins by OS_ConfigurePin().
+ *
+ * @param port Port Number
+ * @param pin Pin Number
+ * @param functionNo Function of pin
+ * @param driveMode Drive Mode of pin
+ *
+ * @return none
+ */
 void Drv_GPIO_ConfigurePin(uint32_t port, uint32_t pin, uint32_t functionNo, uint32_t driveMode);
+
+/*
+ * Gets active Function of a pin.
+ *
+ * @param port Port Number
+ * @param pin Pin Number
+ *
+ * @return Function of pin (DRV_GPIO_FUNCTION_GPIO or an alternate function)
+ */
+uint32_t Drv_GPIO_GetPinFunction(uint32_t port, uint32_t pin);
+
+/*
+ * Gets peripheral which drives a pin when pin is configured for an
+ * alternate function.
+ *
+ * @param port Port Number
+ * @param pin Pin Number
+ * @param functionNo Alternate Function of pin
+ *
+ * @return Peripheral (See Drv_CPUCore.h) or RESULT_FAIL if function is GPIO,
+ *         pin does not have such function or function belongs to a
+ *         peripheral which is not listed (e.g. CAN, USB or Ethernet).
+ */
+int32_t Drv_GPIO_GetPinPeripheral(uint32_t port, uint32_t pin, uint32_t functionNo);
 void Drv_GPIO_WritePin(uint32_t port, uint32_t pin, Drv_GPIO_PinState state);
 Drv_GPIO_PinState Drv_GPIO_ReadPin(uint32_t port, uint32_t pin);
 
+/*
+ * PORT-WIDE OPERATIONS
+ *  Pins are selected by a mask (bit n is pin n) and all selected pins are
+ *  updated with a single register write. Unlike Drv_GPIO_WritePin(), they do
+ *  not change direction so direction must be set once before.
+ */
+
+/*
+ * Configures Function and Drive Mode of all pins in mask.
+ *  Privileged only (see Drv_GPIO_ConfigurePin()).
+ *
+ * @param port Port Number
+ * @param pinMask Pins to configure
+ * @param functionNo Function of pins
+ * @param driveMode Drive Mode of pins
+ *
+ * @return none
+ */
+void Drv_GPIO_ConfigurePort(uint32_t port, uint32_t pinMask, uint32_t functionNo, uint32_t driveMode);
+
+/*
+ * Sets direction of all pins in mask.
+ *
+ * @param port Port Number
+ * @param pinMask Pins to set direction
+ * @param direction New Direction
+ *
+ * @return none
+ */
+void Drv_GPIO_SetPortDirection(uint32_t port, uint32_t pinMask, Drv_GPIO_Direction direction);
+
+/*
+ * Sets (High) all output pins in mask. Other pins are not affected.
+ */
+void Drv_GPIO_SetPort(uint32_t port, uint32_t pinMask);
+
+/*
+ * Clears (Low) all output pins in mask. Other pins are not affected.
+ */
+void Drv_GPIO_ClearPort(uint32_t port, uint32_t pinMask);
+
+/*
+ * Writes value to all output pins in mask at once (no intermediate state).
+ *  Uses port mask register so port must not be accessed from an interrupt
+ *  at the same time.
+ *
+ * @param port Port Number
+ * @param pinMask Pins to write
+ * @param value New pin values (bit n for pin n)
+ *
+ * @return none
+ */
+void Drv_GPIO_WritePort(uint32_t port, uint32_t pinMask, uint32_t value);
+
+/*
+ * @return Values of all pins of port (bit n for pin n)
+ */
+uint32_t Drv_GPIO_ReadPort(uint32_t port);
+
+/*
+ * Gets single word alias of a pin for fastest single pin access (e.g. bit
+ * banged protocols). See DRV_GPIO_ALIAS_WRITE/READ/TOGGLE.
+ *  Direction must be set before.
+ *
+ *  [IMP] Alias window (Bit-Band alias of GPIO) is accessible by unprivileged
+ *  applications only if DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION is 
+ *  enabled. Otherwise aliases are privileged only and applications use
+ *  Drv_GPIO_SetPort/ClearPort/ReadPort.
+ *
+ * @param port Port Number
+ * @param pin Pin Number
+ *
+ * @return Pin Alias
+ */
+Drv_GPIO_PinAlias Drv_GPIO_GetPinAlias(uint32_t port, uint32_t pin);
+
+/*
+ * EDGE INTERRUPTS
+ *  Only Port 0 and Port 2 pins can generate interrupts.
+ */
+
+/*
+ * Enables edge interrupt of an input pin.
+ *  Callback is called once for each detected edge. Pin must be configured as
+ *  GPIO input before. Enabling an already enabled pin replaces its edges and
+ *  callback.
+ *
+ * @param port Port Number of IO (0 or 2)
+ * @param pin Pin Number of IO
+ * @param edges Edges to detect
+ * @param callback Interrupt Callback
+ *
+ * @return RESULT_SUCCESS if interrupt is enabled, RESULT_FAIL if pin cannot
+ *         generate interrupt or callback is NULL.
+ */
+int32_t Drv_GPIO_EnableInterrupt(uint32_t port, uint32_t pin, Drv_GPIO_Edge edges,
+								 Drv_GPIO_InterruptCallback callback);
+
+/*
+ * Disables edge interrupt of a pin. Pending edges of pin are discarded.
+ *
+ * @param port Port Number of IO (0 or 2)
+ * @param pin Pin Number of IO
+ *
+ * @return none
+ */
+void Drv_GPIO_DisableInterrupt(uint32_t port, uint32_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif	/* __DRV_GPIO_H */
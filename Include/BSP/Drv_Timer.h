@@ -9,6 +9,16 @@
  * 			Timer module provides one shot timers and you need to set timer for
  *			each time.
  *
+ *			A HW Timer can also be created as a periodic (auto reload) timer
+ *			which is reloaded by HW so its period has no drift.
+ *
+ *			A HW Timer can also be created as a free running timer which
+ *			provides DRV_TIMER_NUM_OF_CHANNELS independent one shot channels.
+ *			All channels of a timer share same counter (time base).
+ *
+ *			One free running timer can be initialized as system wide 64 bit
+ *			monotonic Time Base so timestamps of all modules are comparable.
+ *
  * @see https://github.com/ZA-YA/ZAYA-OS/wiki
  *
  ******************************************************************************
@@ -25,10 +35,40 @@
 
 /********************************* INCLUDES ***********************************/
 
+#include "Drv_CPUCore.h"
+
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
 #define DRV_TIMER_INVALID_HANDLE		(-1)
+
+/*
+ * Preempt Priorities of HW Timers (see DrvTimerPriority)
+ *  Defaults are emprically defined for 5 preempt priority bits.
+ */
+#ifndef DRV_CONFIG_TIMER_PRIORITY_HIGH
+#define DRV_CONFIG_TIMER_PRIORITY_HIGH		(3)
+#endif	/* DRV_CONFIG_TIMER_PRIORITY_HIGH */
+
+#ifndef DRV_CONFIG_TIMER_PRIORITY_NORMAL
+#define DRV_CONFIG_TIMER_PRIORITY_NORMAL	(9)
+#endif	/* DRV_CONFIG_TIMER_PRIORITY_NORMAL */
+
+#ifndef DRV_CONFIG_TIMER_PRIORITY_LOW
+#define DRV_CONFIG_TIMER_PRIORITY_LOW		(24)
+#endif	/* DRV_CONFIG_TIMER_PRIORITY_LOW */
+
+/* Number of channels (match registers) of a free running timer */
+#define DRV_TIMER_NUM_OF_CHANNELS		(4)
+
+/*
+ * Number of channels of Time Base which can be used by clients.
+ *  Last channel is reserved to extend counter.
+ */
+#define DRV_TIMER_NUM_OF_TIME_BASE_CHANNELS	(DRV_TIMER_NUM_OF_CHANNELS - 1)
+
+/* Time Base Frequency to count PCLK cycles (highest resolution) */
+#define DRV_TIMER_FREQUENCY_PCLK		(0)
 /***************************** TYPE DEFINITIONS *******************************/
 /* HW Timer no */
 typedef uint32_t TimerNo;
@@ -36,6 +76,9 @@ typedef uint32_t TimerNo;
 /* Timer Handle to manage acquired timer */
 typedef uint32_t TimerHandle;
 
+/* Channel (Match Register) number of a free running timer */
+typedef uint32_t TimerChannel;
+
 /* Timer Timout Callback function type */
 typedef void (*DrvTimerCallback)(void);
 
@@ -45,6 +88,12 @@ typedef void (*DrvTimerCallback)(void);
  *  Timer interrupts preempts running task (main thread or another ISRs)
  *  according to its priority. Interrupts can only preempts the execution if
  *  running task's priority lower than timer's priority.
+ *
+ *  With default configuration High and Normal priorities are in Zero Latency
+ *  Tier (see DRV_IRQ_IS_ZERO_LATENCY) so their callbacks must not use Kernel
+ *  or critical section protected Driver services. A Zero Latency priority
+ *  can be used only in a Zero Latency Tier source (see Kernel_ZeroLatency.h),
+ *  elsewhere it is a compile error.
  */
 typedef enum
 {
@@ -57,7 +106,26 @@ typedef enum
 	DRV_TIMER_PRI_NUM
 } DrvTimerPriority;
 
+#ifndef KERNEL_ZERO_LATENCY_TIER
+/*
+ * Zero Latency priorities are renamed to undefined symbols out of Zero
+ * Latency Tier so a timer callback which may use Kernel cannot be registered
+ * above MAX_SYSCALL_INTERRUPT_PRIORITY.
+ */
+#if DRV_IRQ_IS_ZERO_LATENCY(DRV_CONFIG_TIMER_PRIORITY_HIGH)
+#define DRV_TIMER_PRI_HIGH				ZeroLatencyTier_Only_DRV_TIMER_PRI_HIGH
+#endif
+
+#if DRV_IRQ_IS_ZERO_LATENCY(DRV_CONFIG_TIMER_PRIORITY_NORMAL)
+#define DRV_TIMER_PRI_NORMAL			ZeroLatencyTier_Only_DRV_TIMER_PRI_NORMAL
+#endif
+#endif /* KERNEL_ZERO_LATENCY_TIER */
+
 /*************************** FUNCTION DEFINITIONS *****************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void Drv_Timer_Init(void);
 
 /*
@@ -113,4 +181,215 @@ void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs);
  */
 uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle);
 
+/*
+ * Stops a one shot or periodic Timer.
+ *
+ *   Callback is not called until timer is started again.
+ *
+ * @param timerHandle	Handle of to be stopped Timer
+ *
+ * @return none
+ */
+void Drv_Timer_Stop(TimerHandle timerHandle);
+
+/*
+ * Creates a periodic SW Timer which matches with a HW Timer.
+ *
+ *  Counter is reloaded by HW at end of each period so periods are phase
+ *  stable and they are not affected by ISR latency or callback duration.
+ *
+ * @param timerNo 		to be acquired HW Timer Number
+ * @param priority 		Timer Priorty
+ * @param timerCallback	Client callback which is called on each period.
+ *						Should not be NULL.
+ *
+ * @return Timer Handle to manage timer.
+ */
+TimerHandle Drv_Timer_CreatePeriodic(TimerNo timerNo,
+									 DrvTimerPriority priority,
+									 DrvTimerCallback timerCallback);
+
+/*
+ * Starts (or restarts) a periodic Timer.
+ *
+ *   First period starts immediately.
+ *
+ * @param timerHandle	Handle of periodic Timer
+ * @param periodInUs	Period in microseconds. Must not be zero.
+ *
+ * @return none
+ */
+void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs);
+
+/*
+ * Changes period of a running periodic Timer.
+ *
+ *   Current period is not disturbed; new period is applied on next period
+ *   boundary. New period must be longer than interrupt latency of timer
+ *   because it is written in ISR after boundary.
+ *
+ * @param timerHandle	Handle of periodic Timer
+ * @param periodInUs	New period in microseconds. Must not be zero.
+ *
+ * @return none
+ */
+void Drv_Timer_SetPeriod(TimerHandle timerHandle, uint32_t periodInUs);
+
+/*
+ * Creates a free running SW Timer which matches with a HW Timer.
+ *
+ *  Counter of timer starts immediately and it is never resetted or stopped.
+ *  Drv_Timer_ReadElapsedTimeInUs() returns counter value (with wrap around)
+ *  and timeouts are provided by channels (see Drv_Timer_CreateChannel).
+ *  Counter tick is 1 microsecond.
+ *
+ *  Drv_Timer_Start() must not be called for free running timers.
+ *
+ * @param timerNo 		to be acquired HW Timer Number
+ * @param priority 		Timer Priorty. All channels share same priority.
+ *
+ * @return Timer Handle to manage timer.
+ */
+TimerHandle Drv_Timer_CreateFreeRunning(TimerNo timerNo,
+										DrvTimerPriority priority);
+
+/*
+ * Registers a client callback to a channel of a free running timer.
+ *
+ *  Each channel can be assigned to only one client.
+ *
+ * @param timerHandle		Handle of free running timer
+ * @param channel			Channel number (0 ~ DRV_TIMER_NUM_OF_CHANNELS - 1)
+ * @param channelCallback	Client callback to inform client about channel
+ *							timeout. Should not be NULL.
+ *
+ * @return none
+ */
+void Drv_Timer_CreateChannel(TimerHandle timerHandle,
+							 TimerChannel channel,
+							 DrvTimerCallback channelCallback);
+
+/*
+ * Starts a channel with a timeout relative to current counter.
+ *
+ *   Channel is one shot. If channel is already started, previous timeout is
+ *   cancelled. Channel can be restarted from its callback.
+ *
+ * @param timerHandle		Handle of free running timer
+ * @param channel			Channel to be started
+ * @param timeoutInTicks	Timeout in counter ticks (microseconds unless timer
+ *							is Time Base). Must be lower than 2^31.
+ *
+ * @return none
+ */
+void Drv_Timer_StartChannel(TimerHandle timerHandle,
+							TimerChannel channel,
+							uint32_t timeoutInTicks);
+
+/*
+ * Starts a channel to timeout at an absolute counter value.
+ *
+ *   Useful for drift free periodic timeouts (next = previous + period).
+ *   If time is already passed, channel times out immediately.
+ *
+ * @param timerHandle	Handle of free running timer
+ * @param channel		Channel to be started
+ * @param tick			Absolute counter value (see
+ *						Drv_Timer_ReadElapsedTimeInUs) to timeout. For Time
+ *						Base, lower 32 bits of Drv_Timer_ReadTimeBase().
+ *
+ * @return none
+ */
+void Drv_Timer_StartChannelAt(TimerHandle timerHandle,
+							  TimerChannel channel,
+							  uint32_t tick);
+
+/*
+ * Stops a channel.
+ *
+ *   Callback of channel is not called until channel is started again.
+ *
+ * @param timerHandle	Handle of free running timer
+ * @param channel		Channel to be stopped
+ *
+ * @return none
+ */
+void Drv_Timer_StopChannel(TimerHandle timerHandle, TimerChannel channel);
+
+/*
+ * Initializes system wide 64 bit monotonic Time Base.
+ *
+ *  Time Base is a free running timer so first
+ *  DRV_TIMER_NUM_OF_TIME_BASE_CHANNELS channels can be used by clients and
+ *  their ticks are Time Base ticks. Last channel is reserved.
+ *
+ *  Time Base overflow interrupt is served twice per 2^32 ticks. It must not
+ *  be blocked longer than 2^31 ticks (~85 seconds for PCLK resolution).
+ *
+ * @param timerNo 		to be acquired HW Timer Number
+ * @param priority 		Timer Priorty
+ * @param frequency		Requested tick frequency in Hz or
+ *						DRV_TIMER_FREQUENCY_PCLK to count PCLK cycles. Actual
+ *						frequency is PCLK / N, see Drv_Timer_GetTimeBaseFrequency
+ *
+ * @return Timer Handle of free running Time Base timer.
+ */
+TimerHandle Drv_Timer_InitializeTimeBase(TimerNo timerNo,
+										 DrvTimerPriority priority,
+										 uint32_t frequency);
+
+/*
+ * Reads 64 bit Time Base.
+ *
+ *   Lock-free and safe to call from any context (including ISRs with higher
+ *   priority than Time Base timer).
+ *
+ * @return Ticks since Time Base is initialized.
+ */
+uint64_t Drv_Timer_ReadTimeBase(void);
+
+/*
+ * Gets actual Time Base tick frequency.
+ *
+ * @return Tick frequency in Hz.
+ */
+uint32_t Drv_Timer_GetTimeBaseFrequency(void);
+
+/*
+ * Reads Time Base in microseconds.
+ *
+ * @return Microseconds since Time Base is initialized.
+ */
+uint64_t Drv_Timer_ReadTimeBaseInUs(void);
+
+/*
+ * Checks whether all created timers can keep their tick frequencies on a
+ * new CPU Clock.
+ *
+ *  Timer Clock (PCLK) follows CPU Clock so a tick frequency can be kept if
+ *  new PCLK is an exact multiple of it. E.g. a Time Base which counts PCLK
+ *  cycles (DRV_TIMER_FREQUENCY_PCLK) cannot be kept on another CPU Clock.
+ *
+ * @param cpuFrequency New CPU Clock in Hz
+ *
+ * @return true if all timers can keep their tick frequencies
+ */
+bool Drv_Timer_IsCPUFrequencySupported(uint32_t cpuFrequency);
+
+/*
+ * Updates prescalers of all created timers after CPU Clock is changed so
+ * their tick frequencies are not changed. Counters and channels are kept.
+ *
+ *  [IMP] Must be called with interrupts disabled just after SystemCoreClock
+ *  is updated (see Drv_Clock_SetLevel).
+ *
+ * @param none
+ * @return none
+ */
+void Drv_Timer_UpdateCPUFrequency(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif	/* __DRV_TIMER_H */
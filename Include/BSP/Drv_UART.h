@@ -1,6 +1,6 @@
 /*******************************************************************************
  *
- * @file Drv_CPUCore.h
+ * @file Drv_UART.h
  *
  * @author MC
  *
@@ -26,16 +26,81 @@
 
 /***************************** MACRO DEFINITIONS ******************************/
 #define DRV_UART_INVALID_HANDLER			(-1)
+
+/* Maximum buffer size for DMA Receive Mode (12 bit DMA transfer size) */
+#define DRV_UART_DMA_MAX_BUFFER_SIZE		(4095)
 /***************************** TYPE DEFINITIONS *******************************/
 typedef int32_t UartHandle;
 
+/*
+ * Data Received Event Handler.
+ *  Called from UART ISR once per received burst (not per byte).
+ */
 typedef void(*UARTDataReceivedEventHandler)(void);
+
+/*
+ * DMA Receive Events
+ */
+typedef enum
+{
+	/* Buffer is completely filled. DMA continues with the other buffer */
+	DRV_UART_DMA_EVENT_BUFFER_FULL,
+	/* Line is idle (no character for a while). Buffer is partially filled */
+	DRV_UART_DMA_EVENT_IDLE_LINE,
+	/* DMA Error. Reception is stopped */
+	DRV_UART_DMA_EVENT_ERROR
+} Drv_UART_DMAEvent;
+
+/*
+ * DMA Receive Event Handler.
+ *  Called from ISR. Each received byte is reported only once so data points
+ *  to the bytes which are received since previous event in same buffer.
+ *
+ * @param event DMA Receive Event
+ * @param data First new byte in caller buffer
+ * @param length Number of new bytes
+ */
+typedef void(*UARTDMAEventHandler)(Drv_UART_DMAEvent event, uint8_t* data, uint32_t length);
 /*************************** FUNCTION DEFINITIONS *****************************/
 void Drv_UART_Init(void);
 
+/*
+ * Opens a UART (8N1) and starts interrupt driven reception.
+ *
+ * @param uartNo UART Number
+ * @param baudRate Baud Rate
+ * @param dataReceivedEventHandler Event Handler for received data. Can be NULL.
+ *
+ * @return Handle of UART, DRV_UART_INVALID_HANDLER if UART is invalid, in use
+ *         or baud rate can not be generated in tolerance
+ */
 UartHandle Drv_UART_Get(uint32_t uartNo, uint32_t baudRate, UARTDataReceivedEventHandler dataReceivedEventHandler);
 void Drv_UART_Release(UartHandle uart);
 
+/*
+ * Changes baud rate of an open UART.
+ *  Baud rate divisors (including fractional divider) are calculated for
+ *  minimum error. Send must be completed before (see Drv_UART_IsSendCompleted).
+ *
+ * @param uart Handle of UART
+ * @param baudRate New Baud Rate
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL if baud rate is out of tolerance,
+ *         send is not completed or handle is invalid.
+ */
+int32_t Drv_UART_SetBaudRate(UartHandle uart, uint32_t baudRate);
+
+/*
+ * @return true if all queued bytes are sent out
+ */
+bool Drv_UART_IsSendCompleted(UartHandle uart);
+
+/*
+ * Queues data to send. Does not block.
+ *
+ * @return Number of queued bytes. May be less than sendLength if TX buffer is full
+ * @return -1 In case of error
+ */
 int32_t Drv_UART_Send(UartHandle uart, uint8_t* sendBuffer, uint32_t sendLength);
 /*
  * @return Number of read bytes. Returns zero if there is no unread bytes
@@ -44,4 +109,55 @@ int32_t Drv_UART_Send(UartHandle uart, uint8_t* sendBuffer, uint32_t sendLength)
  */
 int32_t Drv_UART_Receive(UartHandle uart, uint8_t* receiveBuffer, uint32_t receiveLength);
 
+/*
+ * Starts DMA Receive Mode. Received bytes are moved by GPDMA into two caller
+ * buffers alternately without CPU involvement and client is informed on
+ * each full buffer and on idle line. Drv_UART_Receive() is not used in this
+ * mode.
+ *
+ *  Client must finish processing of a full buffer before the other buffer
+ *  is filled.
+ *
+ * @param uart Handle of UART
+ * @param buffer0 First Receive Buffer
+ * @param buffer1 Second Receive Buffer
+ * @param bufferSize Size of each buffer (1 ~ DRV_UART_DMA_MAX_BUFFER_SIZE)
+ * @param eventHandler DMA Receive Event Handler
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+int32_t Drv_UART_StartDMAReceive(UartHandle uart, uint8_t* buffer0, uint8_t* buffer1, uint32_t bufferSize, UARTDMAEventHandler eventHandler);
+
+/*
+ * Stops DMA Receive Mode and returns back to interrupt driven reception.
+ *  Bytes which are not reported yet are dropped.
+ *
+ * @param uart Handle of UART
+ * @return none
+ */
+void Drv_UART_StopDMAReceive(UartHandle uart);
+
+/*
+ * Checks whether baud rates of all open UARTs can be kept on a new CPU Clock.
+ *  UART Clock follows CPU Clock so baud divisors must be recalculated.
+ *  Fails if a UART is still sending.
+ *
+ * @param cpuFrequency New CPU Clock in Hz
+ * @return true if CPU Clock can be changed
+ */
+bool Drv_UART_IsCPUFrequencySupported(uint32_t cpuFrequency);
+
+/*
+ * Recalculates baud divisors of all open UARTs after CPU Clock is changed.
+ *  A byte which is being received while divisors are changed may be
+ *  corrupted.
+ *
+ *  [IMP] Must be called with interrupts disabled just after SystemCoreClock
+ *  is updated (see Drv_Clock_SetLevel).
+ *
+ * @param none
+ * @return none
+ */
+void Drv_UART_UpdateCPUFrequency(void);
+
 #endif	/* __DRV_UART_H */
@@ -20,6 +20,10 @@
 #ifndef __DRV_USERTIMER_H
 #define __DRV_USERTIMER_H
 
+#ifdef KERNEL_ZERO_LATENCY_TIER
+#error "Zero Latency interrupt handlers must not use User Timers (see Kernel_ZeroLatency.h)!"
+#endif
+
 /********************************* INCLUDES ***********************************/
 
 #include "postypes.h"
@@ -32,12 +36,89 @@ typedef int32_t Drv_TimerHandle;
 typedef void (*Drv_TimerCallback)(void);
 
 /*************************** FUNCTION DEFINITIONS *****************************/
+/*
+ * Initializes User Timers.
+ *  All user timers are multiplexed on a single HW Timer. Time Base must be
+ *  initialized before (see Drv_Timer_InitializeTimeBase).
+ *
+ * @param none
+ *
+ * @return none
+ */
 void Drv_UserTimer_Init(void);
+
+/*
+ * Creates a (stopped) one shot user timer.
+ *
+ * @param userTimerCB Callback to inform client about timeout. Callback is
+ *        called in interrupt context.
+ *
+ * @return Timer Handle or DRV_TIMER_INVALID_HANDLE if there is no free timer
+ *         (see CPU_TIMER_MAX_TIMER_COUNT).
+ */
 Drv_TimerHandle Drv_UserTimer_Create(Drv_TimerCallback userTimerCB);
+
+/*
+ * Stops and releases a user timer.
+ *
+ * @param timer Handle of timer
+ *
+ * @return none
+ */
 void Drv_UserTimer_Remove(Drv_TimerHandle timer);
+
+/*
+ * Starts (or restarts) a user timer.
+ *
+ * @param timer Handle of timer
+ * @param timeout Timeout in microseconds. Timeouts longer than wheel range 
+ *        (~17 minutes) are limited to wheel range.
+ *
+ * @return none
+ */
 void Drv_UserTimer_Start(Drv_TimerHandle timer, uint32_t timeout);
-void Drv_UserTimer_Stop(Drv_TimerHandle timer, uint32_t timeout);
+
+/*
+ * Starts (or restarts) a user timer which accepts late expiry.
+ *
+ *  Timer expires in [timeout, timeout + slack] window. Driver selects a time
+ *  in window which is shared with other timers (e.g. an already programmed
+ *  wake-up) so expirations of loosely timed timers are coalesced into a
+ *  single HW Timer interrupt.
+ *
+ * @param timer Handle of timer
+ * @param timeout Timeout in microseconds
+ * @param slack Accepted lateness in microseconds. 0 means exact timeout.
+ *
+ * @return none
+ */
+void Drv_UserTimer_StartWithSlack(Drv_TimerHandle timer, uint32_t timeout, uint32_t slack);
+
+/*
+ * Stops a user timer. Callback is not called for a stopped timer.
+ *
+ * @param timer Handle of timer
+ *
+ * @return none
+ */
+void Drv_UserTimer_Stop(Drv_TimerHandle timer);
+
+/*
+ * Busy waits for specified time.
+ *
+ * @param microseconds Time to wait in microseconds
+ *
+ * @return none
+ */
 void Drv_UserTimer_DelayUs(uint32_t microseconds);
+
+/*
+ * Busy waits for specified time.
+ *
+ * @param milliseconds Time to wait in milliseconds
+ *
+ * @return none
+ */
 void Drv_UserTimer_DelayMs(uint32_t milliseconds);
 
 #endif	/* __DRV_USERTIMER_H */
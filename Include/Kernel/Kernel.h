@@ -36,13 +36,88 @@
 #ifndef __KERNEL_H
 #define __KERNEL_H
 
+#ifdef KERNEL_ZERO_LATENCY_TIER
+#error "Zero Latency interrupt handlers must not use Kernel APIs (see Kernel_ZeroLatency.h)!"
+#endif
+
 /********************************* INCLUDES ***********************************/
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Pin Edges to signal an event (see OS_AttachPinEvent). 
+ */
+#define OS_PIN_EDGE_RISING				(0x01)
+#define OS_PIN_EDGE_FALLING				(0x02)
+#define OS_PIN_EDGE_BOTH				(OS_PIN_EDGE_RISING | OS_PIN_EDGE_FALLING)
+
+/*
+ * Status of a Flash Request (see OS_FlashRequest).
+ */
+#define OS_FLASH_STATUS_SUCCESS			(0)
+#define OS_FLASH_STATUS_FAIL			(-1)
+#define OS_FLASH_STATUS_PENDING			(1)
+
+/*
+ * Unit of flash writes. Address and length of a write must be multiples of
+ * this value.
+ */
+#define OS_FLASH_WRITE_UNIT				(256)
+
+/* Number of buckets of IRQ Latency Histogram (see OS_IRQLatencyStats) */
+#define OS_IRQ_LATENCY_NUM_OF_BUCKETS	(16)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
+/*
+ * Deferred Work Function.
+ *
+ * @param context Context which is provided while work is queued
+ */
+typedef void (*OS_DeferredWorkFunction)(void* context);
+
+/*
+ * Flash Request (see OS_FlashErase and OS_FlashWrite).
+ *
+ *  Request and its data are used by Kernel until request is completed so
+ *  they must be kept (e.g. static) in application RAM while status is
+ *  OS_FLASH_STATUS_PENDING.
+ */
+typedef struct
+{
+	/* Flash Address. Start of a sector for erase */
+	uint32_t address;
+	/* Data to write. Must be word aligned. Not used for erase */
+	const uint8_t* data;
+	/* Number of bytes. Whole sectors for erase */
+	uint32_t length;
+	/* Events to signal to requester when request is completed */
+	uint32_t events;
+	/* Status of request (OS_FLASH_STATUS_XXX). Updated by Kernel */
+	volatile int32_t status;
+} OS_FlashRequest;
+
+/*
+ * Latency Statistics of an interrupt source (see OS_GetIRQLatencyStats).
+ *
+ *  Latency is number of CPU cycles between raising of an interrupt and start
+ *  of its handler. Bucket N of histogram counts latencies in range of 
+ *  [2^N, 2^(N+1)) cycles.
+ */
+typedef struct
+{
+	/* IRQ Number (CMSIS IRQn numbering, negative for system exceptions) */
+	int32_t irqNo;
+	/* Number of recorded interrupts */
+	uint32_t count;
+	/* Minimum and Maximum latencies in CPU cycles */
+	uint32_t minLatency;
+	uint32_t maxLatency;
+	/* Latency Histogram */
+	uint32_t histogram[OS_IRQ_LATENCY_NUM_OF_BUCKETS];
+} OS_IRQLatencyStats;
+
 /*************************** FUNCTION DEFINITIONS *****************************/
 
 /**
@@ -53,4 +128,170 @@
  */
 void OS_Yield(void);
 
+/**
+ * Queues a work to be run by Kernel after interrupt returns.
+ *
+ *  Intended for ISRs (and privileged drivers) to keep interrupt handlers
+ *  short. Works are run in queued order by Kernel Deferred Work Handler which
+ *  runs at OS_DEFERRED_WORK_PRIORITY.
+ *  [IMP] Caller must be privileged and its priority must not be higher than
+ *  MAX_SYSCALL_INTERRUPT_PRIORITY (queue is protected by critical sections).
+ *
+ * @param function Work function
+ * @param context Context to pass to work function
+ *
+ * @return RESULT_SUCCESS if work is queued, RESULT_FAIL if queue is full,
+ *         function is NULL or Deferred Work is not available (Software 
+ *         Interrupt could not be initialized).
+ */
+int32_t OS_QueueDeferredWork(OS_DeferredWorkFunction function, void* context);
+
+/**
+ * Blocks calling application until one of events is signaled.
+ *
+ *  Each application has 32 event flags (one per bit). Signaled events are 
+ *  kept until they are waited so an event which is signaled before wait is
+ *  not lost. Other applications keep running (or CPU sleeps) while caller is
+ *  blocked.
+ *
+ * @param eventMask Events to wait
+ *
+ * @return Signaled events in eventMask. Returned events are cleared. Returns
+ *         0 if eventMask is 0.
+ */
+uint32_t OS_WaitEvents(uint32_t eventMask);
+
+/**
+ * Signals events of an application and wakes it up if it waits for one of 
+ * them.
+ *
+ *  Intended for ISRs and driver callbacks (e.g. GPIO interrupt callbacks).
+ *  Woken application runs in its next scheduling turn.
+ *  [IMP] Caller must be privileged and its priority must not be higher than
+ *  MAX_SYSCALL_INTERRUPT_PRIORITY (events are protected by critical sections).
+ *
+ * @param appId ID of Application to signal
+ * @param events Events to signal
+ *
+ * @return RESULT_SUCCESS if events are signaled, RESULT_FAIL if application
+ *         does not exist or events is 0.
+ */
+int32_t OS_SignalEvents(int32_t appId, uint32_t events);
+
+/**
+ * Signals events of calling application on edges of an input pin.
+ *
+ *  Pin interrupts are delivered by Kernel so an application waits for a 
+ *  button or an encoder using OS_WaitEvents() instead of polling the pin.
+ *  A pin belongs to first attached application until it detaches. 
+ *  Pin must be configured as GPIO input before.
+ *
+ * @param port Port Number of pin (0 or 2)
+ * @param pin Pin Number of pin
+ * @param edges Edges to signal (OS_PIN_EDGE_XXX)
+ * @param events Events to signal, 0 detaches pin
+ *
+ * @return RESULT_SUCCESS if pin is attached (or detached), RESULT_FAIL if pin 
+ *         cannot generate interrupt, it belongs to another application or 
+ *         there is no free pin slot.
+ */
+int32_t OS_AttachPinEvent(uint32_t port, uint32_t pin, uint32_t edges, uint32_t events);
+
+/**
+ * Queues an erase request for flash sectors of Flash Service area.
+ *
+ *  Call does not block. Kernel erases one sector at each scheduling point
+ *  so calling application and others keep running while sectors are
+ *  erased. When all sectors are erased (or an error occurs) request status
+ *  is updated and request events are signaled (see OS_WaitEvents).
+ *
+ * @param request Erase Request. Address and length must cover whole sectors.
+ *
+ * @return RESULT_SUCCESS if request is queued, RESULT_FAIL if request is
+ *         invalid (out of Flash Service area, not aligned or not in 
+ *         application RAM) or queue is full.
+ */
+int32_t OS_FlashErase(OS_FlashRequest* request);
+
+/**
+ * Queues a write request for Flash Service area.
+ *
+ *  Call does not block. Kernel writes OS_FLASH_WRITE_UNIT bytes at each
+ *  scheduling point. Completion is reported like OS_FlashErase. Target area
+ *  must be erased before.
+ *
+ * @param request Write Request. Address and length must be multiples of
+ *        OS_FLASH_WRITE_UNIT. Data must be in application RAM.
+ *
+ * @return RESULT_SUCCESS if request is queued, RESULT_FAIL if request is
+ *         invalid or queue is full.
+ */
+int32_t OS_FlashWrite(OS_FlashRequest* request);
+
+/**
+ * Grants register block of a peripheral to calling application exclusively.
+ *
+ *  Application (a user space driver) accesses peripheral registers directly
+ *  after grant. Kernel powers on peripheral and selects its clock. Pins of
+ *  peripheral are configured by OS_ConfigurePin(). Peripheral is released
+ *  (and powered off) when application is terminated.
+ *  Peripherals which are used by Kernel (Kernel Timers and Debug UART) 
+ *  cannot be granted.
+ *
+ * @param peripheral Peripheral to grant (Peripheral of BSP, e.g. Peripheral_SPI)
+ *
+ * @return RESULT_SUCCESS if peripheral is granted, RESULT_FAIL if peripheral 
+ *         is used by Kernel, owned by another application or region table of 
+ *         application is full.
+ */
+int32_t OS_GrantPeripheral(uint32_t peripheral);
+
+/**
+ * Configures Function and Drive Mode of a pin.
+ *
+ *  Pin Configuration registers are not accessible by applications. GPIO
+ *  Function is allowed for all applications but an alternate function only
+ *  for owner of its peripheral (see OS_GrantPeripheral()). A pin which is
+ *  used by a peripheral of Kernel or another application cannot be changed.
+ *
+ * @param port Port Number of pin
+ * @param pin Pin Number of pin
+ * @param function Function of pin (0 for GPIO or an alternate function)
+ * @param mode Drive Mode of pin
+ *
+ * @return RESULT_SUCCESS if pin is configured, RESULT_FAIL if pin or function
+ *         is invalid or pin (or function) belongs to another owner.
+ */
+int32_t OS_ConfigurePin(uint32_t port, uint32_t pin, uint32_t function, uint32_t mode);
+
+/**
+ * Provides latency statistics of an interrupt source.
+ *
+ *  Sources are interrupts which recorded a latency at least once, in order
+ *  of their first record. An application iterates sources from 0 until call
+ *  fails.
+ *
+ * @param source Index of source
+ * @param stats Statistics to fill. Must be in application RAM.
+ *
+ * @return RESULT_SUCCESS if stats is filled, RESULT_FAIL if there is no such
+ *         source, stats is not in application RAM or IRQ Latency Statistics
+ *         is disabled.
+ */
+int32_t OS_GetIRQLatencyStats(uint32_t source, OS_IRQLatencyStats* stats);
+
+/**
+ * Prints stack usages (High-Water Marks) of Kernel and all applications to
+ * debug output.
+ *
+ *  Output is parsed by Stack Report tool (Environment/BuildSystem/StackReport)
+ *  to size stacks and RAM sections of images. An application can call it
+ *  periodically or after its deepest path (e.g. before it exits) so a report
+ *  is available without an exception.
+ *
+ * @param none
+ * @return none
+ */
+void OS_ReportStackUsage(void);
+
 #endif	/* __KERNEL_H */
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ *
+ * @file Kernel_ZeroLatency.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Kernel Interface for Zero Latency Interrupt Handlers.
+ *
+ *		Interrupts with a priority above MAX_SYSCALL_INTERRUPT_PRIORITY (see
+ *		DRV_IRQ_IS_ZERO_LATENCY) are never masked by Kernel critical sections
+ *		so they see no jitter from Kernel activity (e.g. motor commutation).
+ *		In return, they must not use Kernel APIs because Kernel state is
+ *		protected only by critical sections.
+ *
+ *		A Zero Latency handler hands its work off to Kernel Aware Tier using
+ *		OS_ZeroLatencyHandoff() which is lock-free. Handed off function runs
+ *		in Deferred Work Handler and it can use all Kernel APIs.
+ *
+ *		Build Time Enforcement:
+ *		  Zero Latency handlers are placed in their own source files which
+ *		  define KERNEL_ZERO_LATENCY_TIER before any include:
+ *
+ *			#define KERNEL_ZERO_LATENCY_TIER
+ *			#include "Kernel_ZeroLatency.h"
+ *
+ *		  Then including Kernel interfaces is a compile error and calling
+ *		  critical section or context switch services of CPU Driver is a
+ *		  link error.
+ *
+ *		  Timer priorities which are in Zero Latency Tier (DRV_TIMER_PRI_HIGH
+ *		  and DRV_TIMER_PRI_NORMAL with default configuration) can be used
+ *		  only in these sources, elsewhere they are a compile error. So a
+ *		  timer callback above MAX_SYSCALL_INTERRUPT_PRIORITY is always
+ *		  registered from a source which cannot reach Kernel.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+#ifndef __KERNEL_ZERO_LATENCY_H
+#define __KERNEL_ZERO_LATENCY_H
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#ifdef KERNEL_ZERO_LATENCY_TIER
+/*
+ * CPU Driver services which are not allowed in Zero Latency Tier are renamed
+ * to undefined symbols so any call fails at link time.
+ */
+#define Drv_CPUCore_EnterCritical		ZeroLatencyTier_MustNotUse_EnterCritical
+#define Drv_CPUCore_ExitCritical		ZeroLatencyTier_MustNotUse_ExitCritical
+#define Drv_CPUCore_CSYield				ZeroLatencyTier_MustNotUse_CSYield
+#endif /* KERNEL_ZERO_LATENCY_TIER */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Handoff Function.
+ * @param context Context which is provided while function is handed off
+ */
+typedef void (*OS_HandoffFunction)(void* context);
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+/**
+ * Hands a function off from a Zero Latency interrupt handler to Kernel Aware
+ * Tier.
+ *  Function runs in Deferred Work Handler (OS_DEFERRED_WORK_PRIORITY) after
+ *  all higher priority interrupts return. Handoff queue is lock-free (LDREX/
+ *  STREX) so it never masks interrupts and it is safe at any priority.
+ * @param function Function to run in Kernel Aware Tier
+ * @param context Context to pass to function
+ * @return RESULT_SUCCESS if function is handed off, RESULT_FAIL if queue is
+ *         full, function is NULL or Deferred Work is not available.
+ */
+int32_t OS_ZeroLatencyHandoff(OS_HandoffFunction function, void* context);
+
+#endif	/* __KERNEL_ZERO_LATENCY_H */
@@ -62,6 +62,8 @@
 	#define PACKED
     #define TYPEDEF_STRUCT_PACKED	typedef struct
     #define NO_INLINE
+	#define ALIGNED(n)
+	#define RAM_FUNCTION
 
 #elif defined(__ARMCC_VERSION)
 
@@ -71,6 +73,9 @@
 	#define PACKED								__packed
     #define TYPEDEF_STRUCT_PACKED				PACKED typedef struct
     #define NO_INLINE               			__attribute__((noinline))
+	#define ALIGNED(n)							__attribute__((aligned(n)))
+	/* Scatter file must place .ramfunc into RAM (e.g. RW_IRAM1 { *(.ramfunc) }) */
+	#define RAM_FUNCTION						__attribute__((section(".ramfunc")))
 	#define LOCATE_AT(symbol, addr)				symbol __attribute__((section(".ARM.__at_" ##addr)))
 
 #else /* GCC */
@@ -95,6 +100,9 @@
 	#define PACKED					__attribute__((packed))
     #define TYPEDEF_STRUCT_PACKED	typedef struct PACKED
     #define NO_INLINE
+	#define ALIGNED(n)				__attribute__((aligned(n)))
+	/* Linker script copies .ramfunc into RAM with initialized data */
+	#define RAM_FUNCTION			__attribute__((section(".ramfunc")))
 
 #endif
 
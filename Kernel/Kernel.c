@@ -11,6 +11,8 @@
  *		- Initializes User Space Area
  *		- Starts Kernel
  *		- Starts User Space Applications
+ *		- Runs Idle Task when all applications are blocked
+ *		- Accounts sleep time of Idle Task (CPU load statistics)
  *
  * @see https://github.com/ZA-YA/ZAYA-OS/wiki
  *
@@ -35,6 +37,14 @@
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+#if (OS_IDLE_TASK_STACK_SIZE & (OS_IDLE_TASK_STACK_SIZE - 1)) != 0
+#error "OS_IDLE_TASK_STACK_SIZE must be a power of two!"
+#endif
+
+#if OS_IRQ_LATENCY_NUM_OF_BUCKETS != KERNEL_IRQ_LATENCY_NUM_OF_BUCKETS
+#error "OS_IRQ_LATENCY_NUM_OF_BUCKETS must match with Driver Layer!"
+#endif
+
 /***************************** TYPE DEFINITIONS *******************************/
 /*
  * Kernel Internal Settings 
@@ -53,6 +63,19 @@ typedef struct
 	 *  Keeps all kernel and user tasks.
 	 */
 	Application taskPool[NUM_OF_USER_TASKS];
+
+	/*
+	 * TCB of Idle Task.
+	 *  Idle Task is a privileged Kernel task which is not scheduled by 
+	 *  Scheduler. It runs only if there is no ready application.
+	 */
+	TCB idleTCB;
+
+	/* Total sleep time (System Time ticks) of Idle Task */
+	uint64_t idleTime;
+
+	/* System Time Base. Its channels are used by Kernel services */
+	KernelTimerHandle timeBase;
 } KernelSettings;
 /**************************** FUNCTION PROTOTYPES *****************************/
 
@@ -85,9 +108,15 @@ PRIVATE TestImageData userApps[NUM_OF_USER_TASKS] =
 /* Kernel Internal Settings */
 PRIVATE KernelSettings kernelSettings = { { 0 } };
 
-/* Active Application */
+/* Active Application. NULL while Idle Task is running. */
 INTERNAL Application* activeApp;
 
+/* 
+ * Stack of Idle Task. Aligned with its size because it is also RAM section 
+ * (MPU region) of Idle Task.
+ */
+PRIVATE uint32_t idleTaskStack[OS_IDLE_TASK_STACK_SIZE / sizeof(uint32_t)] ALIGNED(OS_IDLE_TASK_STACK_SIZE);
+
 /**************************** PRIVATE FUNCTIONS ******************************/
 /*
  * Simple printout interface to dump stack content. 
@@ -112,8 +141,14 @@ PRIVATE void exceptionHandler(Exception exception, uint32_t val, StackDumpCallba
 		 */
 		stackDump(printOut);
 	}
+
+	/* Stack usages help to find out overflows and over-allocated stacks */
+	Kernel_ReportStackUsage();
+
+	/* Interrupt latencies help to find out long critical sections */
+	Kernel_ReportIRQLatency();
 	
-	if (kernelSettings.flags.superVisorMode == false)
+	if ((kernelSettings.flags.superVisorMode == false) && (activeApp != NULL))
 	{
 		/*
 		 * Exception is occurred in a User Application
@@ -122,6 +157,15 @@ PRIVATE void exceptionHandler(Exception exception, uint32_t val, StackDumpCallba
 		
 		/* Terminate faulty user application */
 		Scheduler_TerminateApplication();
+
+		/* Peripherals of terminated application can be granted to others */
+		Kernel_ReleasePeripherals(activeApp);
+
+		/* Pins of terminated application can be attached by others */
+		Kernel_ReleasePinEvents(activeApp);
+
+		/* Queued flash requests of terminated application are dropped */
+		Kernel_ReleaseFlashRequests(activeApp);
 		
 		/* Yield to next application */
 		Kernel_Yield(true);
@@ -154,10 +198,30 @@ PRIVATE ALWAYS_INLINE void InitializeNewTask(Application* app)
 
 	/* User application always work in unprivileged mode */
 	tcb->flags.privileged = false;
+
+	/* Application starts out of a critical section */
+	tcb->criticalNesting = 0;
+
+	/* 
+	 * Stack area of User Application. 
+	 *  Driver layer protects bottom of this area against stack overflows.
+	 */
+	tcb->stackStartAddress = info->image.sp - OS_USER_APP_STACK_SIZE;
+	tcb->stackSize = OS_USER_APP_STACK_SIZE;
+
+	/* 
+	 * Paint stack before initial frame is pushed to track stack usage 
+	 * (High-Water Mark) of application. 
+	 */
+	Kernel_PaintTaskStack(tcb->stackStartAddress, tcb->stackSize);
 	
 	/* Initialize TCB of User Application */
 	tcb->topOfStack = Kernel_InitializeTCB(info->image.sp, info->image.pc);
 
+	/* Additional regions are added by Kernel on demand */
+	tcb->memoryRegions = app->memoryRegions;
+	tcb->numOfMemoryRegions = 0;
+
 #if !APP_TEST_MODE
 	/* Fill TCB with user application regions */
 	tcb->codeStartAddress = info->metaDataHeader.codeAddress;
@@ -174,7 +238,168 @@ PRIVATE ALWAYS_INLINE void InitializeNewTask(Application* app)
  */
 PRIVATE TCB* SchedulerGetNextApp(void)
 {
-	return &Scheduler_GetNextApp()->tcb;
+	Application* app;
+
+	/* Queued flash requests progress a step at each scheduling point */
+	Kernel_RunFlashService();
+
+	app = Scheduler_GetNextApp();
+
+	if (app == NULL)
+	{
+		/* All applications are blocked, run Idle Task until one is woken up */
+		activeApp = NULL;
+
+		return &kernelSettings.idleTCB;
+	}
+
+	return &app->tcb;
+}
+
+/**
+ * Idle Task.
+ *  Sleeps CPU until an application is woken up (e.g. by an ISR) and yields
+ *  to it. Ready check and sleep are done with interrupts disabled so a wake
+ *  up between them is not missed (pending interrupt ends WFI).
+ *
+ *  Sleep time is accounted before woken up interrupt is handled so an ISR
+ *  which reads Idle Time (e.g. Clock Governor) sees all sleeps until itself.
+ *
+ *  CPU does not sleep while there is a queued flash request, Idle Task 
+ *  yields instead so Flash Service runs its next step.
+ *
+ * @param none
+ *
+ * @return none
+ */
+PRIVATE void IdleTask(void)
+{
+	uint64_t sleepStart;
+
+	ENDLESS_WHILE_LOOP
+	{
+		Kernel_DisableInterrupts();
+
+		if (!Scheduler_HasReadyApp() && !Kernel_HasFlashWork())
+		{
+			sleepStart = Kernel_GetSystemTime();
+
+			Kernel_WaitForInterrupt();
+
+			kernelSettings.idleTime += Kernel_GetSystemTime() - sleepStart;
+		}
+
+		/* Woken up interrupt is handled here */
+		Kernel_EnableInterrupts();
+
+		if (Scheduler_HasReadyApp() || Kernel_HasFlashWork())
+		{
+			Kernel_Yield(true);
+		}
+	}
+}
+
+/**
+ * Initializes Idle Task.
+ *
+ * @param none
+ *
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeIdleTask(void)
+{
+	TCB* tcb = &kernelSettings.idleTCB;
+	reg32_t stackStart = (reg32_t)idleTaskStack;
+
+	/* Idle Task is a Kernel Task so it uses Kernel (background) regions */
+	tcb->flags.privileged = true;
+	tcb->criticalNesting = 0;
+
+	tcb->stackStartAddress = stackStart;
+	tcb->stackSize = OS_IDLE_TASK_STACK_SIZE;
+
+	Kernel_PaintTaskStack(tcb->stackStartAddress, tcb->stackSize);
+
+	tcb->topOfStack = Kernel_InitializeTCB(stackStart + OS_IDLE_TASK_STACK_SIZE, (reg32_t)IdleTask);
+
+	/* User sections are not used by a privileged task, just keep them small */
+	tcb->codeStartAddress = 0;
+	tcb->codeSize = 0;
+	tcb->dataStartAddress = stackStart;
+	tcb->dataSize = OS_IDLE_TASK_STACK_SIZE;
+
+	tcb->memoryRegions = NULL;
+	tcb->numOfMemoryRegions = 0;
+}
+
+/**
+ * Copies latency statistics of an interrupt source to an application.
+ */
+PRIVATE int32_t GetIRQLatencyStats(Application* app, uint32_t source, OS_IRQLatencyStats* stats)
+{
+	KernelIRQLatencyStats latencyStats;
+	uint32_t bucket;
+
+	/* Stats is written by Kernel so it must belong to caller */
+	if (!Kernel_IsInApplicationRAM(app, (uint32_t)stats, sizeof(OS_IRQLatencyStats)) ||
+		(Kernel_GetIRQLatencyStats(source, &latencyStats) != RESULT_SUCCESS))
+	{
+		return RESULT_FAIL;
+	}
+
+	stats->irqNo = latencyStats.irqNo;
+	stats->count = latencyStats.count;
+	stats->minLatency = latencyStats.minLatency;
+	stats->maxLatency = latencyStats.maxLatency;
+
+	for (bucket = 0; bucket < OS_IRQ_LATENCY_NUM_OF_BUCKETS; bucket++)
+	{
+		stats->histogram[bucket] = latencyStats.histogram[bucket];
+	}
+
+	return RESULT_SUCCESS;
+}
+
+/**
+ * Handles System Calls of applications.
+ *  Runs in SVC Handler on behalf of active application.
+ */
+PRIVATE uint32_t HandleSystemCall(uint32_t callNo, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+	if (activeApp == NULL)
+	{
+		/* Only applications make system calls */
+		return (uint32_t)RESULT_FAIL;
+	}
+
+	switch (callNo)
+	{
+		case KERNEL_SYSCALL_WAIT_EVENTS:
+			return Kernel_WaitEvents(activeApp, arg0);
+		case KERNEL_SYSCALL_ATTACH_PIN_EVENT:
+			return (uint32_t)Kernel_AttachPinEvent(activeApp,
+												   KERNEL_SYSCALL_PIN_ARG_PORT(arg0),
+												   KERNEL_SYSCALL_PIN_ARG_PIN(arg0),
+												   arg1, arg2);
+		case KERNEL_SYSCALL_FLASH_REQUEST:
+			return (uint32_t)Kernel_QueueFlashRequest(activeApp, (OS_FlashRequest*)arg0, arg1);
+		case KERNEL_SYSCALL_GRANT_PERIPHERAL:
+			return (uint32_t)Kernel_GrantPeripheral(activeApp, (Peripheral)arg0);
+		case KERNEL_SYSCALL_IRQ_LATENCY:
+			return (uint32_t)GetIRQLatencyStats(activeApp, arg0, (OS_IRQLatencyStats*)arg1);
+		case KERNEL_SYSCALL_CONFIGURE_PIN:
+			return (uint32_t)Kernel_ConfigurePin(activeApp,
+												 KERNEL_SYSCALL_PIN_ARG_PORT(arg0),
+												 KERNEL_SYSCALL_PIN_ARG_PIN(arg0),
+												 arg1, arg2);
+		case KERNEL_SYSCALL_STACK_REPORT:
+			Kernel_ReportStackUsage();
+			return (uint32_t)RESULT_SUCCESS;
+		default:
+			break;
+	}
+
+	return (uint32_t)RESULT_FAIL;
 }
 
 /**
@@ -248,10 +473,28 @@ PRIVATE ALWAYS_INLINE void InitializeKernel(void)
 
 	/* Initialize Scheduler */
 	Scheduler_Init(kernelSettings.taskPool);
+
+	/* Idle Task runs when all applications are blocked */
+	InitializeIdleTask();
+
+	/* Applications request Kernel services using System Calls */
+	Kernel_InitializeSystemCalls(HandleSystemCall);
+
+	/* Peripherals are free to grant except the ones Kernel uses */
+	Kernel_InitializePeripheralGrants();
+
+	/* ISRs can defer their works to Kernel from now on */
+	Kernel_InitializeDeferredWork();
 }
 
 PRIVATE ALWAYS_INLINE void InitializeHW(void)
 {
+	/* 
+	 * Paint Kernel Stack before it is used by ISRs to track its usage. 
+	 * Interrupts are not enabled yet.
+	 */
+	Kernel_PaintMainStack();
+
 	/* Initialize CPU First */
 	Kernel_InitializeCPU();
 	
@@ -263,9 +506,206 @@ PRIVATE ALWAYS_INLINE void InitializeHW(void)
 	#else
 	Kernel_ActivateMemoryProtection();
 	#endif
+
+	/* Start System Time Base. All time stamps are based on this clock */
+	kernelSettings.timeBase = Kernel_InitializeTimeBase(SYSTEM_TIMER_TIME_BASE, 
+														KERNEL_TIME_BASE_PRIORITY,
+														SYSTEM_TIME_BASE_FREQUENCY);
+
+	/* User Timers follow System Time Base */
+	Kernel_InitializeUserTimers();
+
+#if OS_ENABLE_CLOCK_GOVERNOR
+	/* CPU Clock follows CPU load from now on */
+	Kernel_InitializeClockGovernor(kernelSettings.timeBase);
+#endif /* OS_ENABLE_CLOCK_GOVERNOR */
 }
 
 /***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Adds a memory region to region table of an application
+ */
+INTERNAL int32_t Kernel_AddMemoryRegion(Application* app, uint32_t startAddress, 
+										uint32_t size, bool writable, bool executable)
+{
+	TCB* tcb = &app->tcb;
+	MemoryRegion* region;
+
+	if (tcb->numOfMemoryRegions >= OS_MAX_APP_MEMORY_REGIONS)
+	{
+		return RESULT_FAIL;
+	}
+
+	region = &app->memoryRegions[tcb->numOfMemoryRegions];
+	region->startAddress = startAddress;
+	region->size = size;
+	region->flags.writable = writable;
+	region->flags.executable = executable;
+
+	if (!Kernel_IsValidMemoryRegion(region))
+	{
+		return RESULT_FAIL;
+	}
+
+	/* 
+	 * Publish region after it is filled completely. Driver Layer may look up
+	 * region table at any time (on a MPU fault).
+	 */
+	tcb->numOfMemoryRegions++;
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Checks whether a memory block is in RAM section of an application
+ */
+INTERNAL bool Kernel_IsInApplicationRAM(Application* app, uint32_t address, uint32_t size)
+{
+	TCB* tcb = &app->tcb;
+
+	return (address >= tcb->dataStartAddress) &&
+		   (size <= tcb->dataSize) &&
+		   (address - tcb->dataStartAddress <= tcb->dataSize - size);
+}
+
+/*
+ * Removes a memory region from region table of an application
+ */
+INTERNAL int32_t Kernel_RemoveMemoryRegion(Application* app, uint32_t startAddress, uint32_t size)
+{
+	TCB* tcb = &app->tcb;
+	uint32_t index;
+
+	for (index = 0; index < tcb->numOfMemoryRegions; index++)
+	{
+		if ((app->memoryRegions[index].startAddress == startAddress) &&
+			(app->memoryRegions[index].size == size))
+		{
+			break;
+		}
+	}
+
+	if (index == tcb->numOfMemoryRegions)
+	{
+		return RESULT_FAIL;
+	}
+
+	Kernel_EnterCritical();
+
+	/* Keep table packed, regions after removed one are moved down */
+	for (; index < tcb->numOfMemoryRegions - 1; index++)
+	{
+		app->memoryRegions[index] = app->memoryRegions[index + 1];
+	}
+
+	tcb->numOfMemoryRegions--;
+
+	/* 
+	 * Removed region may still be loaded into MPU. Dynamic regions are 
+	 * flushed at next context switch so application loses access when it 
+	 * runs again.
+	 */
+	Kernel_ExitCritical();
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Returns an application
+ */
+INTERNAL Application* Kernel_GetApplication(int32_t appId)
+{
+	if ((appId < 0) || (appId >= NUM_OF_USER_TASKS))
+	{
+		return NULL;
+	}
+
+	return &kernelSettings.taskPool[appId];
+}
+
+/*
+ * Returns stack usage of an application or Kernel
+ */
+INTERNAL int32_t Kernel_GetStackUsage(Application* app, KernelStackUsage* usage)
+{
+	if (usage == NULL)
+	{
+		return RESULT_FAIL;
+	}
+
+	if (app == NULL)
+	{
+		Kernel_GetMainStackUsage(usage);
+	}
+	else
+	{
+		Kernel_GetTaskStackUsage(app->tcb.stackStartAddress, app->tcb.stackSize, usage);
+	}
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Prints stack usages to debug output
+ */
+INTERNAL void Kernel_ReportStackUsage(void)
+{
+	KernelStackUsage usage;
+	Application* app = &kernelSettings.taskPool[0];
+	int32_t taskIndex;
+
+	(void)Kernel_GetStackUsage(NULL, &usage);
+	DEBUG_PRINT_ERROR("\nSTK Kernel Size:%u Peak:%u", usage.size, usage.maxUsage);
+
+	for (taskIndex = 0; taskIndex < NUM_OF_USER_TASKS; taskIndex++, app++)
+	{
+		(void)Kernel_GetStackUsage(app, &usage);
+		DEBUG_PRINT_ERROR("\nSTK App:%d Ram:%u Size:%u Peak:%u", 
+						  app->id, app->tcb.dataSize, usage.size, usage.maxUsage);
+	}
+}
+
+/*
+ * Returns total sleep time of Idle Task
+ */
+INTERNAL uint64_t Kernel_GetIdleTime(void)
+{
+	return kernelSettings.idleTime;
+}
+
+/*
+ * Prints interrupt latency statistics to debug output
+ */
+INTERNAL void Kernel_ReportIRQLatency(void)
+{
+	KernelIRQLatencyStats stats;
+	uint32_t source;
+	uint32_t bucket;
+
+	for (source = 0; Kernel_GetIRQLatencyStats(source, &stats) == RESULT_SUCCESS; source++)
+	{
+		DEBUG_PRINT_ERROR("\nIRQ:%d Cnt:%u Min:%u Max:%u Hist:", 
+						  stats.irqNo, stats.count, stats.minLatency, stats.maxLatency);
+
+		for (bucket = 0; bucket < KERNEL_IRQ_LATENCY_NUM_OF_BUCKETS; bucket++)
+		{
+			DEBUG_PRINT_ERROR(" %u", stats.histogram[bucket]);
+		}
+	}
+}
+
+LOCATE_AT(int32_t OS_GetIRQLatencyStats(uint32_t source, OS_IRQLatencyStats* stats), "0xF800");
+PUBLIC int32_t OS_GetIRQLatencyStats(uint32_t source, OS_IRQLatencyStats* stats)
+{
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_IRQ_LATENCY, source, (uint32_t)stats, 0);
+}
+
+LOCATE_AT(void OS_ReportStackUsage(void), "0xFA00");
+PUBLIC void OS_ReportStackUsage(void)
+{
+	(void)Kernel_SystemCall(KERNEL_SYSCALL_STACK_REPORT, 0, 0, 0);
+}
+
 LOCATE_AT(void OS_Yield(void), "0xF000");
 PUBLIC void OS_Yield(void)
 {
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ *
+ * @file Kernel_ClockGovernor.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief CPU Load Driven Clock Governor.
+ *
+ *		Governor runs on a Time Base channel in fixed windows
+ *		(OS_CLOCK_GOVERNOR_PERIOD_MS). CPU Load of a window is calculated
+ *		from sleep time of Idle Task and CPU Clock level is selected for
+ *		next window :
+ *
+ *		  - Load >= OS_CLOCK_GOVERNOR_UP_LOAD : Highest level, a burst is
+ *		    served at full speed without stepping through levels.
+ *		  - Otherwise : Busy time scales with CPU Clock so load on a lower
+ *		    level is predicted and lowest level which keeps predicted load
+ *		    under OS_CLOCK_GOVERNOR_TARGET_LOAD is selected. Governor never
+ *		    speeds up in this case so levels do not oscillate.
+ *
+ *		Time Base ticks are not affected by level changes (see Drv_Clock.h)
+ *		so windows and all timestamps keep their accuracy.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+
+#include "Debug.h"
+
+#include "postypes.h"
+
+#if OS_ENABLE_CLOCK_GOVERNOR
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#if OS_CLOCK_GOVERNOR_TARGET_LOAD >= OS_CLOCK_GOVERNOR_UP_LOAD
+#error "OS_CLOCK_GOVERNOR_TARGET_LOAD must be lower than OS_CLOCK_GOVERNOR_UP_LOAD!"
+#endif
+
+#if OS_CLOCK_GOVERNOR_CHANNEL >= KERNEL_NUM_OF_TIME_BASE_CHANNELS
+#error "OS_CLOCK_GOVERNOR_CHANNEL is not a client channel of Time Base!"
+#endif
+
+/* Load of a window without any sleep */
+#define GOVERNOR_FULL_LOAD				(100)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Clock Governor
+ */
+typedef struct
+{
+	/* System Time Base */
+	KernelTimerHandle timeBase;
+	/* Window length in System Time ticks */
+	uint32_t period;
+	/* End of current window (lower 32 bits of System Time) */
+	uint32_t windowEnd;
+	/* System Time at start of current window */
+	uint64_t windowStart;
+	/* Idle Time at start of current window */
+	uint64_t windowIdleTime;
+} ClockGovernor;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+PRIVATE ClockGovernor governor;
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Selects CPU Clock level for next window.
+ *
+ * @param load CPU Load of last window in percent
+ *
+ * @return CPU Clock Level
+ */
+PRIVATE ClockLevel SelectClockLevel(uint32_t load)
+{
+	ClockLevel activeLevel = Kernel_GetClockLevel();
+	uint64_t busyLoad = (uint64_t)load * Kernel_GetClockLevelFrequency(activeLevel);
+	ClockLevel level;
+
+	if (load >= OS_CLOCK_GOVERNOR_UP_LOAD)
+	{
+		return Kernel_GetNumOfClockLevels() - 1;
+	}
+
+	for (level = 0; level < activeLevel; level++)
+	{
+		/* Predicted Load = load x activeFrequency / levelFrequency */
+		if (busyLoad <= (uint64_t)OS_CLOCK_GOVERNOR_TARGET_LOAD * Kernel_GetClockLevelFrequency(level))
+		{
+			return level;
+		}
+	}
+
+	return activeLevel;
+}
+
+/*
+ * Evaluates CPU Load at the end of a window and applies CPU Clock level.
+ *  Called from Time Base ISR which can use Kernel services.
+ */
+PRIVATE void EvaluateClockLevel(void)
+{
+	uint64_t now = Kernel_GetSystemTime();
+	uint64_t idleTime = Kernel_GetIdleTime();
+	uint64_t elapsed = now - governor.windowStart;
+	uint64_t idle = idleTime - governor.windowIdleTime;
+	uint32_t load;
+
+	/* Windows are drift free, next one ends one period after this one */
+	governor.windowEnd += governor.period;
+	Kernel_StartTimeBaseChannelAt(governor.timeBase, OS_CLOCK_GOVERNOR_CHANNEL, governor.windowEnd);
+
+	governor.windowStart = now;
+	governor.windowIdleTime = idleTime;
+
+	/* A sleep which is started in previous window is accounted in this one */
+	if (idle >= elapsed)
+	{
+		load = 0;
+	}
+	else
+	{
+		load = (uint32_t)(((elapsed - idle) * GOVERNOR_FULL_LOAD) / elapsed);
+	}
+
+	/*
+	 * Level cannot be changed while a UART is sending. It is not important,
+	 * level is selected again on next window.
+	 */
+	(void)Kernel_SetClockLevel(SelectClockLevel(load));
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+
+/*
+ * Initializes CPU Clock Levels and starts Clock Governor.
+ */
+INTERNAL void Kernel_InitializeClockGovernor(KernelTimerHandle timeBase)
+{
+	/* CPU runs at highest (startup) level until first window ends */
+	Kernel_InitializeClockLevels();
+
+	governor.timeBase = timeBase;
+	governor.period = (Kernel_GetSystemTimeFrequency() / 1000) * OS_CLOCK_GOVERNOR_PERIOD_MS;
+
+	DEBUG_ASSERT_MESSAGE(governor.period != 0, "Unsupported System Time Frequency!");
+
+	governor.windowStart = Kernel_GetSystemTime();
+	governor.windowIdleTime = Kernel_GetIdleTime();
+	governor.windowEnd = (uint32_t)governor.windowStart + governor.period;
+
+	Kernel_CreateTimeBaseChannel(timeBase, OS_CLOCK_GOVERNOR_CHANNEL, EvaluateClockLevel);
+	Kernel_StartTimeBaseChannelAt(timeBase, OS_CLOCK_GOVERNOR_CHANNEL, governor.windowEnd);
+}
+
+#endif /* OS_ENABLE_CLOCK_GOVERNOR */
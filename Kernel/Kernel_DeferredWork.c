@@ -0,0 +1,271 @@
+/*******************************************************************************
+ *
+ * @file Kernel_DeferredWork.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Deferred Interrupt Works (Bottom Halves).
+ *
+ *		ISRs queue a function and its context and return immediately. Kernel
+ *		runs queued works in a Software Interrupt which has lower priority
+ *		than device interrupts (OS_DEFERRED_WORK_PRIORITY) so long running
+ *		client callbacks do not stretch interrupt latency of other devices.
+ *
+ *		Queue is a ring with free running indexes. Producers (ISRs) are
+ *		serialized by critical sections, single consumer (handler) does not
+ *		need any lock.
+ *
+ *		Zero Latency handlers (see Kernel_ZeroLatency.h) are not masked by
+ *		critical sections so they use a separate Handoff Queue. Producers
+ *		reserve entries using compare and swap (LDREX/STREX) and publish
+ *		each entry with its sequence number.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_ZeroLatency.h"
+#include "Kernel_Internal.h"
+
+#include "Debug.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#if (OS_DEFERRED_WORK_QUEUE_SIZE & (OS_DEFERRED_WORK_QUEUE_SIZE - 1)) != 0
+#error "OS_DEFERRED_WORK_QUEUE_SIZE must be a power of two!"
+#endif
+
+#if !KERNEL_IRQ_IS_KERNEL_AWARE(OS_DEFERRED_WORK_PRIORITY)
+#error "OS_DEFERRED_WORK_PRIORITY must not be higher than MAX_SYSCALL_INTERRUPT_PRIORITY!"
+#endif
+
+/*
+ * PendSV has lowest priority (and lowest sub priority) so handler always runs
+ * before context switch, even with same preempt priority.
+ */
+#if OS_DEFERRED_WORK_PRIORITY > KERNEL_IRQ_LOWEST_PRIORITY
+#error "OS_DEFERRED_WORK_PRIORITY is out of range of preempt priority bits!"
+#endif
+
+#if (OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE & (OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE - 1)) != 0
+#error "OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE must be a power of two!"
+#endif
+
+/* Mask to convert free running index to queue index */
+#define DEFERRED_WORK_INDEX_MASK		(OS_DEFERRED_WORK_QUEUE_SIZE - 1)
+
+/* Mask to convert free running index to handoff queue index */
+#define HANDOFF_INDEX_MASK				(OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE - 1)
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Deferred Work
+ */
+typedef struct
+{
+	/* Work Function */
+	OS_DeferredWorkFunction function;
+	/* Context of Work Function */
+	void* context;
+} DeferredWork;
+
+/*
+ * Handoff Entry
+ *  Producers (Zero Latency handlers) may preempt each other between 
+ *  reserving and filling an entry so each entry is published separately 
+ *  by its sequence. All fields are volatile to keep write order.
+ */
+typedef struct
+{
+	/* Free running index + 1 of entry when it is published */
+	volatile uint32_t sequence;
+	/* Handed off Function */
+	volatile OS_HandoffFunction function;
+	/* Context of Function */
+	void* volatile context;
+} HandoffEntry;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Deferred Work Queue */
+PRIVATE DeferredWork workQueue[OS_DEFERRED_WORK_QUEUE_SIZE];
+
+/* Free running index of next work to run. Written only by handler. */
+PRIVATE volatile uint32_t workHead;
+
+/* Free running index of next free entry. Written only by producers. */
+PRIVATE volatile uint32_t workTail;
+
+/* Zero Latency Handoff Queue */
+PRIVATE HandoffEntry handoffQueue[OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE];
+
+/* Free running index of next handoff to run. Written only by handler. */
+PRIVATE volatile uint32_t handoffHead;
+
+/* Free running index of next free handoff entry. Reserved atomically. */
+PRIVATE volatile uint32_t handoffTail;
+
+/* Handler is installed, works can be queued */
+PRIVATE bool deferredWorkAvailable;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+/*
+ * Deferred Work Handler (Software Interrupt Handler).
+ *  Runs all queued works including works which are queued while handler is
+ *  running (by higher priority ISRs).
+ */
+PRIVATE void DeferredWorkHandler(void)
+{
+	DeferredWork work;
+	HandoffEntry* entry;
+
+	/* 
+	 * Handoffs of Zero Latency Tier. Handler stops on an entry which is 
+	 * reserved but not published yet. Its producer triggers handler again 
+	 * after publishing.
+	 */
+	entry = &handoffQueue[handoffHead & HANDOFF_INDEX_MASK];
+
+	while (entry->sequence == (handoffHead + 1))
+	{
+		/* Copy entry first, it can be reused as soon as head is moved */
+		work.function = entry->function;
+		work.context = entry->context;
+		handoffHead++;
+
+		work.function(work.context);
+
+		entry = &handoffQueue[handoffHead & HANDOFF_INDEX_MASK];
+	}
+
+	while (workHead != workTail)
+	{
+		/* Copy entry first, it can be reused as soon as head is moved */
+		work = workQueue[workHead & DEFERRED_WORK_INDEX_MASK];
+		workHead++;
+
+		work.function(work.context);
+	}
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Deferred Work Queue
+ */
+INTERNAL void Kernel_InitializeDeferredWork(void)
+{
+	uint32_t i;
+
+	workHead = 0;
+	workTail = 0;
+
+	handoffHead = 0;
+	handoffTail = 0;
+
+	for (i = 0; i < OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE; i++)
+	{
+		handoffQueue[i].sequence = 0;
+	}
+
+	deferredWorkAvailable =
+		(Kernel_InitializeSoftIRQ(DeferredWorkHandler, OS_DEFERRED_WORK_PRIORITY) == RESULT_SUCCESS);
+
+	if (!deferredWorkAvailable)
+	{
+		/* Software Interrupt needs a RAM Vector Table */
+		DEBUG_PRINT_ERROR("\nDeferred Work is not available");
+	}
+}
+
+/*
+ * Queues a deferred work
+ */
+PUBLIC int32_t OS_QueueDeferredWork(OS_DeferredWorkFunction function, void* context)
+{
+	DeferredWork* work;
+
+	/* A queued work would never run without handler */
+	if ((function == NULL) || !deferredWorkAvailable)
+	{
+		return RESULT_FAIL;
+	}
+
+	Kernel_EnterCritical();
+
+	if ((workTail - workHead) >= OS_DEFERRED_WORK_QUEUE_SIZE)
+	{
+		/* Queue is full */
+		Kernel_ExitCritical();
+
+		return RESULT_FAIL;
+	}
+
+	work = &workQueue[workTail & DEFERRED_WORK_INDEX_MASK];
+	work->function = function;
+	work->context = context;
+
+	/* Publish work after it is filled completely */
+	workTail++;
+
+	Kernel_ExitCritical();
+
+	/* Handler runs after all higher priority ISRs (including caller) return */
+	Kernel_TriggerSoftIRQ();
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Hands a function off from Zero Latency Tier
+ */
+PUBLIC int32_t OS_ZeroLatencyHandoff(OS_HandoffFunction function, void* context)
+{
+	HandoffEntry* entry;
+	uint32_t tail;
+
+	if ((function == NULL) || !deferredWorkAvailable)
+	{
+		return RESULT_FAIL;
+	}
+
+	/* 
+	 * Reserve an entry. Critical sections cannot be used because they do not
+	 * mask Zero Latency handlers so entry is reserved lock-free.
+	 */
+	do
+	{
+		tail = handoffTail;
+
+		if ((tail - handoffHead) >= OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE)
+		{
+			/* Queue is full */
+			return RESULT_FAIL;
+		}
+	} while (!Kernel_AtomicCompareAndSwap(&handoffTail, tail, tail + 1));
+
+	entry = &handoffQueue[tail & HANDOFF_INDEX_MASK];
+	entry->function = function;
+	entry->context = context;
+
+	/* Publish entry after it is filled completely */
+	entry->sequence = tail + 1;
+
+	/* Pending a Software Interrupt is a single register write, safe here */
+	Kernel_TriggerSoftIRQ();
+
+	return RESULT_SUCCESS;
+}
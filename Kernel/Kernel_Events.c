@@ -0,0 +1,329 @@
+/*******************************************************************************
+ *
+ * @file Kernel_Events.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Application Events and Pin Event Delivery.
+ *
+ *		Each application has 32 event flags. An application blocks on its
+ *		events using OS_WaitEvents() and ISRs (or driver callbacks) wake it
+ *		up using OS_SignalEvents(). Blocked applications are not scheduled
+ *		and CPU sleeps in Idle Task if all applications are blocked.
+ *
+ *		Applications cannot install interrupt callbacks because callbacks
+ *		run in privileged handler mode so Kernel attaches pin interrupts on
+ *		behalf of applications and signals their events on pin edges.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+
+#include "Debug.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Pin Event
+ *  Binds edges of a pin to events of an application.
+ */
+typedef struct
+{
+	/* Owner Application, NULL if slot is free */
+	Application* app;
+	/* Port Number of pin */
+	uint32_t port;
+	/* Pin Number of pin */
+	uint32_t pin;
+	/* Events to signal on pin edges */
+	uint32_t events;
+} PinEvent;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Attached Pins */
+PRIVATE PinEvent pinEvents[OS_MAX_PIN_EVENTS];
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+/*
+ * Signals events of an application.
+ *  [IMP] Must be called in a critical section.
+ */
+PRIVATE void SignalApplication(Application* app, uint32_t events)
+{
+	app->pendingEvents |= events;
+
+	if ((app->state == AppState_Blocked) &&
+		((app->pendingEvents & app->waitedEvents) != 0))
+	{
+		/* Application runs in its next turn (or Idle Task yields to it) */
+		app->waitedEvents = 0;
+		app->state = AppState_Ready;
+	}
+}
+
+/*
+ * Finds attached slot of a pin.
+ *
+ * @return Pin Event slot or NULL if pin is not attached
+ */
+PRIVATE PinEvent* FindPinEvent(uint32_t port, uint32_t pin)
+{
+	uint32_t i;
+
+	for (i = 0; i < OS_MAX_PIN_EVENTS; i++)
+	{
+		if ((pinEvents[i].app != NULL) &&
+			(pinEvents[i].port == port) && (pinEvents[i].pin == pin))
+		{
+			return &pinEvents[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Finds a free Pin Event slot.
+ *
+ * @return Free slot or NULL if all slots are used
+ */
+PRIVATE PinEvent* AllocatePinEvent(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < OS_MAX_PIN_EVENTS; i++)
+	{
+		if (pinEvents[i].app == NULL)
+		{
+			return &pinEvents[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Detaches a pin from its application.
+ */
+PRIVATE void DetachPinEvent(PinEvent* pinEvent)
+{
+	/* Stop interrupts first so callback does not see a free slot */
+	Kernel_DisablePinInterrupt(pinEvent->port, pinEvent->pin);
+
+	Kernel_EnterCritical();
+	pinEvent->app = NULL;
+	pinEvent->events = 0;
+	Kernel_ExitCritical();
+}
+
+/*
+ * Pin Interrupt Callback.
+ *  Called from GPIO ISR.
+ */
+PRIVATE void PinEventCallback(uint32_t port, uint32_t pin, Drv_GPIO_Edge edge)
+{
+	PinEvent* pinEvent;
+
+	(void)edge;
+
+	Kernel_EnterCritical();
+
+	pinEvent = FindPinEvent(port, pin);
+
+	if (pinEvent != NULL)
+	{
+		SignalApplication(pinEvent->app, pinEvent->events);
+	}
+
+	Kernel_ExitCritical();
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Waits events on behalf of an application
+ */
+INTERNAL uint32_t Kernel_WaitEvents(Application* app, uint32_t eventMask)
+{
+	uint32_t events;
+
+	if (eventMask == 0)
+	{
+		return 0;
+	}
+
+	Kernel_EnterCritical();
+
+	events = app->pendingEvents & eventMask;
+
+	if (events != 0)
+	{
+		/* Already signaled, consume events without blocking */
+		app->pendingEvents &= ~events;
+	}
+	else
+	{
+		app->waitedEvents = eventMask;
+		app->state = AppState_Blocked;
+	}
+
+	Kernel_ExitCritical();
+
+	if (events == 0)
+	{
+		/* Switch to next ready application (or Idle Task) */
+		Kernel_Yield(true);
+	}
+
+	return events;
+}
+
+/*
+ * Attaches a pin to events of an application
+ */
+INTERNAL int32_t Kernel_AttachPinEvent(Application* app, uint32_t port, uint32_t pin,
+									   uint32_t edges, uint32_t events)
+{
+	PinEvent* pinEvent = FindPinEvent(port, pin);
+	Drv_GPIO_Edge pinEdges = (Drv_GPIO_Edge)0;
+
+	if ((pinEvent != NULL) && (pinEvent->app != app))
+	{
+		/* Pin belongs to another application */
+		return RESULT_FAIL;
+	}
+
+	if (events == 0)
+	{
+		if (pinEvent != NULL)
+		{
+			DetachPinEvent(pinEvent);
+		}
+
+		return RESULT_SUCCESS;
+	}
+
+	if (edges & OS_PIN_EDGE_RISING)
+	{
+		pinEdges = (Drv_GPIO_Edge)(pinEdges | DRV_GPIO_EDGE_RISING);
+	}
+
+	if (edges & OS_PIN_EDGE_FALLING)
+	{
+		pinEdges = (Drv_GPIO_Edge)(pinEdges | DRV_GPIO_EDGE_FALLING);
+	}
+
+	if (pinEvent == NULL)
+	{
+		pinEvent = AllocatePinEvent();
+
+		if (pinEvent == NULL)
+		{
+			return RESULT_FAIL;
+		}
+	}
+
+	/* Publish slot before interrupt is enabled */
+	Kernel_EnterCritical();
+	pinEvent->port = port;
+	pinEvent->pin = pin;
+	pinEvent->events = events;
+	pinEvent->app = app;
+	Kernel_ExitCritical();
+
+	if (Kernel_EnablePinInterrupt(port, pin, pinEdges, PinEventCallback) != RESULT_SUCCESS)
+	{
+		DetachPinEvent(pinEvent);
+
+		return RESULT_FAIL;
+	}
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Detaches all pins of an application
+ */
+INTERNAL void Kernel_ReleasePinEvents(Application* app)
+{
+	uint32_t i;
+
+	for (i = 0; i < OS_MAX_PIN_EVENTS; i++)
+	{
+		if (pinEvents[i].app == app)
+		{
+			DetachPinEvent(&pinEvents[i]);
+		}
+	}
+}
+
+/*
+ * Signals events of an application
+ */
+PUBLIC int32_t OS_SignalEvents(int32_t appId, uint32_t events)
+{
+	Application* app = Kernel_GetApplication(appId);
+
+	if ((app == NULL) || (events == 0))
+	{
+		return RESULT_FAIL;
+	}
+
+	Kernel_EnterCritical();
+	SignalApplication(app, events);
+	Kernel_ExitCritical();
+
+	return RESULT_SUCCESS;
+}
+
+LOCATE_AT(uint32_t OS_WaitEvents(uint32_t eventMask), "0xF300");
+PUBLIC uint32_t OS_WaitEvents(uint32_t eventMask)
+{
+	uint32_t events;
+
+	if (eventMask == 0)
+	{
+		return 0;
+	}
+
+	/*
+	 * System Call returns 0 if application is blocked. Application continues
+	 * here after it is woken up so wait again to consume signaled events.
+	 */
+	do
+	{
+		events = Kernel_SystemCall(KERNEL_SYSCALL_WAIT_EVENTS, eventMask, 0, 0);
+	} while (events == 0);
+
+	return events;
+}
+
+LOCATE_AT(int32_t OS_AttachPinEvent(uint32_t port, uint32_t pin, uint32_t edges, uint32_t events), "0xF400");
+PUBLIC int32_t OS_AttachPinEvent(uint32_t port, uint32_t pin, uint32_t edges, uint32_t events)
+{
+	/* Pin must fit into its field of packed argument */
+	if (KERNEL_SYSCALL_PIN_ARG_PIN(pin) != pin)
+	{
+		return RESULT_FAIL;
+	}
+
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_ATTACH_PIN_EVENT,
+									  KERNEL_SYSCALL_PIN_ARG(port, pin), edges, events);
+}
@@ -0,0 +1,343 @@
+/*******************************************************************************
+ *
+ * @file Kernel_FlashService.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Asynchronous Flash Programming Service for Applications.
+ *
+ *		Flash cannot be read while it is programmed so IAP calls block CPU
+ *		with interrupts disabled. A sector erase takes up to ~100 ms and an
+ *		application which programs flash directly stalls whole system.
+ *
+ *		Applications queue erase and write requests using System Calls and
+ *		continue to run. Kernel runs queued requests in small steps (one
+ *		sector for erase, OS_FLASH_WRITE_UNIT bytes for write) at scheduling
+ *		points (Context Switching) so other applications run between steps.
+ *		Idle Task yields to service while there is a queued request so
+ *		requests also progress when all applications wait for them.
+ *
+ *		Completion is reported with request status and request events of
+ *		requester application (see OS_WaitEvents).
+ *
+ *		Requests are queued in SVC Handler and run in PendSV Handler. They
+ *		do not preempt each other so queue does not need a lock.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+
+#include "Debug.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+#if (OS_FLASH_REQUEST_QUEUE_SIZE & (OS_FLASH_REQUEST_QUEUE_SIZE - 1)) != 0
+#error "OS_FLASH_REQUEST_QUEUE_SIZE must be a power of two!"
+#endif
+
+#define FLASH_REQUEST_QUEUE_MASK		(OS_FLASH_REQUEST_QUEUE_SIZE - 1)
+
+/* Flash Operations */
+#define FLASH_OPERATION_ERASE			(0)
+#define FLASH_OPERATION_WRITE			(1)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Queued Flash Request
+ */
+typedef struct
+{
+	/* Requester Application, NULL if request is cancelled */
+	Application* app;
+	/* Request in application RAM, only its status is updated */
+	OS_FlashRequest* request;
+	/* Operation (FLASH_OPERATION_XXX) */
+	uint32_t operation;
+	/*
+	 * Validated copies of request fields. Application cannot change a
+	 * request after it is queued.
+	 */
+	uint32_t address;
+	const uint8_t* data;
+	uint32_t length;
+	uint32_t events;
+	/* Number of bytes which are already erased or written */
+	uint32_t done;
+} FlashJob;
+
+/*
+ * Flash Request Queue
+ */
+typedef struct
+{
+	FlashJob jobs[OS_FLASH_REQUEST_QUEUE_SIZE];
+	/* Next job to run. Only moved by Flash Service (PendSV) */
+	uint32_t head;
+	/* Next free slot. Only moved by System Call Handler (SVC) */
+	uint32_t tail;
+} FlashQueue;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+PRIVATE FlashQueue flashQueue;
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Checks whether a flash range is in Flash Service area.
+ */
+PRIVATE bool IsInServiceArea(uint32_t address, uint32_t length)
+{
+	return (address >= OS_FLASH_SERVICE_START) &&
+		   (length <= OS_FLASH_SERVICE_SIZE) &&
+		   (address - OS_FLASH_SERVICE_START <= OS_FLASH_SERVICE_SIZE - length);
+}
+
+/*
+ * Checks whether an address is start of a flash sector.
+ */
+PRIVATE bool IsSectorStart(uint32_t address)
+{
+	int32_t sectorNo = Kernel_GetFlashSectorNo(address);
+
+	return (sectorNo >= 0) && (Kernel_GetFlashSectorAddress((uint32_t)sectorNo) == address);
+}
+
+/*
+ * Checks whether an address is end of a flash sector (start of next one).
+ */
+PRIVATE bool IsSectorEnd(uint32_t address)
+{
+	int32_t sectorNo = Kernel_GetFlashSectorNo(address - 1);
+
+	return (sectorNo >= 0) && (Kernel_GetFlashSectorAddress((uint32_t)sectorNo + 1) == address);
+}
+
+/*
+ * Erases next sector of an erase job.
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+PRIVATE int32_t EraseNextSector(FlashJob* job)
+{
+	uint32_t address = job->address + job->done;
+	uint32_t sectorNo = (uint32_t)Kernel_GetFlashSectorNo(address);
+
+	if ((Kernel_PrepareFlashSector(sectorNo) != FLASH_STATUS_SUCCESS) ||
+		(Kernel_EraseFlashSector(sectorNo) != RESULT_SUCCESS))
+	{
+		return RESULT_FAIL;
+	}
+
+	job->done += Kernel_GetFlashSectorAddress(sectorNo + 1) - address;
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Writes next unit (OS_FLASH_WRITE_UNIT bytes) of a write job.
+ *  Units are aligned so a unit never crosses a sector.
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+PRIVATE int32_t WriteNextUnit(FlashJob* job)
+{
+	uint32_t address = job->address + job->done;
+	uint32_t sectorNo = (uint32_t)Kernel_GetFlashSectorNo(address);
+
+	if ((Kernel_PrepareFlashSector(sectorNo) != FLASH_STATUS_SUCCESS) ||
+		(Kernel_WriteFlash(address, (uint8_t*)&job->data[job->done],
+						   OS_FLASH_WRITE_UNIT) != RESULT_SUCCESS))
+	{
+		return RESULT_FAIL;
+	}
+
+	job->done += OS_FLASH_WRITE_UNIT;
+
+	return RESULT_SUCCESS;
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+
+/*
+ * Queues a flash request on behalf of an application
+ */
+INTERNAL int32_t Kernel_QueueFlashRequest(Application* app, OS_FlashRequest* request, uint32_t operation)
+{
+	FlashJob* job;
+	uint32_t address;
+	const uint8_t* data;
+	uint32_t length;
+
+	/* Request is read and updated by Kernel so it must belong to requester */
+	if (!Kernel_IsInApplicationRAM(app, (uint32_t)request, sizeof(OS_FlashRequest)))
+	{
+		return RESULT_FAIL;
+	}
+
+	address = request->address;
+	data = request->data;
+	length = request->length;
+
+	if ((length == 0) || !IsInServiceArea(address, length))
+	{
+		return RESULT_FAIL;
+	}
+
+	if (operation == FLASH_OPERATION_ERASE)
+	{
+		if (!IsSectorStart(address) || !IsSectorEnd(address + length))
+		{
+			return RESULT_FAIL;
+		}
+	}
+	else if (operation == FLASH_OPERATION_WRITE)
+	{
+		/* IAP copies word aligned RAM to OS_FLASH_WRITE_UNIT aligned flash */
+		if (((address % OS_FLASH_WRITE_UNIT) != 0) ||
+			((length % OS_FLASH_WRITE_UNIT) != 0) ||
+			(((uint32_t)data % sizeof(uint32_t)) != 0) ||
+			!Kernel_IsInApplicationRAM(app, (uint32_t)data, length))
+		{
+			return RESULT_FAIL;
+		}
+	}
+	else
+	{
+		return RESULT_FAIL;
+	}
+
+	if ((flashQueue.tail - flashQueue.head) == OS_FLASH_REQUEST_QUEUE_SIZE)
+	{
+		/* Queue is full, application can retry after a completion */
+		return RESULT_FAIL;
+	}
+
+	job = &flashQueue.jobs[flashQueue.tail & FLASH_REQUEST_QUEUE_MASK];
+	job->app = app;
+	job->request = request;
+	job->operation = operation;
+	job->address = address;
+	job->data = data;
+	job->length = length;
+	job->events = request->events;
+	job->done = 0;
+
+	request->status = OS_FLASH_STATUS_PENDING;
+
+	/* Publish job after it is filled */
+	flashQueue.tail++;
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Runs a step of queued flash requests
+ */
+INTERNAL void Kernel_RunFlashService(void)
+{
+	FlashJob* job;
+	int32_t result;
+
+	/* Skip cancelled jobs, they do not deserve a step */
+	while (flashQueue.head != flashQueue.tail)
+	{
+		job = &flashQueue.jobs[flashQueue.head & FLASH_REQUEST_QUEUE_MASK];
+
+		if (job->app != NULL)
+		{
+			break;
+		}
+
+		flashQueue.head++;
+	}
+
+	if (flashQueue.head == flashQueue.tail)
+	{
+		return;
+	}
+
+	if (job->operation == FLASH_OPERATION_ERASE)
+	{
+		result = EraseNextSector(job);
+	}
+	else
+	{
+		result = WriteNextUnit(job);
+	}
+
+	if ((result == RESULT_SUCCESS) && (job->done < job->length))
+	{
+		/* Next step runs at next scheduling point */
+		return;
+	}
+
+	job->request->status = (result == RESULT_SUCCESS) ? OS_FLASH_STATUS_SUCCESS :
+														 OS_FLASH_STATUS_FAIL;
+
+	if (job->events != 0)
+	{
+		(void)OS_SignalEvents(job->app->id, job->events);
+	}
+
+	flashQueue.head++;
+}
+
+/*
+ * Checks whether there is a queued flash request
+ */
+INTERNAL bool Kernel_HasFlashWork(void)
+{
+	return flashQueue.head != flashQueue.tail;
+}
+
+/*
+ * Cancels queued flash requests of an application
+ */
+INTERNAL void Kernel_ReleaseFlashRequests(Application* app)
+{
+	uint32_t i;
+
+	Kernel_EnterCritical();
+
+	for (i = 0; i < OS_FLASH_REQUEST_QUEUE_SIZE; i++)
+	{
+		if (flashQueue.jobs[i].app == app)
+		{
+			flashQueue.jobs[i].app = NULL;
+		}
+	}
+
+	Kernel_ExitCritical();
+}
+
+LOCATE_AT(int32_t OS_FlashErase(OS_FlashRequest* request), "0xF500");
+PUBLIC int32_t OS_FlashErase(OS_FlashRequest* request)
+{
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_FLASH_REQUEST, (uint32_t)request,
+									  FLASH_OPERATION_ERASE, 0);
+}
+
+LOCATE_AT(int32_t OS_FlashWrite(OS_FlashRequest* request), "0xF600");
+PUBLIC int32_t OS_FlashWrite(OS_FlashRequest* request)
+{
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_FLASH_REQUEST, (uint32_t)request,
+									  FLASH_OPERATION_WRITE, 0);
+}
@@ -20,9 +20,17 @@
 #ifndef __KERNEL_INTERNAL_H
 #define __KERNEL_INTERNAL_H
 
+#ifdef KERNEL_ZERO_LATENCY_TIER
+#error "Zero Latency interrupt handlers must not use Kernel internals (see Kernel_ZeroLatency.h)!"
+#endif
+
 /********************************* INCLUDES ***********************************/
 #include "Drv_Timer.h"
+#include "Drv_UserTimer.h"
 #include "Drv_CPUCore.h"
+#include "Drv_Clock.h"
+#include "Drv_GPIO.h"
+#include "Drv_Flash.h"
 
 #include "OSConfig.h"
 #include "SysConfig.h"
@@ -43,6 +51,160 @@
  */
 #define NUM_OF_USER_TASKS				OS_MAX_USER_APP
 
+/*
+ * Stack Size of User Applications.
+ *  Stack of a user application is located at the end of its RAM section and
+ *  stack start (top) address is first word of user application image.
+ *  [IMP] Must be same with Stack_Size in startup file of user applications.
+ */
+#ifndef OS_USER_APP_STACK_SIZE
+#define OS_USER_APP_STACK_SIZE			(0x200)
+#endif /* OS_USER_APP_STACK_SIZE */
+
+/*
+ * Maximum number of additional memory regions (e.g. peripheral or buffer 
+ * windows) of a user application. 
+ *  Regions are loaded into MPU on demand so this value is not limited by 
+ *  number of MPU regions.
+ */
+#ifndef OS_MAX_APP_MEMORY_REGIONS
+#define OS_MAX_APP_MEMORY_REGIONS		(8)
+#endif /* OS_MAX_APP_MEMORY_REGIONS */
+
+/*
+ * Size of Deferred Work Queue. Must be a power of two.
+ */
+#ifndef OS_DEFERRED_WORK_QUEUE_SIZE
+#define OS_DEFERRED_WORK_QUEUE_SIZE		(16)
+#endif /* OS_DEFERRED_WORK_QUEUE_SIZE */
+
+/*
+ * NVIC Priority of Deferred Work Handler.
+ *  Lower than device interrupts so they are not delayed by deferred works,
+ *  higher than PendSV (Context Switching).
+ *  [IMP] Must be masked by critical sections (not higher than 
+ *  MAX_SYSCALL_INTERRUPT_PRIORITY) because works use Kernel services.
+ */
+#ifndef OS_DEFERRED_WORK_PRIORITY
+#define OS_DEFERRED_WORK_PRIORITY		(30)
+#endif /* OS_DEFERRED_WORK_PRIORITY */
+
+/*
+ * Size of Zero Latency Handoff Queue. Must be a power of two.
+ */
+#ifndef OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE
+#define OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE	(8)
+#endif /* OS_ZERO_LATENCY_HANDOFF_QUEUE_SIZE */
+
+/*
+ * Maximum number of pins which signal events to applications 
+ * (see OS_AttachPinEvent).
+ */
+#ifndef OS_MAX_PIN_EVENTS
+#define OS_MAX_PIN_EVENTS				(8)
+#endif /* OS_MAX_PIN_EVENTS */
+
+/*
+ * Stack Size of Idle Task. Must be a power of two because stack is also RAM
+ * section (MPU region) of Idle Task.
+ *  Idle Task runs when all applications are blocked (or terminated).
+ */
+#ifndef OS_IDLE_TASK_STACK_SIZE
+#define OS_IDLE_TASK_STACK_SIZE			(0x100)
+#endif /* OS_IDLE_TASK_STACK_SIZE */
+
+/*
+ * Enables CPU Clock Governor.
+ *  Governor measures CPU load using sleep time of Idle Task and switches CPU
+ *  Clock between validated levels (see Drv_Clock.h). Idle systems run slow
+ *  and bursts are served at full speed. Timers keep their tick rates.
+ */
+#ifndef OS_ENABLE_CLOCK_GOVERNOR
+#define OS_ENABLE_CLOCK_GOVERNOR		(0)
+#endif /* OS_ENABLE_CLOCK_GOVERNOR */
+
+/*
+ * Evaluation period of Clock Governor in milliseconds. 
+ *  Each evaluation wakes up CPU so too short periods waste power.
+ */
+#ifndef OS_CLOCK_GOVERNOR_PERIOD_MS
+#define OS_CLOCK_GOVERNOR_PERIOD_MS		(10)
+#endif /* OS_CLOCK_GOVERNOR_PERIOD_MS */
+
+/*
+ * CPU Load (percent) to switch to highest CPU Clock level immediately.
+ */
+#ifndef OS_CLOCK_GOVERNOR_UP_LOAD
+#define OS_CLOCK_GOVERNOR_UP_LOAD		(90)
+#endif /* OS_CLOCK_GOVERNOR_UP_LOAD */
+
+/*
+ * Target CPU Load (percent) on a lower CPU Clock level.
+ *  Governor slows down to lowest level which keeps predicted load under
+ *  target. Must be lower than OS_CLOCK_GOVERNOR_UP_LOAD (hysteresis).
+ */
+#ifndef OS_CLOCK_GOVERNOR_TARGET_LOAD
+#define OS_CLOCK_GOVERNOR_TARGET_LOAD	(60)
+#endif /* OS_CLOCK_GOVERNOR_TARGET_LOAD */
+
+/*
+ * Time Base channel which is used by Clock Governor.
+ */
+#ifndef OS_CLOCK_GOVERNOR_CHANNEL
+#define OS_CLOCK_GOVERNOR_CHANNEL		(0)
+#endif /* OS_CLOCK_GOVERNOR_CHANNEL */
+
+/*
+ * Flash area which applications can erase and write using Flash Service 
+ * (see OS_FlashErase). Must start and end at sector boundaries.
+ *  Default is last two sectors (64K) of LPC1768 flash.
+ */
+#ifndef OS_FLASH_SERVICE_START
+#define OS_FLASH_SERVICE_START			(0x70000)
+#endif /* OS_FLASH_SERVICE_START */
+
+#ifndef OS_FLASH_SERVICE_SIZE
+#define OS_FLASH_SERVICE_SIZE			(0x10000)
+#endif /* OS_FLASH_SERVICE_SIZE */
+
+/*
+ * Size of Flash Request Queue. Must be a power of two.
+ */
+#ifndef OS_FLASH_REQUEST_QUEUE_SIZE
+#define OS_FLASH_REQUEST_QUEUE_SIZE		(4)
+#endif /* OS_FLASH_REQUEST_QUEUE_SIZE */
+
+/*
+ * System Call Numbers
+ */
+#define KERNEL_SYSCALL_WAIT_EVENTS		(0)
+#define KERNEL_SYSCALL_ATTACH_PIN_EVENT	(1)
+#define KERNEL_SYSCALL_FLASH_REQUEST	(2)
+#define KERNEL_SYSCALL_GRANT_PERIPHERAL	(3)
+#define KERNEL_SYSCALL_IRQ_LATENCY		(4)
+#define KERNEL_SYSCALL_CONFIGURE_PIN	(5)
+#define KERNEL_SYSCALL_STACK_REPORT		(6)
+
+/* Packs port and pin numbers into a single System Call argument */
+#define KERNEL_SYSCALL_PIN_ARG(port, pin)	(((port) << 8) | (pin))
+#define KERNEL_SYSCALL_PIN_ARG_PORT(arg)	((arg) >> 8)
+#define KERNEL_SYSCALL_PIN_ARG_PIN(arg)		((arg) & 0xFF)
+
+/* Wrapper definition to check whether an IRQ priority can use Kernel services */
+#define KERNEL_IRQ_IS_KERNEL_AWARE		DRV_IRQ_IS_KERNEL_AWARE
+
+/* Wrapper definition to check whether an IRQ priority is in Zero Latency Tier */
+#define KERNEL_IRQ_IS_ZERO_LATENCY		DRV_IRQ_IS_ZERO_LATENCY
+
+/* Wrapper definition for lowest preempt priority */
+#define KERNEL_IRQ_LOWEST_PRIORITY		DRV_IRQ_LOWEST_PREEMPT_PRIORITY
+
+/* Wrapper definition for number of IRQ Latency Histogram buckets */
+#define KERNEL_IRQ_LATENCY_NUM_OF_BUCKETS	DRV_IRQ_LATENCY_NUM_OF_BUCKETS
+
+/* Wrapper definition for number of Time Base channels which Kernel can use */
+#define KERNEL_NUM_OF_TIME_BASE_CHANNELS	DRV_TIMER_NUM_OF_TIME_BASE_CHANNELS
+
 /*
  * Number of all task including kernel and user tasks
  */
@@ -63,9 +225,18 @@
 
 /*
  * Kernel Timer Priority
- *  Kernel Timer is a critical timer so priority selected as High.
+ *  Kernel Timer runs scheduler so it must be masked by critical sections. 
+ *  Higher timer priorities are in Zero Latency Tier and they are left to 
+ *  time critical device handlers.
  */
-#define KERNEL_TIMER_PRIORITY           DRV_TIMER_PRI_HIGH
+#define KERNEL_TIMER_PRIORITY           DRV_TIMER_PRI_LOW
+
+/*
+ * System Time Base Priority
+ *  Time Base interrupt just extends counter and it can wait for a long time
+ *  so priority selected as Low.
+ */
+#define KERNEL_TIME_BASE_PRIORITY		DRV_TIMER_PRI_LOW
 
 /* TODO This value should be common for all images (BL, FW, User Apps)*/
 #define APP_IMAGE_SIGNATURE_LENGTH       (256)
@@ -90,6 +261,56 @@
 			
 #define Kernel_ActivateMemoryProtection Drv_CPUCore_InitializeMPU
 
+/* Wrapper function definition to validate a memory region of an app */
+#define Kernel_IsValidMemoryRegion		Drv_CPUCore_MPUIsValidRegion
+
+/* Wrapper function definition to install an interrupt handler */
+#define Kernel_SetIRQHandler			Drv_CPUCore_SetIRQHandler
+
+/* Wrapper function definition to initialize Software Interrupt */
+#define Kernel_InitializeSoftIRQ		Drv_CPUCore_InitializeSoftIRQ
+
+/* Wrapper function definition to trigger Software Interrupt */
+#define Kernel_TriggerSoftIRQ			Drv_CPUCore_TriggerSoftIRQ
+
+/* Wrapper function definition to register System Call Handler */
+#define Kernel_InitializeSystemCalls	Drv_CPUCore_InitializeSystemCalls
+
+/* Wrapper function definition to make a System Call */
+#define Kernel_SystemCall				Drv_CPUCore_SystemCall
+
+/* Wrapper function definitions to disable and enable all interrupts */
+#define Kernel_DisableInterrupts		Drv_CPUCore_DisableInterrupts
+#define Kernel_EnableInterrupts			Drv_CPUCore_EnableInterrupts
+
+/* Wrapper function definition to sleep until an interrupt is pending */
+#define Kernel_WaitForInterrupt			Drv_CPUCore_WaitForInterrupt
+
+/* Wrapper function definitions to enable and disable pin interrupts */
+#define Kernel_EnablePinInterrupt		Drv_GPIO_EnableInterrupt
+#define Kernel_DisablePinInterrupt		Drv_GPIO_DisableInterrupt
+
+/* Wrapper function definition to enter a critical section */
+#define Kernel_EnterCritical			Drv_CPUCore_EnterCritical
+
+/* Wrapper function definition to exit from a critical section */
+#define Kernel_ExitCritical				Drv_CPUCore_ExitCritical
+
+/* Wrapper function definition for lock-free compare and swap */
+#define Kernel_AtomicCompareAndSwap		Drv_CPUCore_AtomicCompareAndSwap
+
+/* Wrapper function definition to get register block region of a peripheral */
+#define Kernel_GetPeripheralRegion		Drv_CPUCore_GetPeripheralRegion
+
+/* Wrapper function definitions to power on and off a peripheral */
+#define Kernel_EnablePeripheral			Drv_Clock_EnablePeripheral
+#define Kernel_DisablePeripheral		Drv_Clock_DisablePeripheral
+
+/* Wrapper function definitions to configure pins and get their peripherals */
+#define Kernel_SetPinFunction			Drv_GPIO_ConfigurePin
+#define Kernel_GetPinFunction			Drv_GPIO_GetPinFunction
+#define Kernel_GetPinPeripheral			Drv_GPIO_GetPinPeripheral
+
 /* Wrapper function definition to start context switching */
 #define Kernel_StartContextSwitching    Drv_CPUCore_CSStart
 
@@ -102,6 +323,24 @@
 /* Wrapper function definition to yield running task to */
 #define Kernel_Switch                 	Drv_CPUCore_CSYield
 
+/* Wrapper function definition to paint stack of a user application */
+#define Kernel_PaintTaskStack			Drv_CPUCore_PaintStack
+
+/* Wrapper function definition to measure stack of a user application */
+#define Kernel_GetTaskStackUsage		Drv_CPUCore_GetStackUsage
+
+/* Wrapper function definition to paint Kernel (Main) stack */
+#define Kernel_PaintMainStack			Drv_CPUCore_PaintMainStack
+
+/* Wrapper function definition to measure Kernel (Main) stack */
+#define Kernel_GetMainStackUsage		Drv_CPUCore_GetMainStackUsage
+
+/* Wrapper function definition to get latency statistics of an interrupt source */
+#define Kernel_GetIRQLatencyStats		Drv_CPUCore_GetIRQLatencyStats
+
+/* Wrapper function definition to clear interrupt latency statistics */
+#define Kernel_ResetIRQLatencyStats		Drv_CPUCore_ResetIRQLatencyStats
+
 /* Wrapper function definition to create a Timer */
 #define Kernel_CreatePreemptionTimer    Drv_Timer_Create
 
@@ -111,12 +350,53 @@
 /* Wrapper function definitions to get time stamp */
 #define Kernel_GetPreemptionTimeStamp   Drv_Timer_ReadElapsedTimeInUs
 
+/* Wrapper function definition to initialize system wide Time Base */
+#define Kernel_InitializeTimeBase		Drv_Timer_InitializeTimeBase
+
+/* Wrapper function definition to get system time (Time Base ticks) */
+#define Kernel_GetSystemTime			Drv_Timer_ReadTimeBase
+
+/* Wrapper function definition to get system time frequency (ticks per second) */
+#define Kernel_GetSystemTimeFrequency	Drv_Timer_GetTimeBaseFrequency
+
+/* Wrapper function definition to initialize User Timers (on Time Base) */
+#define Kernel_InitializeUserTimers		Drv_UserTimer_Init
+
+/* Wrapper function definitions to use a channel of Time Base */
+#define Kernel_CreateTimeBaseChannel	Drv_Timer_CreateChannel
+#define Kernel_StartTimeBaseChannelAt	Drv_Timer_StartChannelAt
+
+/* Wrapper function definitions for CPU Clock levels */
+#define Kernel_InitializeClockLevels	Drv_Clock_Init
+#define Kernel_GetNumOfClockLevels		Drv_Clock_GetNumOfLevels
+#define Kernel_GetClockLevel			Drv_Clock_GetLevel
+#define Kernel_GetClockLevelFrequency	Drv_Clock_GetLevelFrequency
+#define Kernel_SetClockLevel			Drv_Clock_SetLevel
+
+/* Wrapper function definitions for Flash (IAP) operations */
+#define Kernel_PrepareFlashSector		Drv_Flash_PrepareBlock
+#define Kernel_EraseFlashSector			Drv_Flash_EraseBlock
+#define Kernel_WriteFlash				Drv_Flash_Write
+#define Kernel_GetFlashSectorNo			Drv_Flash_GetBlockNoOfAddress
+#define Kernel_GetFlashSectorAddress	Drv_Flash_GetBlockAddress
+
 /***************************** TYPE DEFINITIONS *******************************/
 /*
  * Wrapper Timer Handle definition to abstract external definition in kernel.
  */
 typedef TimerHandle KernelTimerHandle;
 
+/*
+ * Wrapper Stack Usage definition to abstract external definition in kernel.
+ */
+typedef StackUsage KernelStackUsage;
+
+/*
+ * Wrapper IRQ Latency Statistics definition to abstract external definition
+ * in kernel.
+ */
+typedef IRQLatencyStats KernelIRQLatencyStats;
+
 /*
  * Application States
  */
@@ -125,6 +405,7 @@ typedef enum
 	AppState_New,
 	AppState_Ready,
 	AppState_Running,
+	AppState_Blocked,
 	AppState_Terminated
 } ApplicationState;
 
@@ -196,9 +477,262 @@ typedef struct
 	/* Actual State of Application */
 	ApplicationState state;
 
+	/* Signaled Events which are not waited yet */
+	uint32_t pendingEvents;
+
+	/* Waited Events while application is blocked */
+	uint32_t waitedEvents;
+
+	/*
+	 * Additional Memory Regions of Application.
+	 *  TCB refers this table and keeps number of valid regions.
+	 */
+	MemoryRegion memoryRegions[OS_MAX_APP_MEMORY_REGIONS];
+
 } Application;
 /*************************** FUNCTION DEFINITIONS *****************************/
 
+/*
+ * Adds a memory region (e.g. a peripheral or buffer window) to region table
+ * of an application. 
+ *
+ * @param app Application to add region
+ * @param startAddress Start address of region (aligned with size)
+ * @param size Size of region (power of two, at least 32 bytes)
+ * @param writable true for read/write access, false for read only access
+ * @param executable true if application can execute code from region
+ *
+ * @return RESULT_SUCCESS if region is added, otherwise RESULT_FAIL.
+ */
+INTERNAL int32_t Kernel_AddMemoryRegion(Application* app, uint32_t startAddress, 
+										uint32_t size, bool writable, bool executable);
+
+/*
+ * Removes a memory region from region table of an application.
+ *
+ * @param app Application to remove region
+ * @param startAddress Start address of region
+ * @param size Size of region
+ *
+ * @return RESULT_SUCCESS if region is removed, RESULT_FAIL if application
+ *         does not have region.
+ */
+INTERNAL int32_t Kernel_RemoveMemoryRegion(Application* app, uint32_t startAddress, uint32_t size);
+
+/*
+ * Checks whether a memory block is in RAM section of an application. Used
+ * to validate buffers which are passed to Kernel by System Calls.
+ *
+ * @param app Application
+ * @param address Start address of block
+ * @param size Size of block
+ *
+ * @return true if whole block is in RAM section of application
+ */
+INTERNAL bool Kernel_IsInApplicationRAM(Application* app, uint32_t address, uint32_t size);
+
+/*
+ * Initializes Peripheral Grants. Peripherals which are used by Kernel (Kernel
+ * Timers and Debug UART) are reserved, others are free to grant.
+ *
+ * @param none
+ *
+ * @return none
+ */
+INTERNAL void Kernel_InitializePeripheralGrants(void);
+
+/*
+ * Grants register block of a peripheral to an application exclusively. 
+ *  Application accesses to peripheral registers directly (without a system 
+ *  call) after grant. Peripheral is powered on and its clock is selected.
+ *
+ * @param app Application to grant peripheral
+ * @param peripheral Peripheral to grant
+ *
+ * @return RESULT_SUCCESS if peripheral is granted (or it is already granted 
+ *         to same application), RESULT_FAIL if peripheral is used by Kernel,
+ *         owned by another application or it cannot be mapped to application.
+ */
+INTERNAL int32_t Kernel_GrantPeripheral(Application* app, Peripheral peripheral);
+
+/*
+ * Releases all peripherals of an application (e.g. when app is terminated).
+ *  Peripheral regions are removed from region table of application, their
+ *  pins are switched back to GPIO and peripherals are powered off.
+ *
+ * @param app Owner Application
+ *
+ * @return none
+ */
+INTERNAL void Kernel_ReleasePeripherals(Application* app);
+
+/*
+ * Configures Function and Drive Mode of a pin for an application.
+ *  GPIO Function is allowed for all applications. An alternate function is
+ *  allowed only if its peripheral is granted to application. A pin which is
+ *  used by a peripheral of Kernel or another application cannot be changed.
+ *
+ * @param app Calling Application
+ * @param port Port Number of pin
+ * @param pin Pin Number of pin
+ * @param function Function of pin
+ * @param mode Drive Mode of pin
+ *
+ * @return RESULT_SUCCESS if pin is configured, otherwise RESULT_FAIL
+ */
+INTERNAL int32_t Kernel_ConfigurePin(Application* app, uint32_t port, uint32_t pin,
+									 uint32_t function, uint32_t mode);
+
+/*
+ * Returns stack usage (High-Water Mark) of an application or Kernel.
+ *  Stacks are painted before they are used so usage is the deepest point 
+ *  which stack reached since system start.
+ *
+ * @param app Application to query or NULL to query Kernel (Main) Stack
+ * @param usage Stack Usage to fill
+ *
+ * @return RESULT_SUCCESS if usage is filled, otherwise RESULT_FAIL.
+ */
+INTERNAL int32_t Kernel_GetStackUsage(Application* app, KernelStackUsage* usage);
+
+/*
+ * Prints stack usages of Kernel and all applications to debug output.
+ *  Output is parsed by build side Stack Report tool 
+ *  (Environment/BuildSystem/StackReport) to size RAM sections of images.
+ *  Called on exceptions and on request of applications (OS_ReportStackUsage).
+ *
+ * @param none
+ *
+ * @return none
+ */
+INTERNAL void Kernel_ReportStackUsage(void);
+
+/*
+ * Prints latency statistics of all recorded interrupts (e.g. Timers and 
+ * PendSV) to debug output. Latencies are in CPU cycles.
+ *  Nothing is printed if DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS is disabled.
+ *
+ * @param none
+ *
+ * @return none
+ */
+INTERNAL void Kernel_ReportIRQLatency(void);
+
+/*
+ * Returns total sleep time of Idle Task since system start.
+ *  CPU Load of a window is 1 - (Idle Time / System Time) of window.
+ *
+ * @param none
+ *
+ * @return Idle Time in System Time (Time Base) ticks
+ */
+INTERNAL uint64_t Kernel_GetIdleTime(void);
+
+/*
+ * Initializes CPU Clock Levels and starts Clock Governor on a Time Base
+ * channel (OS_CLOCK_GOVERNOR_CHANNEL).
+ *
+ * @param timeBase System Time Base
+ *
+ * @return none
+ */
+INTERNAL void Kernel_InitializeClockGovernor(KernelTimerHandle timeBase);
+
+/*
+ * Initializes Deferred Work Queue and its handler (Software Interrupt).
+ *
+ * @param none
+ *
+ * @return none
+ */
+INTERNAL void Kernel_InitializeDeferredWork(void);
+
+/*
+ * Returns an application.
+ *
+ * @param appId Application ID
+ *
+ * @return Application or NULL if appId is invalid
+ */
+INTERNAL Application* Kernel_GetApplication(int32_t appId);
+
+/*
+ * Waits events on behalf of an application (System Call side of 
+ * OS_WaitEvents). Blocks application if none of events is signaled.
+ *
+ * @param app Calling Application
+ * @param eventMask Events to wait
+ *
+ * @return Signaled (and cleared) events or 0 if application is blocked.
+ */
+INTERNAL uint32_t Kernel_WaitEvents(Application* app, uint32_t eventMask);
+
+/*
+ * Attaches a pin to events of an application (System Call side of 
+ * OS_AttachPinEvent).
+ *
+ * @param app Calling Application
+ * @param port Port Number of pin
+ * @param pin Pin Number of pin
+ * @param edges Edges to signal (OS_PIN_EDGE_XXX)
+ * @param events Events to signal, 0 detaches pin
+ *
+ * @return RESULT_SUCCESS or RESULT_FAIL
+ */
+INTERNAL int32_t Kernel_AttachPinEvent(Application* app, uint32_t port, uint32_t pin,
+									   uint32_t edges, uint32_t events);
+
+/*
+ * Detaches all pins of an application (e.g. when app is terminated).
+ *
+ * @param app Owner Application
+ *
+ * @return none
+ */
+INTERNAL void Kernel_ReleasePinEvents(Application* app);
+
+/*
+ * Queues a flash request on behalf of an application (System Call side of 
+ * OS_FlashErase and OS_FlashWrite). Request is validated and copied.
+ *
+ * @param app Calling Application
+ * @param request Request in application RAM
+ * @param operation Erase or Write
+ *
+ * @return RESULT_SUCCESS if request is queued, otherwise RESULT_FAIL
+ */
+INTERNAL int32_t Kernel_QueueFlashRequest(Application* app, OS_FlashRequest* request, uint32_t operation);
+
+/*
+ * Runs a step (a sector erase or a write unit) of queued flash requests and
+ * completes request if it is finished.
+ *  [IMP] Must be called at a scheduling point (PendSV).
+ *
+ * @param none
+ *
+ * @return none
+ */
+INTERNAL void Kernel_RunFlashService(void);
+
+/*
+ * Checks whether there is a queued flash request.
+ *
+ * @param none
+ *
+ * @return true if Flash Service needs a step
+ */
+INTERNAL bool Kernel_HasFlashWork(void);
+
+/*
+ * Cancels queued flash requests of an application (e.g. when app is 
+ * terminated). A step in progress is completed.
+ *
+ * @param app Owner Application
+ *
+ * @return none
+ */
+INTERNAL void Kernel_ReleaseFlashRequests(Application* app);
+
 /********************************* VARIABLES *******************************/
 extern INTERNAL Application* activeApp;
 
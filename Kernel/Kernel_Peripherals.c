@@ -0,0 +1,259 @@
+/*******************************************************************************
+ *
+ * @file Kernel_Peripherals.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Peripheral Grants for User Space Drivers.
+ *
+ *		Kernel can grant register block of a peripheral (e.g. an UART or a
+ *		Timer) to an unprivileged application. Granted block is added to
+ *		memory region table of application so application (a user space
+ *		driver) accesses registers directly without a system call.
+ *
+ *		A peripheral can be owned by only one application at a time.
+ *		Peripherals which are used by Kernel itself (Kernel Timers and Debug
+ *		UART) are never granted. Regions of a released peripheral are
+ *		removed from region table of application so it loses access.
+ *
+ *		Kernel powers on a granted peripheral and powers it off on release.
+ *		Pin Configuration registers are shared by all pins so they are not
+ *		mapped to applications. Applications configure pins by a system call
+ *		and Kernel allows an alternate pin function only for owner of its
+ *		peripheral. Ownership of a pin is not stored, it is derived from
+ *		active function of pin.
+ *
+ * @see https://github.com/ZA-YA/ZAYA-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * GNU GPLv2
+ *
+ * Copyright (c) 2016 ZAYA
+ *
+ *  See GNU GPLv2 License Details in the Root Directory.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+
+#include "Debug.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Owner value for peripherals which are not granted to any application */
+#define PERIPHERAL_OWNER_NONE			(-1)
+/* Owner value for peripherals which are used by Kernel itself */
+#define PERIPHERAL_OWNER_KERNEL			(-2)
+
+/* Peripheral of a HW Timer */
+#define TIMER_PERIPHERAL(timerNo)		((Peripheral)(Peripheral_Timer0 + (timerNo)))
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Owner Application ID of each peripheral.
+ */
+PRIVATE int32_t peripheralOwners[Peripheral_NumOfPeripherals];
+
+/*
+ * Peripherals which are used by Kernel. An application which owns one of 
+ * them could stop Scheduler or corrupt System Time Base.
+ */
+PRIVATE const Peripheral kernelPeripherals[] =
+{
+	TIMER_PERIPHERAL(SYSTEM_TIMER_KERNEL),
+	TIMER_PERIPHERAL(SYSTEM_TIMER_USER),
+	TIMER_PERIPHERAL(SYSTEM_TIMER_TIME_BASE),
+	Peripheral_UART0
+};
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+/*
+ * Checks whether an application can use a function of a pin.
+ *  GPIO Function is shared by all applications. An alternate function is
+ *  usable only by owner of its peripheral.
+ */
+PRIVATE bool IsPinFunctionOwner(Application* app, uint32_t port, uint32_t pin, uint32_t function)
+{
+	int32_t peripheral;
+
+	if (function == DRV_GPIO_FUNCTION_GPIO)
+	{
+		return true;
+	}
+
+	peripheral = Kernel_GetPinPeripheral(port, pin, function);
+
+	/* Functions of peripherals which cannot be granted are Kernel's */
+	return (peripheral != RESULT_FAIL) && (peripheralOwners[peripheral] == app->id);
+}
+
+/*
+ * Switches pins of peripherals of an application back to GPIO
+ */
+PRIVATE void ReleasePins(Application* app)
+{
+	uint32_t port;
+	uint32_t pin;
+	uint32_t function;
+
+	for (port = 0; port < DRV_GPIO_NUM_OF_PORTS; port++)
+	{
+		for (pin = 0; pin < DRV_GPIO_NUM_OF_PINS_PER_PORT; pin++)
+		{
+			function = Kernel_GetPinFunction(port, pin);
+
+			if ((function != DRV_GPIO_FUNCTION_GPIO) &&
+				IsPinFunctionOwner(app, port, pin, function))
+			{
+				/* Reset state of pin : GPIO with Pull-Up */
+				Kernel_SetPinFunction(port, pin, DRV_GPIO_FUNCTION_GPIO, 0);
+			}
+		}
+	}
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Peripheral Grants
+ */
+INTERNAL void Kernel_InitializePeripheralGrants(void)
+{
+	uint32_t peripheral;
+	uint32_t i;
+
+	for (peripheral = 0; peripheral < Peripheral_NumOfPeripherals; peripheral++)
+	{
+		peripheralOwners[peripheral] = PERIPHERAL_OWNER_NONE;
+	}
+
+	for (i = 0; i < sizeof(kernelPeripherals) / sizeof(kernelPeripherals[0]); i++)
+	{
+		peripheralOwners[kernelPeripherals[i]] = PERIPHERAL_OWNER_KERNEL;
+	}
+}
+
+/*
+ * Grants a peripheral to an application
+ */
+INTERNAL int32_t Kernel_GrantPeripheral(Application* app, Peripheral peripheral)
+{
+	MemoryRegion region;
+
+	if ((uint32_t)peripheral >= Peripheral_NumOfPeripherals)
+	{
+		return RESULT_FAIL;
+	}
+
+	if (peripheralOwners[peripheral] == app->id)
+	{
+		/* Already granted, nothing to do */
+		return RESULT_SUCCESS;
+	}
+
+	if (peripheralOwners[peripheral] != PERIPHERAL_OWNER_NONE)
+	{
+		/* Exclusive access. Peripheral is owned by Kernel or another application */
+		DEBUG_PRINT_ERROR("\nPeripheral %d is owned by %d",
+						  peripheral, peripheralOwners[peripheral]);
+
+		return RESULT_FAIL;
+	}
+
+	if (Kernel_GetPeripheralRegion(peripheral, &region) != RESULT_SUCCESS)
+	{
+		return RESULT_FAIL;
+	}
+
+	if (Kernel_AddMemoryRegion(app, region.startAddress, region.size,
+							   region.flags.writable, region.flags.executable) != RESULT_SUCCESS)
+	{
+		/* Region table of application is full */
+		return RESULT_FAIL;
+	}
+
+	Kernel_EnablePeripheral(peripheral);
+
+	peripheralOwners[peripheral] = app->id;
+
+	return RESULT_SUCCESS;
+}
+
+/*
+ * Releases all peripherals of an application
+ */
+INTERNAL void Kernel_ReleasePeripherals(Application* app)
+{
+	uint32_t peripheral;
+	MemoryRegion region;
+
+	/* Pins are found by owners of peripherals so release them first */
+	ReleasePins(app);
+
+	for (peripheral = 0; peripheral < Peripheral_NumOfPeripherals; peripheral++)
+	{
+		if (peripheralOwners[peripheral] == app->id)
+		{
+			/* Region was mapped on grant so it is always available */
+			(void)Kernel_GetPeripheralRegion((Peripheral)peripheral, &region);
+			(void)Kernel_RemoveMemoryRegion(app, region.startAddress, region.size);
+
+			Kernel_DisablePeripheral((Peripheral)peripheral);
+
+			peripheralOwners[peripheral] = PERIPHERAL_OWNER_NONE;
+		}
+	}
+}
+
+/*
+ * Configures Function and Drive Mode of a pin for an application
+ */
+INTERNAL int32_t Kernel_ConfigurePin(Application* app, uint32_t port, uint32_t pin,
+									 uint32_t function, uint32_t mode)
+{
+	if ((port >= DRV_GPIO_NUM_OF_PORTS) || (pin >= DRV_GPIO_NUM_OF_PINS_PER_PORT) ||
+		(function >= DRV_GPIO_NUM_OF_FUNCTIONS) || (mode >= DRV_GPIO_NUM_OF_DRIVE_MODES))
+	{
+		return RESULT_FAIL;
+	}
+
+	/* Pin must not be used by a peripheral of Kernel or another application */
+	if (!IsPinFunctionOwner(app, port, pin, Kernel_GetPinFunction(port, pin)))
+	{
+		DEBUG_PRINT_ERROR("\nPin %d.%d is in use", port, pin);
+
+		return RESULT_FAIL;
+	}
+
+	/* New function must belong to a peripheral of application */
+	if (!IsPinFunctionOwner(app, port, pin, function))
+	{
+		return RESULT_FAIL;
+	}
+
+	Kernel_SetPinFunction(port, pin, function, mode);
+
+	return RESULT_SUCCESS;
+}
+
+LOCATE_AT(int32_t OS_GrantPeripheral(uint32_t peripheral), "0xF700");
+PUBLIC int32_t OS_GrantPeripheral(uint32_t peripheral)
+{
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_GRANT_PERIPHERAL, peripheral, 0, 0);
+}
+
+LOCATE_AT(int32_t OS_ConfigurePin(uint32_t port, uint32_t pin, uint32_t function, uint32_t mode), "0xF900");
+PUBLIC int32_t OS_ConfigurePin(uint32_t port, uint32_t pin, uint32_t function, uint32_t mode)
+{
+	return (int32_t)Kernel_SystemCall(KERNEL_SYSCALL_CONFIGURE_PIN,
+									  KERNEL_SYSCALL_PIN_ARG(port, pin), function, mode);
+}
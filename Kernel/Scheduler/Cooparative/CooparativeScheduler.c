@@ -107,6 +107,24 @@ PUBLIC Application* Scheduler_GetNextApp(void)
     return nextApp;
 }
 
+/*
+ * Checks whether there is a ready application
+ */
+PUBLIC bool Scheduler_HasReadyApp(void)
+{
+	int32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		if (scheduler.taskPool[i].state == AppState_Ready)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /*
  * Terminates current active application
  */
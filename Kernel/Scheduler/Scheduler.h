@@ -48,6 +48,15 @@ void Scheduler_Init(Application* tcbList);
  */
 Application* Scheduler_GetNextApp(void);
 
+/*
+ * Checks whether there is a ready application to run.
+ *
+ * @param none
+ *
+ * @return true if at least one application is ready
+ */
+bool Scheduler_HasReadyApp(void);
+
 /*
  * Terminates current active Application
  *
@@ -44,8 +44,13 @@
 
 /* UART */
 #define BL_FW_UPGRADE_UART_NO					(0)
-/* */
+/* Base Baud Rate. Upgrade starts with this baud rate */
 #define BL_FW_UPGRADE_UART_BAUD_RATE			(115200)
+/*
+ * Max Baud Rate which can be negotiated with host.
+ *  Set to base baud rate to disable negotiation.
+ */
+#define BL_FW_UPGRADE_UART_MAX_BAUD_RATE		(921600)
 
 /* TODO Remove Test Mode */
 #define BL_TEST_MODE							(1)
@@ -49,7 +49,62 @@
 /*
  * Used HW Timer count in that projects.
  */
-#define DRV_CONFIG_NUM_OF_USED_HW_TIMERS				(2)
+#define DRV_CONFIG_NUM_OF_USED_HW_TIMERS				(3)
+
+/*
+ * Enables MPU Stack Guard Regions to detect stack overflows of Kernel and 
+ * User Applications. 
+ */
+#define DRV_CONFIG_ENABLE_STACK_GUARD					(1)
+
+/*
+ * Enables MPU Region Virtualization. Regions of User Applications (and 
+ * GPIO/Peripherals windows) are loaded into MPU on demand. 
+ */
+#define DRV_CONFIG_ENABLE_MPU_REGION_VIRTUALIZATION		(1)
+
+/*
+ * Copies Vector Table into RAM so Kernel and Drivers can install interrupt
+ * handlers at run time.
+ */
+#define DRV_CONFIG_ENABLE_RAM_VECTOR_TABLE				(1)
+
+/*
+ * Number of highest preempt priorities which stay enabled during flash 
+ * programming (IAP). Handlers of these interrupts must be RAM_FUNCTIONs.
+ *  0 disables all interrupts during flash programming.
+ */
+#define DRV_CONFIG_NUM_OF_IAP_ALIVE_PRIORITIES			(0)
+
+/*
+ * Main (Kernel) Stack Size. Must be same with Stack_Size in startup file.
+ */
+#define DRV_CONFIG_MAIN_STACK_SIZE						(0x1000)
+
+/*
+ * Number of preempt priority bits (of 5 NVIC priority bits). Rest are sub 
+ * priority bits. 
+ */
+#define DRV_CONFIG_IRQ_PREEMPT_PRIORITY_BITS			(5)
+
+/*
+ * Preempt Priorities of HW Timers. Low priority must be masked by critical
+ * sections (not higher than MAX_SYSCALL_INTERRUPT_PRIORITY).
+ */
+#define DRV_CONFIG_TIMER_PRIORITY_HIGH					(3)
+#define DRV_CONFIG_TIMER_PRIORITY_NORMAL				(9)
+#define DRV_CONFIG_TIMER_PRIORITY_LOW					(24)
+
+/*
+ * Records latencies of Timer and PendSV interrupts using DWT Cycle Counter.
+ * Enable to measure (see Kernel_ReportIRQLatency). 
+ */
+#define DRV_CONFIG_ENABLE_IRQ_LATENCY_STATS				(0)
+
+/*
+ * HW Timer which is used to multiplex User Timers.
+ */
+#define DRV_CONFIG_USER_TIMER_HW_TIMER_NO				(1)
 
 
 #endif	/* __DRV_CONFIG_H */
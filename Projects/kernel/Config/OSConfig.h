@@ -46,6 +46,15 @@
 
 #define OS_MAX_USER_APP						(2)
 
+/* Stack Size of User Applications (See Stack_Size in User App startup file) */
+#define OS_USER_APP_STACK_SIZE				(0x200)
+
+/* Maximum number of additional memory regions of an User Application */
+#define OS_MAX_APP_MEMORY_REGIONS			(8)
+
+/* CPU Clock follows CPU Load (see Kernel_ClockGovernor.c) */
+#define OS_ENABLE_CLOCK_GOVERNOR			(1)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*************************** FUNCTION DEFINITIONS *****************************/
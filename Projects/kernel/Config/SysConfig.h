@@ -43,6 +43,10 @@
 /***************************** MACRO DEFINITIONS ******************************/
 #define SYSTEM_TIMER_KERNEL					0
 #define SYSTEM_TIMER_USER					1
+#define SYSTEM_TIMER_TIME_BASE				2
+
+/* System Time Base resolution (Hz). 1 MHz gives microsecond timestamps */
+#define SYSTEM_TIME_BASE_FREQUENCY			(1000000)
 
 /* Debug Assertion */
 #define ENABLE_DEBUG_ASSERT					0
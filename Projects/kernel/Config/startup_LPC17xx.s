@@ -52,6 +52,12 @@ __heap_limit
 				IMPORT POS_TIMER1_IRQHandler
 				IMPORT POS_TIMER2_IRQHandler
 				IMPORT POS_TIMER3_IRQHandler
+				IMPORT POS_UART0_IRQHandler
+				IMPORT POS_UART1_IRQHandler
+				IMPORT POS_UART2_IRQHandler
+				IMPORT POS_UART3_IRQHandler
+				IMPORT POS_DMA_IRQHandler
+				IMPORT POS_GPIO_IRQHandler
 
                 PRESERVE8
                 THUMB
@@ -92,10 +98,10 @@ __Vectors       DCD     __initial_sp              ; Top of Stack
 ;                DCD     TIMER2_IRQHandler         ; 19: Timer2
 ;                DCD     TIMER3_IRQHandler         ; 20: Timer3
 
-                DCD     UART0_IRQHandler          ; 21: UART0
-                DCD     UART1_IRQHandler          ; 22: UART1
-                DCD     UART2_IRQHandler          ; 23: UART2
-                DCD     UART3_IRQHandler          ; 24: UART3
+                DCD     POS_UART0_IRQHandler          ; 21: UART0
+                DCD     POS_UART1_IRQHandler          ; 22: UART1
+                DCD     POS_UART2_IRQHandler          ; 23: UART2
+                DCD     POS_UART3_IRQHandler          ; 24: UART3
                 DCD     PWM1_IRQHandler           ; 25: PWM1
                 DCD     I2C0_IRQHandler           ; 26: I2C0
                 DCD     I2C1_IRQHandler           ; 27: I2C1
@@ -108,12 +114,12 @@ __Vectors       DCD     __initial_sp              ; Top of Stack
                 DCD     EINT0_IRQHandler          ; 34: External Interrupt 0
                 DCD     EINT1_IRQHandler          ; 35: External Interrupt 1
                 DCD     EINT2_IRQHandler          ; 36: External Interrupt 2
-                DCD     EINT3_IRQHandler          ; 37: External Interrupt 3
+                DCD     POS_GPIO_IRQHandler           ; 37: External Interrupt 3 (GPIO)
                 DCD     ADC_IRQHandler            ; 38: A/D Converter
                 DCD     BOD_IRQHandler            ; 39: Brown-Out Detect
                 DCD     USB_IRQHandler            ; 40: USB
                 DCD     CAN_IRQHandler            ; 41: CAN
-                DCD     DMA_IRQHandler            ; 42: General Purpose DMA
+                DCD     POS_DMA_IRQHandler            ; 42: General Purpose DMA
                 DCD     I2S_IRQHandler            ; 43: I2S
                 DCD     ENET_IRQHandler           ; 44: Ethernet
                 DCD     RIT_IRQHandler            ; 45: Repetitive Interrupt Timer
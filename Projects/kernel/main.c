@@ -20,6 +20,7 @@
 extern void Board_LedInit(void);
 extern void Board_LedOn(uint32_t ledNo);
 extern void Board_LedOff(uint32_t ledNo);
+extern void Board_LcdInit(void);
 
 /******************************** VARIABLES ***********************************/
 
@@ -90,6 +91,10 @@ PRIVATE ALWAYS_INLINE void InitializeBoard(void)
 #if BOARD_ENABLE_LED_INTERFACE
 	Board_LedInit();
 #endif
+
+#if BOARD_ENABLE_LCD_INTERFACE
+	Board_LcdInit();
+#endif
 }
 /***************************** PUBLIC FUNCTIONS *******************************/
 